@@ -1,6 +1,10 @@
 
 set(NODE_TOOLS "${CMAKE_SOURCE_DIR}/node_modules/script.cmake")
 if(NOT EXISTS ${NODE_TOOLS})
+if(WIN32)
 execute_process(COMMAND cmd /c npm install WORKING_DIRECTORY ${CMAKE_SOURCE_DIR})
+else()
+execute_process(COMMAND npm install WORKING_DIRECTORY ${CMAKE_SOURCE_DIR})
+endif()
 endif()
 include(${NODE_TOOLS}/index.cmake)
@@ -1,6 +1,6 @@
 #pragma once
 #include <ins/memory/map.h>
-#include <ins/memory/schemas.h>
+#include <ins/memory/objects-base.h>
 
 namespace ins::mem {
 
@@ -9,13 +9,15 @@ namespace ins::mem {
    };
 
    struct ObjectAlivenessItem {
-      uint16_t arenaID;
+      uint32_t arenaID;
       std::atomic<uint32_t> next;
       std::atomic_uint64_t uncheckeds;
    };
 
    struct ObjectAnalysisSession {
       uint32_t* arenaIndexesMap = 0;
+      uint32_t arenaIndexesFirst = 0; // Arena ID range set by the last reset
+      uint32_t arenaIndexesLast = 0;
 
       ObjectAlivenessFlags* regionAlivenessMap = 0;
       ObjectAlivenessItem* regionItemsMap = 0;
@@ -25,8 +27,8 @@ namespace ins::mem {
       uint32_t allocated = 0;
       uint32_t length = 0;
 
-      bool MarkAlive(uint16_t arenaID, uint32_t regionIndex, uint64_t objectBit);
-      void Postpone(uint16_t arenaID, uint32_t regionIndex, uint64_t objectBit);
+      bool MarkAlive(uint32_t arenaID, uint32_t regionIndex, uint64_t objectBit);
+      void Postpone(uint32_t arenaID, uint32_t regionIndex, uint64_t objectBit);
       void Reset();
       void RunOnce();
       static void MarkPtr(void* ptr);
@@ -0,0 +1,153 @@
+#pragma once
+namespace ins::mem::cst {
+
+   inline constexpr tObjectLayoutBase ObjectLayoutBase[ObjectLayoutCount] = {
+   {/*object_divider*/2147483648, /*object_multiplier*/16, },
+   {/*object_divider*/1431655766, /*object_multiplier*/24, },
+   {/*object_divider*/1073741824, /*object_multiplier*/32, },
+   {/*object_divider*/858993460, /*object_multiplier*/40, },
+   {/*object_divider*/715827883, /*object_multiplier*/48, },
+   {/*object_divider*/613566757, /*object_multiplier*/56, },
+   {/*object_divider*/536870912, /*object_multiplier*/64, },
+   {/*object_divider*/477218589, /*object_multiplier*/72, },
+   {/*object_divider*/429496730, /*object_multiplier*/80, },
+   {/*object_divider*/390451573, /*object_multiplier*/88, },
+   {/*object_divider*/357913942, /*object_multiplier*/96, },
+   {/*object_divider*/330382100, /*object_multiplier*/104, },
+   {/*object_divider*/306783379, /*object_multiplier*/112, },
+   {/*object_divider*/286331154, /*object_multiplier*/120, },
+   {/*object_divider*/252645136, /*object_multiplier*/136, },
+   {/*object_divider*/226050911, /*object_multiplier*/152, },
+   {/*object_divider*/195225787, /*object_multiplier*/176, },
+   {/*object_divider*/171798692, /*object_multiplier*/200, },
+   {/*object_divider*/153391690, /*object_multiplier*/224, },
+   {/*object_divider*/134217728, /*object_multiplier*/256, },
+   {/*object_divider*/119304648, /*object_multiplier*/288, },
+   {/*object_divider*/107374183, /*object_multiplier*/320, },
+   {/*object_divider*/95443718, /*object_multiplier*/360, },
+   {/*object_divider*/84215046, /*object_multiplier*/408, },
+   {/*object_divider*/74051161, /*object_multiplier*/464, },
+   {/*object_divider*/66076420, /*object_multiplier*/520, },
+   {/*object_divider*/58835169, /*object_multiplier*/584, },
+   {/*object_divider*/51746594, /*object_multiplier*/664, },
+   {/*object_divider*/45210183, /*object_multiplier*/760, },
+   {/*object_divider*/40139882, /*object_multiplier*/856, },
+   {/*object_divider*/35791395, /*object_multiplier*/960, },
+   {/*object_divider*/31580642, /*object_multiplier*/1088, },
+   {/*object_divider*/27356480, /*object_multiplier*/1256, },
+   {/*object_divider*/24265352, /*object_multiplier*/1416, },
+   {/*object_divider*/21582751, /*object_multiplier*/1592, },
+   {/*object_divider*/18920561, /*object_multiplier*/1816, },
+   {/*object_divider*/16843010, /*object_multiplier*/2040, },
+   {/*object_divider*/14708793, /*object_multiplier*/2336, },
+   {/*object_divider*/13134457, /*object_multiplier*/2616, },
+   {/*object_divider*/11545612, /*object_multiplier*/2976, },
+   {/*object_divider*/10250519, /*object_multiplier*/3352, },
+   {/*object_divider*/9196933, /*object_multiplier*/3736, },
+   {/*object_divider*/8134408, /*object_multiplier*/4224, },
+   {/*object_divider*/7087405, /*object_multiplier*/4848, },
+   {/*object_divider*/6297607, /*object_multiplier*/5456, },
+   {/*object_divider*/5643847, /*object_multiplier*/6088, },
+   {/*object_divider*/4988348, /*object_multiplier*/6888, },
+   {/*object_divider*/4459987, /*object_multiplier*/7704, },
+   {/*object_divider*/3936726, /*object_multiplier*/8728, },
+   {/*object_divider*/3540781, /*object_multiplier*/9704, },
+   {/*object_divider*/3148804, /*object_multiplier*/10912, },
+   {/*object_divider*/2820071, /*object_multiplier*/12184, },
+   {/*object_divider*/2491281, /*object_multiplier*/13792, },
+   {/*object_divider*/2228837, /*object_multiplier*/15416, },
+   {/*object_divider*/1966561, /*object_multiplier*/17472, },
+   {/*object_divider*/1704353, /*object_multiplier*/20160, },
+   {/*object_divider*/1507536, /*object_multiplier*/22792, },
+   {/*object_divider*/1343858, /*object_multiplier*/25568, },
+   {/*object_divider*/1179937, /*object_multiplier*/29120, },
+   {/*object_divider*/1049602, /*object_multiplier*/32736, },
+   {/*object_divider*/917729, /*object_multiplier*/37440, },
+   {/*object_divider*/819338, /*object_multiplier*/41936, },
+   {/*object_divider*/720996, /*object_multiplier*/47656, },
+   {/*object_divider*/622640, /*object_multiplier*/55184, },
+   {/*object_divider*/557137, /*object_multiplier*/61672, },
+   {/*object_divider*/491584, /*object_multiplier*/69896, },
+   {/*object_divider*/426046, /*object_multiplier*/80648, },
+   {/*object_divider*/0, /*object_multiplier*/0, },
+   {/*object_divider*/0, /*object_multiplier*/0, },
+   {/*object_divider*/0, /*object_multiplier*/0, },
+   {/*object_divider*/0, /*object_multiplier*/0, },
+   {/*object_divider*/0, /*object_multiplier*/0, },
+   };
+
+   inline constexpr tObjectLayoutInfos ObjectLayoutInfos[ObjectLayoutCount] = {
+   {/*region_objects*/60, /*region_templateID*/0, /*region_sizeL2*/10, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{1024,8192,2048}, },
+   {/*region_objects*/40, /*region_templateID*/0, /*region_sizeL2*/10, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{1024,8192,2048}, },
+   {/*region_objects*/30, /*region_templateID*/0, /*region_sizeL2*/10, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{1024,8192,2048}, },
+   {/*region_objects*/49, /*region_templateID*/1, /*region_sizeL2*/11, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{819,6552,1638}, },
+   {/*region_objects*/41, /*region_templateID*/1, /*region_sizeL2*/11, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{682,5456,1364}, },
+   {/*region_objects*/35, /*region_templateID*/1, /*region_sizeL2*/11, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{585,4680,1170}, },
+   {/*region_objects*/31, /*region_templateID*/1, /*region_sizeL2*/11, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{512,4096,1024}, },
+   {/*region_objects*/27, /*region_templateID*/1, /*region_sizeL2*/11, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{455,3640,910}, },
+   {/*region_objects*/50, /*region_templateID*/2, /*region_sizeL2*/12, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{409,3272,818}, },
+   {/*region_objects*/45, /*region_templateID*/2, /*region_sizeL2*/12, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{372,2976,744}, },
+   {/*region_objects*/42, /*region_templateID*/2, /*region_sizeL2*/12, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{341,2728,682}, },
+   {/*region_objects*/38, /*region_templateID*/2, /*region_sizeL2*/12, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{315,2520,630}, },
+   {/*region_objects*/36, /*region_templateID*/2, /*region_sizeL2*/12, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{292,2336,584}, },
+   {/*region_objects*/33, /*region_templateID*/2, /*region_sizeL2*/12, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{273,2184,546}, },
+   {/*region_objects*/29, /*region_templateID*/2, /*region_sizeL2*/12, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{240,1920,480}, },
+   {/*region_objects*/26, /*region_templateID*/2, /*region_sizeL2*/12, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{215,1720,430}, },
+   {/*region_objects*/46, /*region_templateID*/3, /*region_sizeL2*/13, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{186,1488,372}, },
+   {/*region_objects*/40, /*region_templateID*/3, /*region_sizeL2*/13, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{163,1304,326}, },
+   {/*region_objects*/36, /*region_templateID*/3, /*region_sizeL2*/13, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{146,1168,292}, },
+   {/*region_objects*/31, /*region_templateID*/3, /*region_sizeL2*/13, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{128,1024,256}, },
+   {/*region_objects*/28, /*region_templateID*/3, /*region_sizeL2*/13, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{113,904,226}, },
+   {/*region_objects*/25, /*region_templateID*/3, /*region_sizeL2*/13, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{102,816,204}, },
+   {/*region_objects*/45, /*region_templateID*/4, /*region_sizeL2*/14, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{91,728,182}, },
+   {/*region_objects*/40, /*region_templateID*/4, /*region_sizeL2*/14, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{80,640,160}, },
+   {/*region_objects*/35, /*region_templateID*/4, /*region_sizeL2*/14, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{70,560,140}, },
+   {/*region_objects*/31, /*region_templateID*/4, /*region_sizeL2*/14, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{63,504,126}, },
+   {/*region_objects*/56, /*region_templateID*/5, /*region_sizeL2*/15, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{56,448,112}, },
+   {/*region_objects*/49, /*region_templateID*/5, /*region_sizeL2*/15, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{49,392,98}, },
+   {/*region_objects*/43, /*region_templateID*/5, /*region_sizeL2*/15, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{43,344,86}, },
+   {/*region_objects*/38, /*region_templateID*/5, /*region_sizeL2*/15, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{38,304,76}, },
+   {/*region_objects*/34, /*region_templateID*/5, /*region_sizeL2*/15, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{34,272,68}, },
+   {/*region_objects*/30, /*region_templateID*/5, /*region_sizeL2*/15, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{30,240,60}, },
+   {/*region_objects*/26, /*region_templateID*/5, /*region_sizeL2*/15, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{26,208,52}, },
+   {/*region_objects*/46, /*region_templateID*/6, /*region_sizeL2*/16, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{23,184,46}, },
+   {/*region_objects*/41, /*region_templateID*/6, /*region_sizeL2*/16, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{20,160,40}, },
+   {/*region_objects*/36, /*region_templateID*/6, /*region_sizeL2*/16, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{18,144,36}, },
+   {/*region_objects*/32, /*region_templateID*/6, /*region_sizeL2*/16, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{16,128,32}, },
+   {/*region_objects*/28, /*region_templateID*/6, /*region_sizeL2*/16, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{14,112,28}, },
+   {/*region_objects*/25, /*region_templateID*/6, /*region_sizeL2*/16, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{12,96,24}, },
+   {/*region_objects*/22, /*region_templateID*/6, /*region_sizeL2*/16, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{11,88,22}, },
+   {/*region_objects*/39, /*region_templateID*/7, /*region_sizeL2*/17, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{9,72,18}, },
+   {/*region_objects*/35, /*region_templateID*/7, /*region_sizeL2*/17, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{8,64,16}, },
+   {/*region_objects*/31, /*region_templateID*/7, /*region_sizeL2*/17, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{7,56,14}, },
+   {/*region_objects*/27, /*region_templateID*/7, /*region_sizeL2*/17, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{6,48,12}, },
+   {/*region_objects*/12, /*region_templateID*/6, /*region_sizeL2*/16, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{6,48,12}, },
+   {/*region_objects*/43, /*region_templateID*/8, /*region_sizeL2*/18, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{5,40,10}, },
+   {/*region_objects*/19, /*region_templateID*/7, /*region_sizeL2*/17, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{4,32,8}, },
+   {/*region_objects*/17, /*region_templateID*/7, /*region_sizeL2*/17, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{4,32,8}, },
+   {/*region_objects*/15, /*region_templateID*/7, /*region_sizeL2*/17, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{3,24,6}, },
+   {/*region_objects*/27, /*region_templateID*/8, /*region_sizeL2*/18, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{3,24,6}, },
+   {/*region_objects*/6, /*region_templateID*/6, /*region_sizeL2*/16, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{3,24,6}, },
+   {/*region_objects*/43, /*region_templateID*/9, /*region_sizeL2*/19, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{2,16,4}, },
+   {/*region_objects*/19, /*region_templateID*/8, /*region_sizeL2*/18, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{2,16,4}, },
+   {/*region_objects*/17, /*region_templateID*/8, /*region_sizeL2*/18, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{2,16,4}, },
+   {/*region_objects*/15, /*region_templateID*/8, /*region_sizeL2*/18, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{1,8,2}, },
+   {/*region_objects*/13, /*region_templateID*/8, /*region_sizeL2*/18, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{1,8,2}, },
+   {/*region_objects*/23, /*region_templateID*/9, /*region_sizeL2*/19, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{1,8,2}, },
+   {/*region_objects*/41, /*region_templateID*/10, /*region_sizeL2*/20, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{1,8,2}, },
+   {/*region_objects*/9, /*region_templateID*/8, /*region_sizeL2*/18, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{1,8,2}, },
+   {/*region_objects*/2, /*region_templateID*/6, /*region_sizeL2*/16, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{1,8,2}, },
+   {/*region_objects*/7, /*region_templateID*/8, /*region_sizeL2*/18, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{1,8,2}, },
+   {/*region_objects*/25, /*region_templateID*/10, /*region_sizeL2*/20, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{1,8,2}, },
+   {/*region_objects*/11, /*region_templateID*/9, /*region_sizeL2*/19, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{1,8,2}, },
+   {/*region_objects*/19, /*region_templateID*/10, /*region_sizeL2*/20, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{1,8,2}, },
+   {/*region_objects*/17, /*region_templateID*/10, /*region_sizeL2*/20, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{1,8,2}, },
+   {/*region_objects*/15, /*region_templateID*/10, /*region_sizeL2*/20, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{1,8,2}, },
+   {/*region_objects*/13, /*region_templateID*/10, /*region_sizeL2*/20, /*region_sizing*/0, /*policy*/mem::SmallObjectPolicy, /*retention*/{1,8,2}, },
+   {/*region_objects*/1, /*region_templateID*/7, /*region_sizeL2*/17, /*region_sizing*/0, /*policy*/mem::MediumObjectPolicy, /*retention*/{1,0,0}, },
+   {/*region_objects*/1, /*region_templateID*/8, /*region_sizeL2*/18, /*region_sizing*/0, /*policy*/mem::MediumObjectPolicy, /*retention*/{1,0,0}, },
+   {/*region_objects*/1, /*region_templateID*/9, /*region_sizeL2*/19, /*region_sizing*/0, /*policy*/mem::MediumObjectPolicy, /*retention*/{1,0,0}, },
+   {/*region_objects*/1, /*region_templateID*/10, /*region_sizeL2*/20, /*region_sizing*/0, /*policy*/mem::MediumObjectPolicy, /*retention*/{1,0,0}, },
+   {/*region_objects*/1, /*region_templateID*/11, /*region_sizeL2*/32, /*region_sizing*/0, /*policy*/mem::LargeObjectPolicy, /*retention*/{0,0,0}, },
+   };
+}
@@ -13,7 +13,94 @@ namespace ins::mem::cst {
    const size_t LargeSizeLimit = MediumSizeLimit << 4;
 
    struct tLayoutRangeBin {uint8_t layoutMin = 0, layoutMax = 0;};
-   extern const uint8_t small_object_layouts[LayoutRangeSizeCount + 1];
-   extern const tLayoutRangeBin medium_object_layouts[LayoutRangeSizeCount];
-   extern const tLayoutRangeBin large_object_layouts[LayoutRangeSizeCount];
+
+   inline constexpr uint8_t small_object_layouts[LayoutRangeSizeCount + 1] = {
+   1, 1, 1, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 14, 15, 15, 16, 16, 16, 17, 17, 17, 18, 18, 18, 19, 19, 19, 
+   19, 20, 20, 20, 20, 21, 21, 21, 21, 22, 22, 22, 22, 22, 23, 23, 23, 23, 23, 23, 24, 24, 24, 24, 24, 24, 24, 25, 25, 25, 25, 25, 
+   25, 25, 26, 26, 26, 26, 26, 26, 26, 26, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 
+   29, 29, 29, 29, 29, 29, 29, 29, 29, 29, 29, 29, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 31, 31, 31, 31, 31, 31, 31, 
+   31, 31, 31, 31, 31, 31, 31, 31, 31, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 33, 33, 
+   33, 33, 33, 33, 33, 33, 33, 33, 33, 33, 33, 33, 33, 33, 33, 33, 33, 33, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 
+   34, 34, 34, 34, 34, 34, 34, 34, 35, 35, 35, 35, 35, 35, 35, 35, 35, 35, 35, 35, 35, 35, 35, 35, 35, 35, 35, 35, 35, 35, 35, 35, 
+   35, 35, 35, 35, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 
+   37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 
+   37, 37, 37, 37, 37, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 
+   38, 38, 38, 38, 38, 38, 38, 38, 39, 39, 39, 39, 39, 39, 39, 39, 39, 39, 39, 39, 39, 39, 39, 39, 39, 39, 39, 39, 39, 39, 39, 39, 
+   39, 39, 39, 39, 39, 39, 39, 39, 39, 39, 39, 39, 39, 39, 39, 39, 39, 39, 39, 39, 39, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 
+   40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 
+   40, 40, 40, 40, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 
+   41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 
+   42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 
+   42, 
+   };
+
+   inline constexpr tLayoutRangeBin medium_object_layouts[LayoutRangeSizeCount] = {
+   {0,0}, {0,0}, {0,0}, {0,0}, {0,0}, {0,0}, {0,0}, {0,0}, {0,0}, {0,0}, {0,0}, {0,0}, {0,0}, {0,0}, {0,0}, {0,0}, 
+   {0,0}, {0,0}, {0,0}, {0,0}, {0,0}, {0,0}, {0,0}, {0,0}, {0,0}, {0,0}, {0,0}, {0,0}, {0,0}, {0,42}, {42,42}, {42,42}, 
+   {42,42}, {42,43}, {43,43}, {43,43}, {43,43}, {43,44}, {44,44}, {44,44}, {44,44}, {44,44}, {44,45}, {45,45}, {45,45}, {45,45}, {45,45}, {45,46}, 
+   {46,46}, {46,46}, {46,46}, {46,46}, {46,46}, {46,47}, {47,47}, {47,47}, {47,47}, {47,47}, {47,47}, {47,47}, {47,48}, {48,48}, {48,48}, {48,48}, 
+   {48,48}, {48,48}, {48,48}, {48,48}, {48,49}, {49,49}, {49,49}, {49,49}, {49,49}, {49,49}, {49,49}, {49,50}, {50,50}, {50,50}, {50,50}, {50,50}, 
+   {50,50}, {50,50}, {50,50}, {50,50}, {50,50}, {50,51}, {51,51}, {51,51}, {51,51}, {51,51}, {51,51}, {51,51}, {51,51}, {51,51}, {51,51}, {51,52}, 
+   {52,52}, {52,52}, {52,52}, {52,52}, {52,52}, {52,52}, {52,52}, {52,52}, {52,52}, {52,52}, {52,52}, {52,53}, {53,53}, {53,53}, {53,53}, {53,53}, 
+   {53,53}, {53,53}, {53,53}, {53,53}, {53,53}, {53,53}, {53,53}, {53,53}, {53,54}, {54,54}, {54,54}, {54,54}, {54,54}, {54,54}, {54,54}, {54,54}, 
+   {54,54}, {54,54}, {54,54}, {54,54}, {54,54}, {54,54}, {54,54}, {54,54}, {54,55}, {55,55}, {55,55}, {55,55}, {55,55}, {55,55}, {55,55}, {55,55}, 
+   {55,55}, {55,55}, {55,55}, {55,55}, {55,55}, {55,55}, {55,55}, {55,55}, {55,55}, {55,55}, {55,55}, {55,55}, {55,55}, {55,56}, {56,56}, {56,56}, 
+   {56,56}, {56,56}, {56,56}, {56,56}, {56,56}, {56,56}, {56,56}, {56,56}, {56,56}, {56,56}, {56,56}, {56,56}, {56,56}, {56,56}, {56,56}, {56,56}, 
+   {56,56}, {56,56}, {56,57}, {57,57}, {57,57}, {57,57}, {57,57}, {57,57}, {57,57}, {57,57}, {57,57}, {57,57}, {57,57}, {57,57}, {57,57}, {57,57}, 
+   {57,57}, {57,57}, {57,57}, {57,57}, {57,57}, {57,57}, {57,57}, {57,58}, {58,58}, {58,58}, {58,58}, {58,58}, {58,58}, {58,58}, {58,58}, {58,58}, 
+   {58,58}, {58,58}, {58,58}, {58,58}, {58,58}, {58,58}, {58,58}, {58,58}, {58,58}, {58,58}, {58,58}, {58,58}, {58,58}, {58,58}, {58,58}, {58,58}, 
+   {58,58}, {58,58}, {58,58}, {58,59}, {59,59}, {59,59}, {59,59}, {59,59}, {59,59}, {59,59}, {59,59}, {59,59}, {59,59}, {59,59}, {59,59}, {59,59}, 
+   {59,59}, {59,59}, {59,59}, {59,59}, {59,59}, {59,59}, {59,59}, {59,59}, {59,59}, {59,59}, {59,59}, {59,59}, {59,59}, {59,59}, {59,59}, {59,60}, 
+   {60,60}, {60,60}, {60,60}, {60,60}, {60,60}, {60,60}, {60,60}, {60,60}, {60,60}, {60,60}, {60,60}, {60,60}, {60,60}, {60,60}, {60,60}, {60,60}, 
+   {60,60}, {60,60}, {60,60}, {60,60}, {60,60}, {60,60}, {60,60}, {60,60}, {60,60}, {60,60}, {60,60}, {60,60}, {60,60}, {60,60}, {60,60}, {60,60}, 
+   {60,60}, {60,60}, {60,60}, {60,60}, {60,61}, {61,61}, {61,61}, {61,61}, {61,61}, {61,61}, {61,61}, {61,61}, {61,61}, {61,61}, {61,61}, {61,61}, 
+   {61,61}, {61,61}, {61,61}, {61,61}, {61,61}, {61,61}, {61,61}, {61,61}, {61,61}, {61,61}, {61,61}, {61,61}, {61,61}, {61,61}, {61,61}, {61,61}, 
+   {61,61}, {61,61}, {61,61}, {61,61}, {61,61}, {61,61}, {61,61}, {61,62}, {62,62}, {62,62}, {62,62}, {62,62}, {62,62}, {62,62}, {62,62}, {62,62}, 
+   {62,62}, {62,62}, {62,62}, {62,62}, {62,62}, {62,62}, {62,62}, {62,62}, {62,62}, {62,62}, {62,62}, {62,62}, {62,62}, {62,62}, {62,62}, {62,62}, 
+   {62,62}, {62,62}, {62,62}, {62,62}, {62,62}, {62,62}, {62,62}, {62,62}, {62,62}, {62,62}, {62,62}, {62,62}, {62,62}, {62,62}, {62,62}, {62,62}, 
+   {62,62}, {62,62}, {62,62}, {62,62}, {62,63}, {63,63}, {63,63}, {63,63}, {63,63}, {63,63}, {63,63}, {63,63}, {63,63}, {63,63}, {63,63}, {63,63}, 
+   {63,63}, {63,63}, {63,63}, {63,63}, {63,63}, {63,63}, {63,63}, {63,63}, {63,63}, {63,63}, {63,63}, {63,63}, {63,63}, {63,63}, {63,63}, {63,63}, 
+   {63,63}, {63,63}, {63,63}, {63,63}, {63,63}, {63,63}, {63,63}, {63,63}, {63,63}, {63,63}, {63,63}, {63,63}, {63,63}, {63,63}, {63,63}, {63,63}, 
+   {63,63}, {63,63}, {63,63}, {63,63}, {63,63}, {63,63}, {63,63}, {63,63}, {63,63}, {63,63}, {63,63}, {63,63}, {63,63}, {63,63}, {63,63}, {63,64}, 
+   {64,64}, {64,64}, {64,64}, {64,64}, {64,64}, {64,64}, {64,64}, {64,64}, {64,64}, {64,64}, {64,64}, {64,64}, {64,64}, {64,64}, {64,64}, {64,64}, 
+   {64,64}, {64,64}, {64,64}, {64,64}, {64,64}, {64,64}, {64,64}, {64,64}, {64,64}, {64,64}, {64,64}, {64,64}, {64,64}, {64,64}, {64,64}, {64,64}, 
+   {64,64}, {64,64}, {64,64}, {64,64}, {64,64}, {64,64}, {64,64}, {64,64}, {64,64}, {64,64}, {64,64}, {64,64}, {64,64}, {64,64}, {64,64}, {64,64}, 
+   {64,64}, {64,65}, {65,65}, {65,65}, {65,65}, {65,65}, {65,65}, {65,65}, {65,65}, {65,65}, {65,65}, {65,65}, {65,65}, {65,65}, {65,65}, {65,65}, 
+   {65,65}, {65,65}, {65,65}, {65,65}, {65,65}, {65,65}, {65,65}, {65,65}, {65,65}, {65,65}, {65,65}, {65,65}, {65,65}, {65,65}, {65,65}, {65,65}, 
+   };
+
+   inline constexpr tLayoutRangeBin large_object_layouts[LayoutRangeSizeCount] = {
+   {0,0}, {0,0}, {0,0}, {0,0}, {0,0}, {0,0}, {0,0}, {0,0}, {0,0}, {0,0}, {0,0}, {0,0}, {0,0}, {0,0}, {0,0}, {0,0}, 
+   {0,0}, {0,0}, {0,0}, {0,0}, {0,0}, {0,0}, {0,0}, {0,0}, {0,0}, {0,0}, {0,0}, {0,0}, {0,0}, {0,0}, {0,65}, {65,65}, 
+   {65,65}, {65,65}, {65,66}, {66,66}, {66,66}, {66,66}, {66,66}, {66,67}, {67,67}, {67,67}, {67,67}, {67,67}, {67,67}, {67,67}, {67,67}, {67,67}, 
+   {67,67}, {67,67}, {67,67}, {67,67}, {67,67}, {67,67}, {67,67}, {67,67}, {67,67}, {67,67}, {67,67}, {67,67}, {67,67}, {67,67}, {67,67}, {67,68}, 
+   {68,68}, {68,68}, {68,68}, {68,68}, {68,68}, {68,68}, {68,68}, {68,68}, {68,68}, {68,68}, {68,68}, {68,68}, {68,68}, {68,68}, {68,68}, {68,68}, 
+   {68,68}, {68,68}, {68,68}, {68,68}, {68,68}, {68,68}, {68,68}, {68,68}, {68,68}, {68,68}, {68,68}, {68,68}, {68,68}, {68,68}, {68,68}, {68,68}, 
+   {68,68}, {68,68}, {68,68}, {68,68}, {68,68}, {68,68}, {68,68}, {68,68}, {68,68}, {68,68}, {68,68}, {68,68}, {68,68}, {68,68}, {68,68}, {68,68}, 
+   {68,68}, {68,68}, {68,68}, {68,68}, {68,68}, {68,68}, {68,68}, {68,68}, {68,68}, {68,68}, {68,68}, {68,68}, {68,68}, {68,68}, {68,68}, {68,69}, 
+   {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, 
+   {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, 
+   {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, 
+   {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, 
+   {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, 
+   {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, 
+   {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, 
+   {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,69}, {69,70}, 
+   {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, 
+   {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, 
+   {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, 
+   {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, 
+   {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, 
+   {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, 
+   {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, 
+   {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, 
+   {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, 
+   {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, 
+   {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, 
+   {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, 
+   {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, 
+   {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, 
+   {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, 
+   {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,70}, {70,71}, 
+   };
 }
@@ -7,6 +7,11 @@
 
 namespace ins::mem {
 
+   struct PersistentHeap;
+   struct SharedHeap;
+   struct HeapDescriptor;
+   struct MemoryCentralContext;
+
    struct MemoryContext : IMemoryConsumer {
       ObjectAllocOptions options;
 
@@ -16,6 +21,10 @@ namespace ins::mem {
       ins::os::Thread thread;
       uint8_t allocated : 1;
       uint8_t isShared : 1;
+      uint8_t numaNode = 0; // Home node of the context regions
+      PersistentHeap* persistent = 0; // Heap providing the context regions (0 for process regions)
+      SharedHeap* shared = 0; // Shared heap providing the context regions (context stored in the shared memory)
+      MemoryCentralContext* central = 0; // Central context of the context heap
 
       ObjectLocalContext unmanaged;
       ObjectLocalContext managed;
@@ -28,12 +37,15 @@ namespace ins::mem {
 
       void* AllocateUnmanaged(ObjectSchemaID schema_id, size_t size);
       void* AllocateManaged(ObjectSchemaID schema_id, size_t size);
+      void* AllocateInLayout(bool managed, ObjectSchemaID schema_id, uint8_t layoutID); // Not instrumented
+      void AllocateUnmanagedObjects(size_t size, size_t count, void** ptrs);
 
       void** NewHardReference(void* ptr);
       void** NewWeakReference(void* ptr);
 
       void PerformCleanup();
       void CheckValidity();
+      void SetHomeNode(uint8_t numaNode);
 
    protected:
       void Scavenge();
@@ -57,6 +69,14 @@ namespace ins::mem {
          std::lock_guard<std::mutex> guard(this->shared->owning);
          return this->shared->AllocateManaged(schema_id, size);
       }
+      void* AllocateInLayout(bool managed, ObjectSchemaID schema_id, uint8_t layoutID) {
+         std::lock_guard<std::mutex> guard(this->shared->owning);
+         return this->shared->AllocateInLayout(managed, schema_id, layoutID);
+      }
+      void AllocateUnmanagedObjects(size_t size, size_t count, void** ptrs) {
+         std::lock_guard<std::mutex> guard(this->shared->owning);
+         return this->shared->AllocateUnmanagedObjects(size, count, ptrs);
+      }
       void** NewHardReference(void* ptr) {
          std::lock_guard<std::mutex> guard(this->shared->owning);
          return this->shared->NewHardReference(ptr);
@@ -71,6 +91,8 @@ namespace ins::mem {
       ObjectCentralContext unmanaged;
       ObjectCentralContext managed;
       ObjectAllocOptions options;
+      HeapDescriptor* heap = 0; // Heap owning the central context
+      RegionPools* pools = 0; // Region pools of the heap (0 for the process pools)
 
       void Initialize();
       void CheckValidity();
@@ -82,11 +104,17 @@ namespace ins::mem {
    };
 
    // Context API
-   extern _declspec(thread) MemoryContext* CurrentContext;
-   extern MemorySharedContext* DefaultContext;
+   extern _INS_TLS MemoryContext* CurrentContext;
+   extern std::atomic<MemorySharedContext*> DefaultContext; // Published last by InitializeHeap (release)
    extern MemoryCentralContext* Central;
    extern MemoryContext* GetThreadContext();
    extern MemoryContext* SetThreadContext(MemoryContext* context);
+   extern MemorySharedContext* AcquireDefaultContext(); // Initialize the heap on its first use
+
+   inline MemorySharedContext* GetDefaultContext() {
+      if (auto context = DefaultContext.load(std::memory_order_acquire)) return context;
+      return AcquireDefaultContext();
+   }
 
    // Object allocation API
    extern void* AllocateObject(size_t size);
@@ -94,12 +122,47 @@ namespace ins::mem {
    extern void* AllocateManagedObject(ObjectSchemaID schemaID, size_t size);
    extern void* AllocateUnmanagedObject(ObjectSchemaID schemaID);
    extern void* AllocateManagedObject(ObjectSchemaID schemaID);
+   extern void* AllocateLayoutObject(bool managed, ObjectSchemaID schemaID, uint8_t layoutID);
 
    // Object retention API
    extern void RetainObject(void* ptr);
    extern bool ReleaseObject(void* ptr);
    extern bool FreeObject(void* ptr);
 
+   // Batch allocation API: objects of a same size claimed by whole regions, and freed
+   // with one release by region (consecutive pointers of a same region are grouped)
+   extern void AllocateObjects(size_t size, size_t count, void** ptrs);
+   extern size_t FreeObjects(void** ptrs, size_t count); // Returns the count of freed objects
+
+   // Compile time size allocation API: the size class is resolved at compile time, and
+   // the objects are never instrumented (an object shall be freed with the same size)
+   template<size_t size>
+   _INS_FORCEINLINE void* AllocateObject() {
+      constexpr uint8_t layoutID = getLayoutForSize(size + sizeof(sObjectHeader));
+      static_assert(layoutID < cst::ObjectLayoutMax, "size is beyond the object layouts");
+      if (auto context = mem::CurrentContext) {
+         if (auto obj = context->unmanaged.TryAcquireObject(layoutID)) {
+            obj->schema_id = 0;
+            return &obj[1];
+         }
+      }
+      return AllocateLayoutObject(false, 0, layoutID);
+   }
+
+   template<size_t size>
+   _INS_FORCEINLINE bool FreeObject(void* ptr) {
+      constexpr uint8_t layoutID = getLayoutForSize(size + sizeof(sObjectHeader));
+      static_assert(layoutID < cst::ObjectLayoutMax, "size is beyond the object layouts");
+      return FreeLayoutObject<false, layoutID>(ptr);
+   }
+
+   template<bool managed, uint8_t layoutID>
+   _INS_FORCEINLINE bool FreeLayoutObject(void* ptr) {
+      ObjectLocation location(ptr, managed, layoutID);
+      _ASSERT(location.HasLayout());
+      return location.Free(mem::CurrentContext);
+   }
+
    // Weak object retention API
    extern void RetainObjectWeak(void* ptr);
    extern bool ReleaseObjectWeak(void* ptr);
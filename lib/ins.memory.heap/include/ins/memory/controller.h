@@ -2,6 +2,7 @@
 #include <ins/memory/map.h>
 #include <ins/memory/contexts.h>
 #include <ins/memory/analysis.h>
+#include <condition_variable>
 
 namespace ins::mem {
 
@@ -23,11 +24,26 @@ namespace ins::mem {
       FreeOutOfBoundObject,
       FreeInexistingObject,
       FreeRetainedObject,
+      PersistentSchemasOverflow, // Schemas beyond the storable count are not saved (addr is the heap base)
+      PersistentSchemaTruncated, // Schema name too long, it will not rebind on reopen (addr is the heap base)
+      PersistentArenaCorrupted, // Stored arena not at its slot, the heap is not opened (addr is the arena)
+      SharedHeapInvalid, // Shared file is not a heap mapped at the expected base, it is not opened (addr is the base)
    };
 
    extern void InitializeHeap();
 
-   // Memory allocation context API
+   // Heap instances API (isolated heaps with their own central context, arenas, physical limit and worker)
+   //--------------------------------------------------
+   extern HeapDescriptor* CreateHeap(size_t maxPhysicalBytes = 0); // 0 for no limit beyond the process one
+   extern void DeleteHeap(HeapDescriptor* heap); // Releases the heap arenas, its contexts and objects shall not be used anymore
+   extern size_t GetHeapUsedBytes(HeapDescriptor* heap);
+   extern MemoryContext* AcquireContext(HeapDescriptor* heap, bool isShared = false);
+   extern void PerformHeapCleanup(HeapDescriptor* heap);
+   extern void MarkAndSweepUnusedObjects(HeapDescriptor* heap);
+   extern void RegisterReferenceTracker(HeapDescriptor* heap, ObjectReferenceTracker tracker);
+   extern void UnregisterReferenceTracker(HeapDescriptor* heap, ObjectReferenceTracker tracker);
+
+   // Memory allocation context API (process heap)
    //--------------------------------------------------
    extern MemoryContext* AcquireContext(bool isShared);
    extern MemoryCentralContext& AcquireCentralContext();
@@ -45,6 +61,8 @@ namespace ins::mem {
    extern void MarkAndSweepUnusedObjects();
    extern void RescueStarvedConsumer(StarvedConsumerToken& token);
    extern void ScheduleContextRecovery(MemoryContext* context);
+   extern void NotifyHeapWorker(); // Wake up the heap worker (to apply new maintenance periods)
+   extern void StartHeapWorker(HeapDescriptor* heap); // Start the heap worker, when the heap has some memory to recover
    extern void NotifyHeapIssue(tHeapIssue issue, address_t addr);
 
    extern void RegisterReferenceTracker(ObjectReferenceTracker tracker);
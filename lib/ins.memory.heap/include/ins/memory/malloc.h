@@ -1,6 +1,7 @@
 #pragma once
 #include <ins/memory/objects-base.h>
 #include <ins/memory/schemas.h>
+#include <ins/memory/contexts.h>
 
 struct ins_memory_stats_t {
    size_t allocated_object_count = 0;
@@ -19,4 +20,24 @@ extern"C" void* ins_calloc(size_t count, size_t size);
 extern"C" void* ins_realloc(void* ptr, size_t size, tp_ins_realloc default_realloc = 0);
 extern"C" size_t ins_msize(void* ptr, tp_ins_msize default_msize = 0);
 extern"C" void ins_free(void* ptr);
+extern"C" void ins_free_sized(void* ptr, size_t size); // size: the size requested at allocation (region head checked, a mismatch falls back on a map lookup)
 
+
+// Inlined malloc: takes the lowest available object of the current region of the size class,
+// falls back on the out of line allocation for no thread context, instrumented context, not small
+// size, or when the current region is empty or shall commit pages
+_INS_FORCEINLINE void* ins_malloc_inline(size_t size) {
+   using namespace ins;
+   using namespace ins::mem;
+   const size_t size_step = cst::SmallSizeLimit / cst::LayoutRangeSizeCount;
+   auto context = mem::CurrentContext;
+   auto required = size + sizeof(sObjectHeader);
+   if (context && required < cst::SmallSizeLimit && !context->options.enableds) {
+      auto layoutID = cst::small_object_layouts[(required + 7) / size_step];
+      if (auto obj = context->unmanaged.TryAcquireObject(layoutID)) {
+         obj->schema_id = 0;
+         return &obj[1];
+      }
+   }
+   return mem::AllocateObject(size);
+}
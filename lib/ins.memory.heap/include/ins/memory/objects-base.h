@@ -13,6 +13,7 @@ namespace ins::mem {
    typedef struct sObjectSchema* ObjectSchema;
    typedef uint8_t* ObjectBytes;
    struct ObjectLocalContext;
+   struct MemoryCentralContext;
    struct MemoryContext;
 
    enum ObjectLayoutPolicy {
@@ -32,10 +33,10 @@ namespace ins::mem {
       static constexpr uint8_t DividerShift = 35;
       uint32_t object_divider;
       uint32_t object_multiplier;
-      uintptr_t GetObjectIndex(uintptr_t offset) const {
+      constexpr uintptr_t GetObjectIndex(uintptr_t offset) const {
          return (uint64_t(offset - cst::ObjectRegionHeadSize) * object_divider) >> DividerShift;
       }
-      uintptr_t GetObjectOffset(uintptr_t index) const {
+      constexpr uintptr_t GetObjectOffset(uintptr_t index) const {
          return cst::ObjectRegionHeadSize + index * object_multiplier;
       }
    };
@@ -60,11 +61,14 @@ namespace ins::mem {
 
    namespace cst {
       extern const size_t ObjectLayoutCount;
-      extern const tObjectLayoutInfos ObjectLayoutInfos[];
-      extern const tObjectLayoutBase ObjectLayoutBase[];
       extern const uint64_t ObjectLayoutMask[];
       extern const tObjectRegionTemplate ObjectRegionTemplate[];
    }
+}
+
+#include <ins/memory/config-layouts.h>
+
+namespace ins::mem {
 
    /**********************************************************************
    *
@@ -117,8 +121,10 @@ namespace ins::mem {
    struct sObjectRegion {
       uint8_t layoutID = 0; // Region layout class
       uint8_t notified_finalizers = 0; // Notified: object with pending finalize shall be check in gc state
+      uint16_t active_pages = 0; // Active zone: committed pages from region start (0 when region is not paged)
       uint32_t width = 0; // Region size based on arena granularity metric
-      ObjectLocalContext* owner = 0; // Region owner
+      std::atomic<ObjectLocalContext*> owner = 0; // Region owner (0 when central owns it), read by the remote frees
+      MemoryCentralContext* central = 0; // Central context of the region heap (receives the region without owner)
 
       // Availability bitmap
       uint64_t availables = 0; // Availability bits of free objects
@@ -130,7 +136,13 @@ namespace ins::mem {
          sObjectRegion* notified = none<sObjectRegion>();
       } next;
 
+      uint8_t idle_passes = 0; // Cold tracking: count of demotion passes seeing the region full and unwritten
+      std::atomic_bool cold = false; // Region pages moved to the cold storage (see mem::DemoteRegion)
+      uint32_t idle_digest = 0; // Cold tracking: objects content digest, when page writes cannot be sampled
+
       void NotifyAvailables(bool managed);
+      void Promote(); // Move back the pages of a cold region
+      void ReleaseObjects(uint64_t objects_bits, bool managed, MemoryContext* context); // Give back freed objects to the region owner
 
       void DisplayToConsole();
       void Dispose();
@@ -179,12 +191,25 @@ namespace ins::mem {
          return size_t(this->width) << mem::cst::RegionSizingInfos[regionID].granularityL2;
       }
 
+      size_t GetActiveSize() {
+         return size_t(this->active_pages) << mem::cst::PageSizeL2;
+      }
+
+      // Active zone management: grow when an object is acquired beyond the zone,
+      // shrink when the used objects fit in a quarter of the zone
+      void GrowActiveZone(size_t requiredSize);
+      void ShrinkActiveZone();
+
+      void UpdateActiveZone() {
+         if (this->active_pages > 1) this->ShrinkActiveZone();
+      }
+
       ObjectHeader GetObjectAt(int index) {
          auto offset = cst::ObjectLayoutBase[this->layoutID].GetObjectOffset(index);
          return ObjectHeader(ObjectBytes(this) + offset);
       }
 
-      __forceinline ObjectHeader AcquireObject() {
+      _INS_FORCEINLINE ObjectHeader AcquireObject() {
          if (this->availables) {
 
             // Get an object index
@@ -193,6 +218,9 @@ namespace ins::mem {
             // Prepare new object
             auto offset = cst::ObjectRegionHeadSize + index * cst::ObjectLayoutBase[this->layoutID].object_multiplier;
             auto obj = ObjectHeader(&ObjectBytes(this)[offset]);
+            if (this->active_pages && offset + cst::ObjectLayoutBase[this->layoutID].object_multiplier > this->GetActiveSize()) {
+               this->GrowActiveZone(offset + cst::ObjectLayoutBase[this->layoutID].object_multiplier);
+            }
 
             // Publish object as ready
             auto bit = uint64_t(1) << index;
@@ -240,9 +268,47 @@ namespace ins::mem {
    };
    static_assert(sizeof(ObjectAnalyticsInfos) == sizeof(uint64_t) * 2, "bad size");
 
+   /**********************************************************************
+   *
+   *   Object Page Map
+   *   (flat map of the object region pages, indexed by address >> PageSizeL2)
+   *
+   ***********************************************************************/
+   // A page entry holds the layout of the object regions covering the page, so a pointer is
+   // classified with one load in a dense map (instead of arena map and arena descriptor loads).
+   // Regions smaller than a page share their page: the page entry is valid while its regions have
+   // the same layout, else it is mixed and pointers are classified with the arena map.
+   // Pages of large objects and persistent heaps are not mapped.
+   // Disabled by default: arena map and layout tables stay in cache for usual heaps, and
+   // classify as fast as the page map (see test_page_map).
+#ifndef _INS_OBJECT_PAGE_MAP
+#define _INS_OBJECT_PAGE_MAP 0
+#endif
+   union ObjectPageEntry {
+      uint32_t bits;
+      struct {
+         uint32_t layoutID : 8;
+         uint32_t region_sizeL2 : 6; // Region size (region base = address & ~(region size - 1))
+         uint32_t region_objects : 8;
+         uint32_t managed : 1;
+         uint32_t mixed : 1; // Page shared by regions of distinct layouts
+         uint32_t regions : 8; // Count of object regions in the page (0 when the page is not mapped)
+      };
+      ObjectPageEntry(uint32_t bits = 0) : bits(bits) {}
+      bool IsMapped() {
+         return this->regions && !this->mixed;
+      }
+   };
+   static_assert(sizeof(ObjectPageEntry) == sizeof(uint32_t), "bad size");
+
+   // Page map, readable for the whole space (0 when the system cannot provide sparse memory)
+   extern std::atomic_uint32_t* ObjectPageMap;
+   extern void InitializeObjectPageMap();
+   extern void UnmapObjectArena(ArenaDescriptor* arena); // Clear the entries of a released arena
+
    struct ObjectLocation {
    public:
-      ArenaEntry arena;
+      bool managed;
       ObjectHeader object;
       ObjectRegion region;
       RegionLayoutID layout;
@@ -259,11 +325,60 @@ namespace ins::mem {
       bool Free(MemoryContext* context);
 
       ObjectLocation(address_t address) {
-         this->arena = mem::ArenaMap[address.arenaID];
-         this->layout = this->arena.layout(address.position >> this->arena.segmentation);
+#if _INS_OBJECT_PAGE_MAP
+         if (this->LocateInPage(address)) return;
+#endif
+         this->LocateInArena(address);
+      }
+
+      // Locate in a region of a known layout (no map lookup, folded for a compile time layout)
+      _INS_FORCEINLINE ObjectLocation(address_t address, bool managed, uint8_t layoutID) {
+         auto& infos = mem::cst::ObjectLayoutBase[layoutID];
+         auto offset = address.ptr & ((uintptr_t(1) << mem::cst::ObjectLayoutInfos[layoutID].region_sizeL2) - 1);
+         this->managed = managed;
+         this->layout = layoutID;
+         this->region = ObjectRegion(address.ptr - offset);
+         this->index = infos.GetObjectIndex(offset);
+         this->object = ObjectHeader(uintptr_t(this->region) + infos.GetObjectOffset(this->index));
+      }
+
+      // Check the region head matches the assumed layout (see the known layout constructor)
+      _INS_FORCEINLINE bool HasLayout() {
+         return this->region->layoutID == this->layout && this->index < mem::cst::ObjectLayoutInfos[this->layout].region_objects;
+      }
+
+      // Locate with the page map (fails when the page is not mapped)
+      _INS_FORCEINLINE bool LocateInPage(address_t address) {
+         if (auto map = mem::ObjectPageMap) {
+            ObjectPageEntry page = map[address.ptr >> cst::PageSizeL2].load(std::memory_order_relaxed);
+            if (page.IsMapped()) {
+               auto& infos = mem::cst::ObjectLayoutBase[page.layoutID];
+               auto offset = address.ptr & ((uintptr_t(1) << page.region_sizeL2) - 1);
+               auto index = infos.GetObjectIndex(offset);
+               this->managed = page.managed;
+               this->layout = uint8_t(page.layoutID);
+               this->region = ObjectRegion(address.ptr - offset);
+               this->index = index;
+               if (index < page.region_objects) {
+                  this->object = ObjectHeader(uintptr_t(this->region) + infos.GetObjectOffset(index));
+               }
+               else {
+                  this->object = 0;
+               }
+               return true;
+            }
+         }
+         return false;
+      }
+
+      // Locate with the arena map
+      void LocateInArena(address_t address) {
+         auto arena = mem::ArenaMap[address.arenaID];
+         this->managed = arena.managed;
+         this->layout = arena.layout(uintptr_t(address.position) >> arena.segmentation);
          if (this->layout.IsObjectRegion()) {
             auto& infos = mem::cst::ObjectLayoutBase[this->layout];
-            auto offset = address.position & mem::cst::RegionMasks[this->arena.segmentation];
+            auto offset = address.position & mem::cst::RegionMasks[arena.segmentation];
             this->region = ObjectRegion(address.ptr - offset);
             this->index = infos.GetObjectIndex(offset);
             if (this->index < cst::ObjectLayoutInfos[this->layout].region_objects) {
@@ -348,7 +463,7 @@ namespace ins::mem {
    *
    ***********************************************************************/
 
-   inline uint8_t getLayoutForSize(size_t size) {
+   inline constexpr uint8_t getLayoutForSize(size_t size) {
       if (size < cst::SmallSizeLimit) {
          const size_t size_step = cst::SmallSizeLimit / cst::LayoutRangeSizeCount;
          auto index = (size + 7) / size_step;
@@ -69,7 +69,7 @@ namespace ins::mem {
       void DumpInto(ObjectRegionList& receiver, ObjectLocalContext* owner) {
          if (this->current) {
             for (ObjectRegion region = this->current; region; region = region->next.used) {
-               region->owner = owner;
+               region->owner.store(owner, std::memory_order_release);
             }
             if (receiver.last) {
                receiver.last->next.used = this->current;
@@ -97,22 +97,25 @@ namespace ins::mem {
    };
 
    // Object Notified Region List
+   // (region and count packed in a word: regions are aligned on 1KB at least, the count is in the low bits)
    struct ObjectRegionNotifieds {
-      std::atomic<uint64_t> list;
+      static const uint64_t CountMask = 0x3ff;
+      std::atomic<uint64_t> list = 0;
       uint64_t Push(ObjectRegion region) {
          _INS_TRACE(printf("PushNotifiedRegion\n"));
          _ASSERT(region->next.notified == none<sObjectRegion>());
+         _ASSERT((uint64_t(region) & CountMask) == 0);
          for (;;) {
             uint64_t current = this->list.load(std::memory_order_relaxed);
-            uint64_t count = current & 0xffff;
+            uint64_t count = current & CountMask;
             if (count < 1000) {
                count++;
             }
             else {
                //printf("Notified overflow\n");
             }
-            uint64_t next = count | (uint64_t(region) << 16);
-            region->next.notified = ObjectRegion(current >> 16);
+            uint64_t next = count | uint64_t(region);
+            region->next.notified = ObjectRegion(current & ~CountMask);
             if (this->list.compare_exchange_weak(
                current, next,
                std::memory_order_release,
@@ -124,11 +127,11 @@ namespace ins::mem {
       }
       ObjectRegion Flush() {
          uint64_t current = this->list.exchange(0);
-         return ObjectRegion(current >> 16);
+         return ObjectRegion(current & ~CountMask);
       }
       size_t Count() {
          uint64_t current = this->list.load(std::memory_order_relaxed);
-         return current & 0xffff;
+         return current & CountMask;
       }
    };
 
@@ -153,7 +156,7 @@ namespace ins::mem {
       };
 
       bool managed = false;
-      std::uint64_t objects_notifieds_warnings;
+      std::uint64_t objects_notifieds_warnings = 0;
       CentralObjects objects[cst::ObjectLayoutCount];
 
       void Initialize(bool managed);
@@ -190,17 +193,36 @@ namespace ins::mem {
 
       void Initialize(MemoryContext* context, ObjectCentralContext* central);
       void Scavenge();
+      void ScavengeNotifieds(); // Collect notified regions, without dump to central
 
       ObjectHeader AllocateObject(size_t size);
       ObjectHeader AllocateLargeObject(size_t size);
       ObjectHeader AllocateInstrumentedObject(size_t size, ObjectAllocOptions options);
+      ObjectHeader AcquireObject(uint8_t layoutID);
+      void AcquireObjects(uint8_t layoutID, size_t count, ObjectHeader* objects);
+
+      // Inlined acquire: takes the lowest available object of the current region,
+      // returns 0 when there is no current region or when it shall commit pages
+      _INS_FORCEINLINE ObjectHeader TryAcquireObject(uint8_t layoutID) {
+         auto& pool = this->objects[layoutID];
+         if (auto region = pool.usables.current) {
+            auto& layout = cst::ObjectLayoutBase[layoutID];
+            auto index = bit::lsb_64(region->availables);
+            auto offset = layout.GetObjectOffset(index);
+            if (!region->active_pages || offset + layout.object_multiplier <= region->GetActiveSize()) {
+               if ((region->availables ^= uint64_t(1) << index) == 0) {
+                  pool.usables.Pop();
+               }
+               return ObjectHeader(&ObjectBytes(region)[offset]);
+            }
+         }
+         return 0;
+      }
 
       void PushDisposableRegion(uint8_t layoutID, ObjectRegion region);
       void PushUsableRegion(ObjectRegion region);
 
    protected:
-      ObjectHeader AcquireObject(uint8_t layoutID);
-
       ObjectRegion PullUsableRegion(uint8_t layoutID);
 
       uint32_t ScavengeNotifiedRegions(uint8_t layoutID);
@@ -0,0 +1,99 @@
+#pragma once
+#include <ins/memory/file-view.h>
+#include <ins/memory/contexts.h>
+
+namespace ins::mem {
+
+   /**********************************************************************
+   *
+   *   Persistent Heap
+   *   (object heap stored in a file mapped at a fixed address)
+   *
+   ***********************************************************************/
+   // The file is the memory image of the heap: arena descriptors, region headers
+   // and objects are reused in place when the file is mapped again at its base.
+   // Reopening only rebinds the region owners and the object schemas (by name).
+   //
+   // File layout:
+   // - arena 0: heap header, then the arena descriptors of the heap
+   // - arena 1..n: object regions, one arena per region class (managed, sizeL2)
+   //
+   // The heap context is stored in arena 0, so region owners stay valid between opens. On close, the
+   // context pools are saved in the header: reopening a cleanly closed heap does not visit the regions.
+   //
+   // Objects are allocated through the heap context (GetContext), used by one thread at a time
+   // (see ThreadMemoryContext). Large objects (beyond object layouts) are not supported.
+   struct PersistentHeap : Descriptor {
+      static const uint64_t cMagic = 0x3150414548534e49; // "INSHEAP1"
+      static const uint32_t cVersion = 5;
+      static const size_t cMaxArenas = 64;
+      static const size_t cMaxRoots = 16;
+      static const size_t cMaxSchemas = 1024;
+      static const size_t cSchemaNameSize = 128;
+      static const size_t cMaxLayouts = 128;
+      static const uintptr_t cDefaultBase = uintptr_t(0x5000) << cst::ArenaSizeL2;
+
+   protected:
+      struct sArenaSlot {
+         ArenaDescriptor* descriptor = 0; // Descriptor stored in arena 0 (0 when the slot is unused)
+         uint8_t sizeL2 = 0;
+         bool managed = false;
+      };
+      struct sPoolLists {
+         ObjectRegionList usables;
+         ObjectRegionList disposables;
+      };
+      struct sHeader {
+         uint64_t magic;
+         uint32_t version;
+         uint32_t arenas_count;
+         uintptr_t base;
+         size_t meta_cursor; // Allocation offset of arena 0
+         uint32_t closed; // Heap closed cleanly: pools are saved and regions have no pending notification
+         MemoryContext* context; // Heap context, stored in arena 0
+         sPoolLists pools[2][cMaxLayouts]; // Saved context pools, by managed flag and layout
+         void* roots[cMaxRoots];
+         sArenaSlot arenas[cMaxArenas];
+         uint32_t schemas_count;
+         char schemas[cMaxSchemas][cSchemaNameSize]; // Schema names by schema id
+      };
+
+      DirectFileView* view = 0;
+      sHeader* header = 0;
+      MemoryContext* context = 0;
+      size_t arenas_limit = 0;
+      ArenaEntry view_entries[cMaxArenas]; // Arena map entries of the view, restored on close
+      std::mutex lock;
+
+   public:
+      ~PersistentHeap();
+
+      MemoryContext* GetContext() { return this->context; }
+      address_t GetBase() { return this->header->base; }
+      size_t GetArenasCount() { return this->header->arenas_count; }
+
+      // Roots: entry points of the object graph stored in the heap
+      void* GetRoot(size_t index);
+      void SetRoot(size_t index, void* ptr);
+
+      // Write schema names and modified pages to the file
+      bool Flush();
+
+      // Region management (used by object regions of the heap context)
+      address_t AllocateRegion(bool managed, uint8_t sizeL2);
+      void DisposeRegion(address_t address);
+
+      // Open a heap file, created when missing or reset (base is ignored for an existing heap)
+      static PersistentHeap* Open(const char* filename, size_t sizeLimit, bool reset = false, uintptr_t base = cDefaultBase);
+
+   protected:
+      void* AllocateMeta(size_t size);
+      ArenaDescriptor* AcquireArena(bool managed, uint8_t sizeL2);
+      void BindArena(size_t slot);
+      bool BindSchemas(ObjectSchemaID* remap);
+      void AttachRegions(ObjectSchemaID* remap);
+      void SavePools();
+      void RestorePools();
+   };
+
+}
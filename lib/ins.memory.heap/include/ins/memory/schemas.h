@@ -1,6 +1,8 @@
 #pragma once
 #include <ins/memory/map.h>
 #include <ins/memory/objects-base.h>
+#include <ins/memory/analysis.h>
+#include <typeinfo>
 
 namespace ins::mem {
 
@@ -24,6 +26,9 @@ namespace ins::mem {
    typedef void (*ObjectTraverser)(TraversalContext<>* context);
    typedef void (*ObjectFinalizer)(void* ptr);
 
+   extern void* AllocateManagedObject(ObjectSchemaID schemaID);
+   extern bool FreeObject(void* ptr);
+
    struct sObjectSchema {
 
       enum StandardSchemaID {
@@ -32,6 +37,7 @@ namespace ins::mem {
       };
 
       uint32_t base_size;
+      uint32_t pending = 0; // Reserved by name, bound by the first schema created with this name
       IObjectSchema* infos = 0;
       ObjectTraverser traverser = 0;
       ObjectFinalizer finalizer = 0;
@@ -46,6 +52,10 @@ namespace ins::mem {
       size_t size();
    };
 
+   extern void* AllocateLayoutObject(bool managed, ObjectSchemaID schemaID, uint8_t layoutID);
+   extern bool FreeObject(void* ptr);
+   template<bool managed, uint8_t layoutID> bool FreeLayoutObject(void* ptr);
+
    struct ManagedClassBase {
 
       // Collected Reference: reference a collected object from a collected object
@@ -69,7 +79,7 @@ namespace ins::mem {
    template<class T>
    struct ManagedClass : ManagedClassBase {
       static ManagedSchema schema;
-      typedef typename T Class;
+      typedef T Class;
       static void __finalizer__(T* ptr) {
          ptr->~Class();
       }
@@ -78,16 +88,28 @@ namespace ins::mem {
             schema.InstallSchema(typeid(T), sizeof(T), ObjectTraverser(&T::__traverser__), ObjectFinalizer(&__finalizer__));
             _ASSERT(schema.size() == size);
          }
-         return AllocateManagedObject(schema.id);
+         constexpr uint8_t layoutID = getLayoutForSize(sizeof(T) + sizeof(sObjectHeader));
+         if constexpr (layoutID < cst::ObjectLayoutMax) return AllocateLayoutObject(true, schema.id, layoutID);
+         else return AllocateManagedObject(schema.id);
       }
       void operator delete(void* ptr) {
-         FreeObject(ptr);
+         constexpr uint8_t layoutID = getLayoutForSize(sizeof(T) + sizeof(sObjectHeader));
+         if constexpr (layoutID < cst::ObjectLayoutMax) FreeLayoutObject<true, layoutID>(ptr);
+         else FreeObject(ptr);
       }
    };
 
+   template<class T>
+   ManagedSchema ManagedClass<T>::schema;
+
    extern sObjectSchema* ObjectSchemas;
    inline ObjectSchemaID GetObjectSchemaID(ObjectSchema schema) { return (uintptr_t(schema) - uintptr_t(ObjectSchemas)) / sizeof(sObjectSchema); }
    inline ObjectSchema GetObjectSchema(ObjectSchemaID id) { return &ObjectSchemas[id]; }
    extern ObjectSchema CreateObjectSchema(IObjectSchema* infos, uint32_t base_size, ObjectTraverser traverser, ObjectFinalizer finalizer);
 
+   // Schemas by name (used to rebind schemas of persistent objects)
+   extern ObjectSchemaID GetObjectSchemaCount();
+   extern ObjectSchema FindObjectSchema(const char* name);
+   extern ObjectSchema ReserveObjectSchema(const char* name);
+
 }
@@ -0,0 +1,113 @@
+#pragma once
+#include <ins/memory/file-view.h>
+#include <ins/memory/contexts.h>
+#if !defined(_WIN32)
+#include <pthread.h>
+#endif
+
+namespace ins::mem {
+
+   /**********************************************************************
+   *
+   *   Shared Heap
+   *   (object heap in a shared memory mapped at a fixed base by several processes)
+   *
+   ***********************************************************************/
+   // Objects are exchanged between processes without copy: a pointer allocated in a process
+   // is valid in all the attached processes, which can read it and free it.
+   //
+   // Memory layout:
+   // - arena 0: heap header, then the arena descriptors and the contexts of the heap
+   // - arena 1..n: object regions, one arena per region class (managed, sizeL2)
+   //
+   // Region class arenas are all created with the heap, so the arena map of an attached process
+   // is complete from its attach. Regions are allocated under a lock stored in the shared memory
+   // (robust: recovered when its holder process dies), and each process allocates through its own
+   // context, stored in arena 0: a remote free is notified to the region owner context as between
+   // threads, the owner collects it on its next allocations. A detached context, or the context of
+   // a dead process, keeps its regions and is adopted by the next attached process.
+   //
+   // The shared memory holds no process local pointer read by another process: the regions have no
+   // central context (they stay owned by their context), and are disposed through their arena owner.
+   //
+   // Attached processes shall register the same object schemas in the same order (schema ids
+   // are stored in the objects). Large objects (beyond object layouts) are not supported.
+   struct SharedHeap : Descriptor {
+      static const uint64_t cMagic = 0x3148534e49; // "INSH1"
+      static const uint32_t cVersion = 4;
+      static const size_t cMaxArenas = 64;
+      static const size_t cMaxContexts = 64;
+      static const size_t cMaxRoots = 16;
+      static const uintptr_t cDefaultBase = uintptr_t(0x6000) << cst::ArenaSizeL2;
+
+   protected:
+      struct sLock {
+#if defined(_WIN32)
+         std::atomic_uint32_t state = 0; // Spin lock (no process local state)
+#else
+         pthread_mutex_t mutex; // Process shared and robust mutex
+#endif
+         void Initialize();
+         void lock();
+         void unlock();
+      };
+      struct sArenaSlot {
+         ArenaDescriptor* descriptor = 0;
+         uint8_t sizeL2 = 0;
+         bool managed = false;
+      };
+      struct sContextSlot {
+         std::atomic_uint32_t pid = 0; // Attached process (0 when the context is free)
+         MemoryContext* context = 0;
+      };
+      struct sHeader : Descriptor {
+         uint64_t magic;
+         uint32_t version;
+         uint32_t arenas_count;
+         uintptr_t base;
+         size_t meta_cursor; // Allocation offset of arena 0
+         size_t size_limit; // Limit of the used region bytes
+         std::atomic_size_t used_bytes;
+         sLock lock;
+         uint8_t class_slots[2][cst::ArenaSizeL2 + 1]; // Arena slot by managed flag and region sizeL2
+         std::atomic<void*> roots[cMaxRoots];
+         sArenaSlot arenas[cMaxArenas];
+         sContextSlot contexts[cMaxContexts];
+      };
+
+      DirectFileView* view = 0;
+      sHeader* header = 0;
+      MemoryContext* context = 0;
+      uint32_t pid = 0; // Process of the context
+      ArenaEntry view_entries[cMaxArenas]; // Arena map entries of the view, restored on detach
+
+   public:
+      ~SharedHeap();
+
+      // Context of the calling process (a forked process gets its own context on first call)
+      MemoryContext* GetContext();
+      address_t GetBase() { return this->header->base; }
+      size_t GetUsedBytes() { return this->header->used_bytes; }
+
+      // Roots: entry points of the object graphs exchanged between processes
+      void* GetRoot(size_t index);
+      void SetRoot(size_t index, void* ptr);
+      void* ExchangeRoot(size_t index, void* ptr);
+
+      // Region management (used by object regions of the heap contexts)
+      address_t AllocateRegion(bool managed, uint8_t sizeL2);
+      static void DisposeRegion(address_t address); // Region of a shared heap arena, from any attached process
+
+      // Create a heap (unnamed: shared with forked processes only), or open it from another process
+      static SharedHeap* Create(const char* name, size_t sizeLimit, uintptr_t base = cDefaultBase);
+      static SharedHeap* Open(const char* name, uintptr_t base = cDefaultBase);
+      static bool Remove(const char* name);
+
+   protected:
+      void* AllocateMeta(size_t size);
+      void BindArena(size_t slot);
+      void AttachContext();
+      void DetachContext();
+   };
+
+}
@@ -5,6 +5,7 @@
 #include <thread>
 #include <iostream>
 #include <condition_variable>
+#include <string.h>
 
 using namespace ins;
 using namespace ins::mem;
@@ -29,24 +30,40 @@ struct DeepMarkerContext : TraversalContext<sObjectSchema, uint8_t> {
       }
    }
    void Mark(address_t address) {
+#if _INS_OBJECT_PAGE_MAP
+      if (auto map = mem::ObjectPageMap) {
+         ObjectPageEntry page = map[address.ptr >> cst::PageSizeL2].load(std::memory_order_relaxed);
+         if (page.IsMapped()) {
+            if (page.managed) {
+               auto& infos = mem::cst::ObjectLayoutBase[page.layoutID];
+               auto offset = address.ptr & ((uintptr_t(1) << page.region_sizeL2) - 1);
+               auto regionIndex = uintptr_t(address.position) >> page.region_sizeL2;
+               this->MarkObject(address, regionIndex, infos.GetObjectIndex(offset));
+            }
+            return;
+         }
+      }
+#endif
       auto entry = mem::ArenaMap[address.arenaID];
       if (entry.managed) {
-         auto regionIndex = address.position >> entry.segmentation;
+         auto regionIndex = uintptr_t(address.position) >> entry.segmentation;
          auto regionLayout = entry.layout(regionIndex);
          if (regionLayout.IsObjectRegion()) {
             auto& infos = mem::cst::ObjectLayoutBase[regionLayout];
             auto offset = address.position & mem::cst::RegionMasks[entry.segmentation];
-            auto objectIndex = infos.GetObjectIndex(offset);
-            auto objectBit = uint64_t(1) << objectIndex;
-            if (session->MarkAlive(address.arenaID, regionIndex, objectBit)) {
-               if (this->depth == 0) {
-                  this->session->Postpone(address.arenaID, regionIndex, objectBit);
-               }
-               else {
-                  auto obj = &address.as<sObjectHeader>()[-1];
-                  this->Traverse(obj);
-               }
-            }
+            this->MarkObject(address, regionIndex, infos.GetObjectIndex(offset));
+         }
+      }
+   }
+   void MarkObject(address_t address, uintptr_t regionIndex, uintptr_t objectIndex) {
+      auto objectBit = uint64_t(1) << objectIndex;
+      if (session->MarkAlive(address.arenaID, regionIndex, objectBit)) {
+         if (this->depth == 0) {
+            this->session->Postpone(address.arenaID, regionIndex, objectBit);
+         }
+         else {
+            auto obj = &address.as<sObjectHeader>()[-1];
+            this->Traverse(obj);
          }
       }
    }
@@ -55,13 +72,14 @@ struct DeepMarkerContext : TraversalContext<sObjectSchema, uint8_t> {
    }
 };
 
-__declspec(noinline) bool mem::ObjectAnalysisSession::MarkAlive(uint16_t arenaID, uint32_t regionIndex, uint64_t objectBit) {
+_INS_NOINLINE bool mem::ObjectAnalysisSession::MarkAlive(uint32_t arenaID, uint32_t regionIndex, uint64_t objectBit) {
+   if (!this->arenaIndexesMap[arenaID]) return false; // Arena created after session reset
    auto index = this->arenaIndexesMap[arenaID] + regionIndex;
    auto prev = this->regionAlivenessMap[index].flags.fetch_or(objectBit);
    return (prev & objectBit) == 0;
 }
 
-void mem::ObjectAnalysisSession::Postpone(uint16_t arenaID, uint32_t regionIndex, uint64_t objectBit) {
+void mem::ObjectAnalysisSession::Postpone(uint32_t arenaID, uint32_t regionIndex, uint64_t objectBit) {
    auto index = this->arenaIndexesMap[arenaID] + regionIndex;
    auto item = &this->regionItemsMap[index];
    auto prev = item->uncheckeds.fetch_or(objectBit);
@@ -88,16 +106,23 @@ void mem::ObjectAnalysisSession::MarkPtr(void* target) {
 void mem::ObjectAnalysisSession::Reset() {
    uint32_t count = 1; // start at 1 because 0 is the reserved null index
    if (!this->arenaIndexesMap) {
-      this->arenaIndexesMap = (uint32_t*)malloc(sizeof(uint32_t) * cst::ArenaPerSpace);
+      this->arenaIndexesMap = (uint32_t*)calloc(cst::ArenaPerSpace, sizeof(uint32_t));
    }
-   for (int i = 0; i < cst::ArenaPerSpace; i++) {
-      auto& entry = mem::ArenaMap[i];
-      this->arenaIndexesMap[i] = count;
-      if (entry.managed) {
-         auto arena = entry.descriptor();
-         count += arena->availables_count.load();
-      }
+   else if (this->arenaIndexesFirst <= this->arenaIndexesLast) {
+      // Clear previous indexes: an arena ID released since then may be reused by an arena not indexed yet
+      memset(&this->arenaIndexesMap[this->arenaIndexesFirst], 0, sizeof(uint32_t) * (this->arenaIndexesLast - this->arenaIndexesFirst + 1));
    }
+   this->arenaIndexesFirst = uint32_t(cst::ArenaPerSpace);
+   this->arenaIndexesLast = 0;
+   mem::ManagedArenas.Foreach(
+      [&](uint32_t arenaID) {
+         if (arenaID < this->arenaIndexesFirst) this->arenaIndexesFirst = arenaID;
+         if (arenaID > this->arenaIndexesLast) this->arenaIndexesLast = arenaID;
+         this->arenaIndexesMap[arenaID] = count;
+         count += uint32_t(mem::ArenaMap[arenaID].descriptor()->GetRegionCount());
+         return true;
+      }
+   );
    if (count > this->allocated) {
       if (this->regionAlivenessMap) {
          free(this->regionAlivenessMap);
@@ -8,8 +8,8 @@ using namespace ins;
 using namespace ins::mem;
 
 mem::MemoryCentralContext* mem::Central = 0;
-mem::MemorySharedContext* mem::DefaultContext = 0;
-_declspec(thread) MemoryContext* mem::CurrentContext = 0;
+_INS_CONSTINIT std::atomic<mem::MemorySharedContext*> mem::DefaultContext = { 0 };
+_INS_TLS MemoryContext* mem::CurrentContext = 0;
 
 void mem::MemorySharedContext::AcquireContext() {
    this->shared = mem::AcquireContext(true);
@@ -48,6 +48,7 @@ void mem::MemoryCentralContext::PerformCleanup() {
 }
 
 void mem::MemoryCentralContext::InitiateContext(MemoryContext* context) {
+   context->central = this;
    context->unmanaged.Initialize(context, &this->unmanaged);
    context->managed.Initialize(context, &this->managed);
 }
@@ -61,7 +62,7 @@ void mem::MemoryCentralContext::InitiateContext(MemoryContext* context) {
 void mem::MemoryContext::RescueStarvingSituation(size_t expectedByteLength) {
    mem::StarvedConsumerToken token;
    token.expectedByteLength = expectedByteLength;
-   token.context = mem::CurrentContext;
+   token.context = this;
    mem::RescueStarvedConsumer(token);
 }
 
@@ -91,6 +92,34 @@ void* mem::MemoryContext::AllocateManaged(ObjectSchemaID schema_id, size_t size)
    return &obj[1];
 }
 
+void* mem::MemoryContext::AllocateInLayout(bool managed, ObjectSchemaID schema_id, uint8_t layoutID) {
+   auto obj = (managed ? this->managed : this->unmanaged).AcquireObject(layoutID);
+   obj->schema_id = schema_id;
+   if (managed) {
+      if (auto session = ObjectAnalysisSession::enabled) {
+         session->MarkPtr(obj);
+      }
+   }
+   return &obj[1];
+}
+
+void mem::MemoryContext::AllocateUnmanagedObjects(size_t size, size_t count, void** ptrs) {
+   auto layoutID = getLayoutForSize(size + sizeof(sObjectHeader));
+   if (this->options.enableds || layoutID >= cst::ObjectLayoutMax) {
+      for (size_t i = 0; i < count; i++) {
+         ptrs[i] = this->AllocateUnmanaged(0, size);
+      }
+      return;
+   }
+   auto objects = (ObjectHeader*)ptrs;
+   this->unmanaged.AcquireObjects(layoutID, count, objects);
+   for (size_t i = 0; i < count; i++) {
+      auto obj = objects[i];
+      obj->schema_id = 0;
+      ptrs[i] = &obj[1];
+   }
+}
+
 void** mem::MemoryContext::NewHardReference(void* ptr) {
    return 0;
 }
@@ -100,6 +129,12 @@ void** mem::MemoryContext::NewWeakReference(void* ptr) {
 }
 
 void mem::MemoryContext::Scavenge() {
+   if (this->persistent || this->shared) {
+      // Persistent and shared regions cannot move to the central context, only collect the notified ones
+      this->unmanaged.ScavengeNotifieds();
+      this->managed.ScavengeNotifieds();
+      return;
+   }
    printf("> Scavenge context %d [%s]\n", this->id, this->isShared ? "shared" : "private");
    this->unmanaged.Scavenge();
    this->managed.Scavenge();
@@ -120,6 +155,21 @@ void mem::MemoryContext::PerformCleanup() {
    }
 }
 
+void mem::MemoryContext::SetHomeNode(uint8_t numaNode) {
+   numaNode = numaNode % mem::GetNumaNodeCount();
+   if (this->numaNode != numaNode) {
+      if (this->persistent || this->shared) {
+         this->numaNode = numaNode; // File backed regions are not bound to a node
+         return;
+      }
+
+      // Remote regions shall not stay in local usables: not full ones are given to central now,
+      // full ones on their first release (see ObjectLocalContext::PushUsableRegion)
+      this->Scavenge();
+      this->numaNode = numaNode;
+   }
+}
+
 /**********************************************************************
 *
 *   MemoryContext
@@ -138,29 +188,39 @@ MemoryContext* mem::SetThreadContext(MemoryContext* context) {
 
 void* mem::AllocateObject(size_t size) {
    if (auto context = mem::CurrentContext) return context->AllocateUnmanaged(0, size);
-   else return mem::DefaultContext->AllocateUnmanaged(0, size);
+   else return mem::GetDefaultContext()->AllocateUnmanaged(0, size);
+}
+
+void* mem::AllocateLayoutObject(bool managed, ObjectSchemaID schemaID, uint8_t layoutID) {
+   if (auto context = mem::CurrentContext) return context->AllocateInLayout(managed, schemaID, layoutID);
+   else return mem::GetDefaultContext()->AllocateInLayout(managed, schemaID, layoutID);
+}
+
+void mem::AllocateObjects(size_t size, size_t count, void** ptrs) {
+   if (auto context = mem::CurrentContext) context->AllocateUnmanagedObjects(size, count, ptrs);
+   else mem::GetDefaultContext()->AllocateUnmanagedObjects(size, count, ptrs);
 }
 
 void* mem::AllocateUnmanagedObject(ObjectSchemaID schemaID, size_t size) {
    if (auto context = mem::CurrentContext) return context->AllocateUnmanaged(schemaID, size);
-   else return mem::DefaultContext->AllocateUnmanaged(schemaID, size);
+   else return mem::GetDefaultContext()->AllocateUnmanaged(schemaID, size);
 }
 
 void* mem::AllocateManagedObject(ObjectSchemaID schemaID, size_t size) {
    if (auto context = mem::CurrentContext) return context->AllocateManaged(schemaID, size);
-   else return mem::DefaultContext->AllocateManaged(schemaID, size);
+   else return mem::GetDefaultContext()->AllocateManaged(schemaID, size);
 }
 
 void* mem::AllocateUnmanagedObject(ObjectSchemaID schemaID) {
    auto schema = mem::GetObjectSchema(schemaID);
    if (auto context = mem::CurrentContext) return context->AllocateUnmanaged(schemaID, schema->base_size);
-   else return mem::DefaultContext->AllocateUnmanaged(schemaID, schema->base_size);
+   else return mem::GetDefaultContext()->AllocateUnmanaged(schemaID, schema->base_size);
 }
 
 void* mem::AllocateManagedObject(ObjectSchemaID schemaID) {
    auto schema = mem::GetObjectSchema(schemaID);
    if (auto context = mem::CurrentContext) return context->AllocateManaged(schemaID, schema->base_size);
-   else return mem::DefaultContext->AllocateManaged(schemaID, schema->base_size);
+   else return mem::GetDefaultContext()->AllocateManaged(schemaID, schema->base_size);
 }
 
 void mem::RetainObject(void* ptr) {
@@ -183,15 +243,57 @@ bool mem::FreeObject(void* ptr) {
    return ObjectLocation(ptr).Free(mem::CurrentContext);
 }
 
+size_t mem::FreeObjects(void** ptrs, size_t count) {
+   auto context = mem::CurrentContext;
+   ObjectRegion region = 0;
+   bool managed = false;
+   uint64_t objects_bits = 0;
+   size_t freeds = 0;
+   for (size_t i = 0; i < count; i++) {
+      if (!ptrs[i]) continue;
+      ObjectLocation loc(ptrs[i]);
+
+      // Release the objects of the previous region
+      if (loc.region != region) {
+         if (objects_bits) {
+            region->ReleaseObjects(objects_bits, managed, context);
+            objects_bits = 0;
+         }
+         region = loc.region;
+         managed = loc.managed;
+      }
+
+      // Check object as in ObjectLocation::Free
+      auto object_bit = uint64_t(1) << loc.index;
+      if (!loc.object) {
+         mem::NotifyHeapIssue(tHeapIssue::FreeOutOfBoundObject, loc.region);
+      }
+      else if ((objects_bits & object_bit) || region->IsObjectAvailable(object_bit)) {
+         mem::NotifyHeapIssue(tHeapIssue::FreeInexistingObject, loc.object);
+      }
+      else if (loc.object->retention) {
+         mem::NotifyHeapIssue(tHeapIssue::FreeRetainedObject, loc.object);
+      }
+      else {
+         objects_bits |= object_bit;
+         freeds++;
+      }
+   }
+   if (objects_bits) {
+      region->ReleaseObjects(objects_bits, managed, context);
+   }
+   return freeds;
+}
+
 
 void** mem::NewHardReference(void* ptr) {
    if (auto context = mem::CurrentContext) return context->NewHardReference(ptr);
-   else return mem::DefaultContext->NewHardReference(ptr);
+   else return mem::GetDefaultContext()->NewHardReference(ptr);
 }
 
 void** mem::NewWeakReference(void* ptr) {
    if (auto context = mem::CurrentContext) return context->NewWeakReference(ptr);
-   else return mem::DefaultContext->NewWeakReference(ptr);
+   else return mem::GetDefaultContext()->NewWeakReference(ptr);
 }
 
 void mem::DeleteReference(void** ref) {
@@ -3,6 +3,7 @@
 #include <ins/timing.h>
 #include <ins/os/memory.h>
 #include <mutex>
+#include <string.h>
 #include <thread>
 #include <iostream>
 #include <condition_variable>
@@ -19,8 +20,18 @@ struct InvalidateSchema : IObjectSchema {
    const char* name() override { return "<invalid>"; }
 };
 
+struct PendingSchema : IObjectSchema {
+   char type_name[128] = { 0 };
+   const char* name() override { return this->type_name; }
+};
+
 constexpr uint32_t c_MaxTracker = 128;
 
+// Memory pressure: reclaim when some threads stall on memory 100ms in a 1s window
+constexpr uint32_t c_PressureStallUs = 100000;
+constexpr uint32_t c_PressureWindowUs = 1000000;
+constexpr uint32_t c_PressureWaitMs = 200;
+
 namespace ins::mem {
 
    struct SchemaArena : ArenaDescriptor {
@@ -29,21 +40,32 @@ namespace ins::mem {
       uintptr_t alloc_cursor = 0;
       uintptr_t alloc_commited = 0;
       uintptr_t alloc_end = 0;
+      uint32_t pending_count = 0;
 
       OpaqueSchema opaque_schema;
       InvalidateSchema invalidate_schema;
+      sObjectSchema builtin_schemas[2]; // Schema table until the first schema is created
 
       SchemaArena();
       void Initialize();
       size_t GetTableUsedBytes();
       ObjectSchema CreateSchema(IObjectSchema* schema, uint32_t base_size, ObjectTraverser traverser, ObjectFinalizer finalizer);
+      ObjectSchema ReserveSchema(const char* name);
+      ObjectSchema FindSchema(const char* name);
+      ObjectSchemaID GetSchemaCount();
+   private:
+      void CommitTable();
+      ObjectSchema AppendSchema();
    };
 
    struct HeapDescriptor : Descriptor {
       std::mutex notification_lock;
       std::condition_variable notification_signal;
       std::thread worker;
-      bool terminating = false;
+      std::thread pressure_watcher;
+      std::atomic_bool worker_started = false;
+      std::atomic_bool terminating = false;
+      bool pressured = false;
 
       std::mutex contexts_lock;
       uint16_t contexts_count = 0;
@@ -51,8 +73,7 @@ namespace ins::mem {
 
       MemoryCentralContext central;
       MemorySharedContext default_context;
-
-      SchemaArena schemas;
+      RegionPools* pools = 0; // Isolated region pools (0 for the process heap)
 
       MemoryContext* recovered_contexts = 0;
       StarvedConsumerToken* starved_consumers = 0;
@@ -65,17 +86,24 @@ namespace ins::mem {
       ObjectReferenceTracker trackers[c_MaxTracker];
 
 
-      HeapDescriptor();
+      HeapDescriptor(RegionPools* pools);
       ~HeapDescriptor();
 
+      MemoryContext* AcquireContext(bool isShared);
+      void StartWorker();
       void RunWorker();
+      void RunPressureWatcher();
       void NotifyWorker();
+      void PerformCleanup();
+      void MarkAndSweepUnusedObjects();
+      void DemoteColdRegions();
       void MarkUsedObjects();
       void SweepUnusedObjects();
    };
 }
 
-static mem::HeapDescriptor* controller = 0;
+static mem::SchemaArena* schemas = 0;
+static mem::HeapDescriptor* controller = 0; // Process heap
 
 mem::SchemaArena::SchemaArena() {
    this->ArenaDescriptor::Initialize(cst::ArenaSizeL2);
@@ -84,29 +112,41 @@ mem::SchemaArena::SchemaArena() {
 }
 
 void mem::SchemaArena::Initialize() {
+   auto& opaque_schema = this->builtin_schemas[sObjectSchema::OpaqueID];
+   opaque_schema.base_size = 0;
+   opaque_schema.infos = &this->opaque_schema;
+
+   auto& invalidate_schema = this->builtin_schemas[sObjectSchema::InvalidateID];
+   invalidate_schema.base_size = 0;
+   invalidate_schema.infos = &this->invalidate_schema;
+
+   mem::ObjectSchemas = this->builtin_schemas;
+}
+
+void mem::SchemaArena::CommitTable() {
+   if (this->alloc_end) return;
+
+   // Move the builtin schemas at the base of a reserved arena, ids are kept
    address_t buffer = mem::ReserveArena();
    this->indice = buffer.arenaID;
    this->alloc_cursor = buffer;
    this->alloc_commited = buffer;
    this->alloc_end = buffer + cst::ArenaSize;
    this->alloc_region_size = size_t(1) << 16;
-   mem::ArenaMap[buffer.arenaID] = this;
+   mem::RegisterArena(this);
 
+   for (auto& builtin : this->builtin_schemas) {
+      *this->AppendSchema() = builtin;
+   }
    mem::ObjectSchemas = ObjectSchema(this->GetBase());
-
-   auto opaque_schema = CreateSchema(&this->opaque_schema, 0, 0, 0);
-   if (GetObjectSchemaID(opaque_schema) != sObjectSchema::OpaqueID) throw;
-
-   auto invalidate_schema = CreateSchema(&this->invalidate_schema, 0, 0, 0);
-   if (GetObjectSchemaID(invalidate_schema) != sObjectSchema::InvalidateID) throw;
 }
 
 size_t mem::SchemaArena::GetTableUsedBytes() {
    return this->alloc_commited - this->GetBase();
 }
 
-ObjectSchema mem::SchemaArena::CreateSchema(IObjectSchema* infos, uint32_t base_size, ObjectTraverser traverser, ObjectFinalizer finalizer) {
-   std::lock_guard<std::mutex> guard(this->lock);
+ObjectSchema mem::SchemaArena::AppendSchema() {
+   this->CommitTable();
    auto schema = ObjectSchema(this->alloc_cursor);
    this->alloc_cursor += sizeof(sObjectSchema);
    if (this->alloc_cursor > this->alloc_commited) {
@@ -120,6 +160,29 @@ ObjectSchema mem::SchemaArena::CreateSchema(IObjectSchema* infos, uint32_t base_
          exit(1);
       }
    }
+   return schema;
+}
+
+ObjectSchema mem::SchemaArena::CreateSchema(IObjectSchema* infos, uint32_t base_size, ObjectTraverser traverser, ObjectFinalizer finalizer) {
+   std::lock_guard<std::mutex> guard(this->lock);
+   ObjectSchema schema = 0;
+
+   // Bind the pending schema reserved with the same name
+   if (this->pending_count && infos) {
+      auto name = infos->name();
+      for (auto cur = ObjectSchema(this->GetBase()); uintptr_t(cur) < this->alloc_cursor; cur++) {
+         if (cur->pending && !strcmp(cur->infos->name(), name)) {
+            Descriptor::Delete((PendingSchema*)cur->infos);
+            cur->pending = 0;
+            this->pending_count--;
+            schema = cur;
+            break;
+         }
+      }
+   }
+   if (!schema) {
+      schema = this->AppendSchema();
+   }
    schema->infos = infos;
    schema->base_size = base_size;
    schema->traverser = traverser;
@@ -127,24 +190,111 @@ ObjectSchema mem::SchemaArena::CreateSchema(IObjectSchema* infos, uint32_t base_
    return schema;
 }
 
-mem::HeapDescriptor::HeapDescriptor() {
+ObjectSchema mem::SchemaArena::ReserveSchema(const char* name) {
+   std::lock_guard<std::mutex> guard(this->lock);
+   auto infos = Descriptor::New<PendingSchema>();
+   strncpy(infos->type_name, name, sizeof(infos->type_name) - 1);
+   auto schema = this->AppendSchema();
+   schema->infos = infos;
+   schema->base_size = 0;
+   schema->traverser = 0;
+   schema->finalizer = 0;
+   schema->pending = 1;
+   this->pending_count++;
+   return schema;
+}
+
+ObjectSchema mem::SchemaArena::FindSchema(const char* name) {
+   std::lock_guard<std::mutex> guard(this->lock);
+   auto count = this->GetSchemaCount();
+   for (ObjectSchemaID id = 0; id < count; id++) {
+      auto cur = &mem::ObjectSchemas[id];
+      if (cur->infos && !strcmp(cur->infos->name(), name)) return cur;
+   }
+   return 0;
+}
+
+ObjectSchemaID mem::SchemaArena::GetSchemaCount() {
+   if (!this->alloc_end) return ObjectSchemaID(sizeof(this->builtin_schemas) / sizeof(sObjectSchema));
+   return ObjectSchemaID((this->alloc_cursor - this->GetBase()) / sizeof(sObjectSchema));
+}
+
+mem::HeapDescriptor::HeapDescriptor(RegionPools* pools)
+   : pools(pools) {
    this->central.Initialize();
-   this->schemas.Initialize();
-   this->RunWorker();
+   this->central.heap = this;
+   this->central.pools = pools;
+}
+
+void mem::HeapDescriptor::StartWorker() {
+   if (this->worker_started.load(std::memory_order_acquire)) return;
+   std::lock_guard<std::mutex> guard(this->notification_lock);
+   if (!this->worker_started.load(std::memory_order_relaxed)) {
+      this->RunWorker();
+      if (!this->pools) this->RunPressureWatcher(); // Pressure is handled by the process heap
+      this->worker_started.store(true, std::memory_order_release);
+   }
 }
 
 void mem::HeapDescriptor::RunWorker() {
    this->worker = std::thread(
       [this]() {
+         timing::Chrono purgeChrono;
+         timing::Chrono coldChrono;
          while (!this->terminating) {
             std::unique_lock<std::mutex> guard(this->notification_lock);
-            this->notification_signal.wait(guard);
+            auto wakePeriod = mem::GetCachePurgePeriod();
+            auto coldPeriod = this->pools ? 0 : mem::GetColdRegionsPeriod();
+            if (coldPeriod) {
+               if (!wakePeriod || coldPeriod < wakePeriod) wakePeriod = coldPeriod;
+            }
+            if (this->starved_consumers || this->recovered_contexts || this->pressured) {
+               // Pending recovery, notified before the worker wait
+            }
+            else if (wakePeriod) {
+               this->notification_signal.wait_for(guard, std::chrono::milliseconds(wakePeriod));
+            }
+            else {
+               this->notification_signal.wait(guard);
+            }
             if (this->terminating) break;
 
+            // Decay idle cached regions
+            if (auto purgePeriod = mem::GetCachePurgePeriod()) {
+               auto elapsedMs = uint32_t(purgeChrono.GetDiffDouble(timing::Chrono::MS));
+               if (elapsedMs >= purgePeriod) {
+                  purgeChrono.Start();
+                  guard.unlock();
+                  if (this->pools) {
+                     mem::PurgeRegionPools(this->pools, elapsedMs);
+                  }
+                  else {
+                     mem::PurgeCachedRegions(elapsedMs);
+                     mem::ReconcilePhysicalBytes();
+                  }
+                  guard.lock();
+                  if (!this->pools && mem::IsPhysicalBytesSoftLimitReached()) {
+                     this->pressured = true; // Recovered as a memory pressure, before the limit is reached
+                  }
+               }
+            }
+
+            // Demote cold object regions
+            if (coldPeriod) {
+               if (coldChrono.GetDiffDouble(timing::Chrono::MS) >= coldPeriod) {
+                  coldChrono.Start();
+                  guard.unlock();
+                  this->DemoteColdRegions();
+                  guard.lock();
+               }
+            }
+
             auto starved_consumers = this->starved_consumers;
             auto recovered_contexts = this->recovered_contexts;
+            auto pressured = this->pressured;
             this->starved_consumers = 0;
             this->recovered_contexts = 0;
+            this->pressured = false;
             guard.unlock();
 
             // Apply memory soft recovery procedures
@@ -155,10 +305,10 @@ void mem::HeapDescriptor::RunWorker() {
             }
 
             // Apply memory hard recovery procedures
-            if (starved_consumers) {
+            if (starved_consumers || pressured) {
 
                // Cleanup heaps
-               PerformHeapCleanup();
+               this->PerformCleanup();
 
                // Restart starved consumers
                while (auto consumer = starved_consumers) {
@@ -173,27 +323,140 @@ void mem::HeapDescriptor::RunWorker() {
    );
 }
 
+// Objects content digest of a region, to sample its writes when the page writes cannot be
+static uint32_t GetRegionDigest(ObjectRegion region, size_t size) {
+   auto words = (uint64_t*)(uintptr_t(region) + cst::ObjectRegionHeadSize);
+   auto count = (size - cst::ObjectRegionHeadSize) / sizeof(uint64_t);
+   uint64_t digest = 0;
+   for (size_t i = 0; i < count; i++) {
+      digest = (digest ^ words[i]) * 0x9E3779B97F4A7C15ull;
+      digest ^= digest >> 29;
+   }
+   return uint32_t(digest ^ (digest >> 32));
+}
+
+void mem::HeapDescriptor::DemoteColdRegions() {
+   auto idlePasses = mem::GetColdRegionsIdlePasses();
+   auto sampling = mem::IsWriteSamplingSupported();
+   mem::ForeachRegion(
+      [&](ArenaDescriptor* arena, RegionLayoutID layout, address_t addr) {
+         if (!layout.IsObjectRegion() || layout >= cst::ObjectLayoutMax) return true;
+         if (arena->segmentation < cst::PageSizeL2) return true; // Sub-page regions share their pages
+         if (mem::GetRegionPools(addr)) return true; // Isolated heaps regions are not demoted
+         if (mem::IsColdRegion(addr)) return true; // Not touched until promoted
+
+         // Cold candidate: region full of objects, not listed in any pool and without pending notification
+         auto region = ObjectRegion(addr.ptr);
+         uint8_t layoutID = layout;
+         auto isCandidate = [region, addr, layoutID]() {
+            return region->availables == 0
+               && region->notified_availables.load(std::memory_order_relaxed) == 0
+               && region->next.used == none<sObjectRegion>()
+               && region->next.notified == none<sObjectRegion>()
+               && RegionLocation::New(addr).layout() == layoutID;
+         };
+         if (!isCandidate()) {
+            region->idle_passes = 0;
+            return true;
+         }
+
+         // Idle only when its objects are not written since the last pass
+         auto& infos = cst::ObjectLayoutInfos[region->layoutID];
+         auto& sizing = mem::cst::RegionSizingInfos[infos.region_sizeL2].sizings[infos.region_sizingID];
+         auto size = region->active_pages ? region->GetActiveSize() : sizing.committedSize;
+         bool written;
+         if (sampling) {
+            written = mem::IsRegionWritten(addr, size);
+         }
+         else {
+            auto digest = GetRegionDigest(region, size);
+            written = region->idle_passes == 0 || digest != region->idle_digest;
+            region->idle_digest = digest;
+         }
+         if (written && region->idle_passes) {
+            region->idle_passes = 0;
+            return true;
+         }
+         if (region->idle_passes < idlePasses) {
+            region->idle_passes++;
+            return true;
+         }
+
+         // Move the region pages to the cold storage
+         region->cold.store(true, std::memory_order_release);
+         if (!mem::DemoteRegion(addr, size, isCandidate)) {
+            region->cold.store(false, std::memory_order_release);
+         }
+         return true;
+      }
+   );
+
+   // Header updates of this pass are not sampled
+   if (sampling) mem::ResetRegionWrites();
+}
+
+void mem::HeapDescriptor::RunPressureWatcher() {
+   auto monitor = os::OpenMemoryPressureMonitor(c_PressureStallUs, c_PressureWindowUs);
+   if (!monitor) return;
+   this->pressure_watcher = std::thread(
+      [this, monitor]() {
+         while (!this->terminating) {
+            auto state = os::WaitMemoryPressure(monitor, c_PressureWaitMs);
+            if (state < 0) break;
+            if (state > 0) {
+               {
+                  std::lock_guard<std::mutex> guard(this->notification_lock);
+                  this->pressured = true;
+               }
+               this->NotifyWorker();
+
+               // Let the cleanup apply for a window before watching again
+               for (uint32_t t = 0; t < c_PressureWindowUs / 1000 && !this->terminating; t += c_PressureWaitMs) {
+                  std::this_thread::sleep_for(std::chrono::milliseconds(c_PressureWaitMs));
+               }
+            }
+         }
+         os::CloseMemoryPressureMonitor(monitor);
+      }
+   );
+}
+
 mem::HeapDescriptor::~HeapDescriptor() {
 
    this->terminating = true;
    this->notification_signal.notify_all();
-   this->worker.join();
+   if (this->worker.joinable()) {
+      this->worker.join();
+   }
+   if (this->pressure_watcher.joinable()) {
+      this->pressure_watcher.join();
+   }
 
    std::lock_guard<std::mutex> guard2(this->contexts_lock);
    while (this->contexts) {
       auto context = this->contexts;
       this->contexts = context->next.registered;
-      if (context->allocated) {
+      if (context->allocated && !this->pools) {
          context->PerformCleanup();
          std::cerr << "Delete heap with alive contexts\n";
       }
       Descriptor::Delete(context);
    }
-   this->central.PerformCleanup();
-   mem::PerformRegionsCleanup();
+
+   // Isolated heap: arenas are released with their regions, without visiting them
+   if (auto pools = this->pools) {
+      std::lock_guard<std::mutex> guard3(ObjectAnalysisSession::running); // Marking may still reach the heap objects
+      mem::ForeachArena(pools, [](ArenaDescriptor* arena) { mem::UnmapObjectArena(arena); return true; });
+      mem::DeleteRegionPools(pools);
+   }
+   else {
+      this->central.PerformCleanup();
+      mem::PerformRegionsCleanup();
+   }
 }
 
 void mem::HeapDescriptor::NotifyWorker() {
+   this->StartWorker();
    this->notification_signal.notify_one();
 }
 
@@ -203,9 +466,9 @@ void mem::HeapDescriptor::MarkUsedObjects() {
 
    // Mark object from trackers
    {
-      std::lock_guard<std::mutex> guard(controller->trackers_lock);
-      for (uint32_t i = 0; i < controller->trackers_count; i++) {
-         controller->trackers[i]->MarkObjects(*ObjectAnalysisSession::enabled);
+      std::lock_guard<std::mutex> guard(this->trackers_lock);
+      for (uint32_t i = 0; i < this->trackers_count; i++) {
+         this->trackers[i]->MarkObjects(*ObjectAnalysisSession::enabled);
       }
    }
 
@@ -217,17 +480,17 @@ void mem::HeapDescriptor::MarkUsedObjects() {
 
 void mem::HeapDescriptor::SweepUnusedObjects() {
    size_t sweptObjects = 0;
-   for (size_t i = 0; i < cst::ArenaPerSpace; i++) {
-      auto& entry = mem::ArenaMap[i];
-      if (entry.managed) {
-         auto arena = entry.descriptor();
-         address_t base = i << cst::ArenaSizeL2;
-
-         // Compare aliveness map to the new aliveness snapshot
-         auto alivenessSnapshot = &this->cleanup.regionAlivenessMap[this->cleanup.arenaIndexesMap[i]];
-         auto startIndex = this->cleanup.arenaIndexesMap[i];
-         auto endIndex = this->cleanup.arenaIndexesMap[i + 1];
-         auto length = endIndex - startIndex;
+   mem::ManagedArenas.Foreach(
+      [&](uint32_t arenaID) {
+         auto arena = mem::ArenaMap[arenaID].descriptor();
+         address_t base = uintptr_t(arenaID) << cst::ArenaSizeL2;
+         if (mem::GetRegionPools(base) != this->pools) return true; // Arena of another heap
+
+         // Compare aliveness map to the new aliveness snapshot (arena created after snapshot are skipped)
+         auto startIndex = this->cleanup.arenaIndexesMap[arenaID];
+         if (!startIndex) return true;
+         auto alivenessSnapshot = &this->cleanup.regionAlivenessMap[startIndex];
+         auto length = arena->GetRegionLimit();
          for (size_t i = 0; i < length; i++) {
             if (arena->regions[i].IsObjectRegion()) {
                auto region = ObjectRegion(base.ptr + (i << arena->segmentation));
@@ -242,70 +505,108 @@ void mem::HeapDescriptor::SweepUnusedObjects() {
                }
             }
          }
+         return true;
       }
-   }
+   );
 
    printf("sweep %lld objects\n", sweptObjects);
 }
 
 ObjectSchema mem::CreateObjectSchema(IObjectSchema* infos, uint32_t base_size, ObjectTraverser traverser, ObjectFinalizer finalizer) {
-   return controller->schemas.CreateSchema(infos, base_size, traverser, finalizer);
+   return schemas->CreateSchema(infos, base_size, traverser, finalizer);
 }
 
-void mem::PerformHeapCleanup() {
+ObjectSchemaID mem::GetObjectSchemaCount() {
+   return schemas->GetSchemaCount();
+}
+
+ObjectSchema mem::FindObjectSchema(const char* name) {
+   return schemas->FindSchema(name);
+}
+
+ObjectSchema mem::ReserveObjectSchema(const char* name) {
+   return schemas->ReserveSchema(name);
+}
+
+void mem::HeapDescriptor::PerformCleanup() {
    timing::Chrono chrono;
 
    // Purge allocation caches
-   for (auto context = controller->contexts; context; context = context->next.registered) {
+   for (auto context = this->contexts; context; context = context->next.registered) {
       context->PerformCleanup();
    }
-   controller->central.PerformCleanup();
-   mem::PerformRegionsCleanup();
+   this->central.PerformCleanup();
+   if (this->pools) mem::CleanRegionPools(this->pools);
+   else mem::PerformRegionsCleanup();
 
    // Sweep unused objects
-   mem::MarkAndSweepUnusedObjects();
+   this->MarkAndSweepUnusedObjects();
 
    printf("> cleanup time: %g ms\n", chrono.GetDiffFloat(chrono.MS));
 }
 
-void mem::MarkAndSweepUnusedObjects() {
+void mem::HeapDescriptor::MarkAndSweepUnusedObjects() {
    if (ObjectAnalysisSession::running.try_lock()) {
       _ASSERT(!ObjectAnalysisSession::enabled);
-      controller->cycle++;
+      this->cycle++;
 
       // Run objects aliveness analysis
-      controller->MarkUsedObjects();
+      this->MarkUsedObjects();
 
       // Sweep unused objects
-      controller->SweepUnusedObjects();
+      this->SweepUnusedObjects();
 
       ObjectAnalysisSession::running.unlock();
    }
 }
 
-void mem::RegisterReferenceTracker(ObjectReferenceTracker tracker) {
-   std::lock_guard<std::mutex> guard(controller->trackers_lock);
-   if (controller->trackers_count < c_MaxTracker) {
-      controller->trackers[controller->trackers_count] = tracker;
-      controller->trackers_count++;
+void mem::PerformHeapCleanup() {
+   controller->PerformCleanup();
+}
+
+void mem::PerformHeapCleanup(HeapDescriptor* heap) {
+   heap->PerformCleanup();
+}
+
+void mem::MarkAndSweepUnusedObjects() {
+   controller->MarkAndSweepUnusedObjects();
+}
+
+void mem::MarkAndSweepUnusedObjects(HeapDescriptor* heap) {
+   heap->MarkAndSweepUnusedObjects();
+}
+
+void mem::RegisterReferenceTracker(HeapDescriptor* heap, ObjectReferenceTracker tracker) {
+   std::lock_guard<std::mutex> guard(heap->trackers_lock);
+   if (heap->trackers_count < c_MaxTracker) {
+      heap->trackers[heap->trackers_count] = tracker;
+      heap->trackers_count++;
    }
    else {
       throw "MaxTracker limit reach";
    }
 }
 
-void mem::UnregisterReferenceTracker(ObjectReferenceTracker tracker) {
-   std::lock_guard<std::mutex> guard(controller->trackers_lock);
+void mem::UnregisterReferenceTracker(HeapDescriptor* heap, ObjectReferenceTracker tracker) {
+   std::lock_guard<std::mutex> guard(heap->trackers_lock);
    uint32_t index = 0;
-   while (index < controller->trackers_count) {
-      if (controller->trackers[index] == tracker) {
-         controller->trackers[index] = controller->trackers[controller->trackers_count - 1];
-         controller->trackers_count--;
+   while (index < heap->trackers_count) {
+      if (heap->trackers[index] == tracker) {
+         heap->trackers[index] = heap->trackers[heap->trackers_count - 1];
+         heap->trackers_count--;
       }
       else index++;
    }
 }
 
+void mem::RegisterReferenceTracker(ObjectReferenceTracker tracker) {
+   mem::RegisterReferenceTracker(controller, tracker);
+}
+
+void mem::UnregisterReferenceTracker(ObjectReferenceTracker tracker) {
+   mem::UnregisterReferenceTracker(controller, tracker);
+}
+
 void mem::CheckValidity() {
    std::lock_guard<std::mutex> guard(controller->contexts_lock);
    for (auto context = controller->contexts; context; context = context->next.registered) {
@@ -377,7 +678,8 @@ void mem::PrintInfos() {
    auto* cstats = new (alloca(sizeof(tObjectsStats) * cstats_length)) tObjectsStats[cstats_length];
    controller->central.ForeachObjectRegion(
       [&](ObjectRegion region) {
-         auto ctx = region->owner ? region->owner->context : 0;
+         auto owner = region->owner.load(std::memory_order_relaxed);
+         auto ctx = owner ? owner->context : 0;
          auto& stat = ctx ? cstats[ctx->id] : central_stat;
          stat.add(region);
          return true;
@@ -416,9 +718,24 @@ void mem::PrintInfos() {
    {
       auto space_stats = mem::GetMemoryStats();
       printf("| Technical:");
-      printf("\n|  - schema table : %s", sz2a(controller->schemas.GetTableUsedBytes()).c_str());
+      printf("\n|  - schema table : %s", sz2a(schemas->GetTableUsedBytes()).c_str());
       printf("\n|  - descriptors  : %s", sz2a(space_stats.descriptors_used_bytes).c_str());
       printf("\n|  - arenas_map  : %s", sz2a(space_stats.arenas_map_used_bytes).c_str());
+      if (space_stats.huge_pages_count) {
+         printf("\n|  - huge pages  : %zu x %s", space_stats.huge_pages_count, sz2a(space_stats.huge_page_size).c_str());
+      }
+      if (space_stats.purged_regions) {
+         printf("\n|  - purged  : %s (%zu regions)", sz2a(space_stats.purged_bytes).c_str(), space_stats.purged_regions);
+      }
+      if (space_stats.cold_regions) {
+         printf("\n|  - cold  : %s (%zu regions), hot: %s", sz2a(space_stats.cold_bytes).c_str(), space_stats.cold_regions, sz2a(space_stats.used_bytes).c_str());
+      }
+      if (space_stats.resident_bytes) {
+         printf("\n|  - resident  : %s", sz2a(space_stats.resident_bytes).c_str());
+      }
+      if (space_stats.leased_bytes) {
+         printf("\n|  - leased  : %s", sz2a(space_stats.leased_bytes).c_str());
+      }
       printf("\n|  - total  : %s", sz2a(space_stats.used_bytes).c_str());
       printf("\n");
    }
@@ -426,28 +743,40 @@ void mem::PrintInfos() {
 }
 
 void mem::InitializeHeap() {
+   static std::mutex lock;
+   if (mem::DefaultContext.load(std::memory_order_acquire)) return; // Set last, when the heap is ready
+   std::lock_guard<std::mutex> guard(lock);
    if (!controller) {
       mem::InitializeMemory();
+      mem::InitializeObjectPageMap();
 
-      controller = Descriptor::New<HeapDescriptor>();
+      schemas = Descriptor::New<SchemaArena>();
+      schemas->Initialize();
+      controller = Descriptor::New<HeapDescriptor>((RegionPools*)0);
       mem::Central = &controller->central;
 
       controller->default_context.AcquireContext();
-      mem::DefaultContext = &controller->default_context;
+      mem::DefaultContext.store(&controller->default_context, std::memory_order_release);
    }
 }
 
+mem::MemorySharedContext* mem::AcquireDefaultContext() {
+   mem::InitializeHeap();
+   return mem::DefaultContext.load(std::memory_order_acquire);
+}
+
 mem::MemoryCentralContext& mem::AcquireCentralContext() {
    mem::InitializeHeap();
    return controller->central;
 }
 
-mem::MemoryContext* mem::AcquireContext(bool isShared) {
+mem::MemoryContext* mem::HeapDescriptor::AcquireContext(bool isShared) {
    {
-      std::lock_guard<std::mutex> guard(controller->contexts_lock);
-      for (auto context = controller->contexts; context; context = context->next.registered) {
+      std::lock_guard<std::mutex> guard(this->contexts_lock);
+      for (auto context = this->contexts; context; context = context->next.registered) {
          if (!context->allocated) {
             context->allocated = true;
+            if (!this->pools) context->SetHomeNode(mem::GetCurrentNumaNode());
             return context;
          }
       }
@@ -456,16 +785,41 @@ mem::MemoryContext* mem::AcquireContext(bool isShared) {
       auto context = Descriptor::New<MemoryContext>();
       context->allocated = true;
       context->isShared = isShared;
-      mem::Central->InitiateContext(context);
+      context->numaNode = this->pools ? 0 : mem::GetCurrentNumaNode(); // Isolated pools are not bound to nodes
+      this->central.InitiateContext(context);
 
-      std::lock_guard<std::mutex> guard(controller->contexts_lock);
-      context->next.registered = controller->contexts;
-      context->id = controller->contexts_count++;
-      controller->contexts = context;
+      std::lock_guard<std::mutex> guard(this->contexts_lock);
+      context->next.registered = this->contexts;
+      context->id = this->contexts_count++;
+      this->contexts = context;
       return context;
    }
 }
 
+mem::MemoryContext* mem::AcquireContext(bool isShared) {
+   return controller->AcquireContext(isShared);
+}
+
+mem::MemoryContext* mem::AcquireContext(HeapDescriptor* heap, bool isShared) {
+   return heap->AcquireContext(isShared);
+}
+
+mem::HeapDescriptor* mem::CreateHeap(size_t maxPhysicalBytes) {
+   mem::InitializeHeap();
+   return Descriptor::New<HeapDescriptor>(mem::CreateRegionPools(maxPhysicalBytes));
+}
+
+void mem::DeleteHeap(HeapDescriptor* heap) {
+   if (heap == controller) {
+      throw "process heap cannot be deleted";
+   }
+   delete heap;
+}
+
+size_t mem::GetHeapUsedBytes(HeapDescriptor* heap) {
+   return heap->pools ? mem::GetRegionPoolsUsedBytes(heap->pools) : mem::GetUsedPhysicalBytes();
+}
+
 void mem::DisposeContext(MemoryContext* _context) {
    auto context = static_cast<mem::MemoryContext*>(_context);
    if (context->isShared) {
@@ -512,29 +866,39 @@ void mem::SetSecurityPaddingOption(uint32_t paddingSize) {
 }
 
 void mem::RescueStarvedConsumer(StarvedConsumerToken& token) {
+   auto heap = token.context ? token.context->central->heap : controller;
    {
-      std::lock_guard<std::mutex> guard(controller->notification_lock);
-      token.next = controller->starved_consumers;
-      controller->starved_consumers = &token;
+      std::lock_guard<std::mutex> guard(heap->notification_lock);
+      token.next = heap->starved_consumers;
+      heap->starved_consumers = &token;
    }
    std::unique_lock<std::mutex> guard(token.lock);
-   controller->NotifyWorker();
+   heap->NotifyWorker();
    token.signal.wait(guard);
 }
 
+void mem::NotifyHeapWorker() {
+   controller->NotifyWorker();
+}
+
+void mem::StartHeapWorker(HeapDescriptor* heap) {
+   if (heap) heap->StartWorker();
+}
+
 void mem::ScheduleContextRecovery(MemoryContext* context) {
    if (context->next.recovered == none<MemoryContext>()) {
+      auto heap = context->central->heap;
       {
-         std::lock_guard<std::mutex> guard(controller->notification_lock);
+         std::lock_guard<std::mutex> guard(heap->notification_lock);
          if (context->next.recovered == none<MemoryContext>()) {
-            context->next.recovered = controller->recovered_contexts;
-            controller->recovered_contexts = context;
+            context->next.recovered = heap->recovered_contexts;
+            heap->recovered_contexts = context;
          }
          else {
             return; // already scheduled
          }
       }
-      controller->NotifyWorker();
+      heap->NotifyWorker();
    }
 }
 
@@ -549,5 +913,17 @@ void mem::NotifyHeapIssue(tHeapIssue issue, address_t addr) {
    case tHeapIssue::FreeRetainedObject: {
       printf("! FreeRetainedObject at 0x%p\n", addr.as<void>());
    }break;
+   case tHeapIssue::PersistentSchemasOverflow: {
+      printf("! PersistentSchemasOverflow in heap 0x%p\n", addr.as<void>());
+   } break;
+   case tHeapIssue::PersistentSchemaTruncated: {
+      printf("! PersistentSchemaTruncated in heap 0x%p\n", addr.as<void>());
+   } break;
+   case tHeapIssue::PersistentArenaCorrupted: {
+      printf("! PersistentArenaCorrupted at 0x%p\n", addr.as<void>());
+   } break;
+   case tHeapIssue::SharedHeapInvalid: {
+      printf("! SharedHeapInvalid at 0x%p\n", addr.as<void>());
+   } break;
    }
 }
@@ -1,12 +1,14 @@
 #include <ins/memory/malloc.h>
 #include <ins/memory/controller.h>
+#include <ins/os/memory.h>
+#include <string.h>
+#include <stdio.h>
 
 using namespace ins;
 using namespace ins::mem;
 
 void* ins_malloc(size_t size) {
-   if (auto context = mem::CurrentContext) return context->AllocateUnmanaged(0, size);
-   else return mem::DefaultContext->AllocateUnmanaged(0, size);
+   return ins_malloc_inline(size);
 }
 
 void* ins_calloc(size_t count, size_t size) {
@@ -17,6 +19,22 @@ void ins_free(void* ptr) {
    ObjectLocation(ptr).Free(mem::CurrentContext);
 }
 
+void ins_free_sized(void* ptr, size_t size) {
+   auto context = mem::CurrentContext;
+   auto layoutID = getLayoutForSize(size + sizeof(sObjectHeader));
+   if (layoutID < cst::ObjectLayoutMax && context && !context->options.enableds) {
+      // Object located from its size layout, without map lookup
+      ObjectLocation location(ptr, false, layoutID);
+      if (location.HasLayout()) {
+         location.Free(context);
+         return;
+      }
+      // Size does not give the allocated layout (shrunk by realloc, allocated instrumented, ...)
+   }
+   // Large object, or object possibly beyond its size layout
+   ObjectLocation(ptr).Free(context);
+}
+
 size_t ins_msize(void* ptr, tp_ins_msize default_msize) {
    ObjectInfos infos(ptr);
    if (infos.object) {
@@ -51,8 +69,11 @@ void* ins_realloc(void* ptr, size_t size, tp_ins_realloc default_realloc) {
       }
       else {
          void* new_ptr = ins_malloc(size);
-         __try { memcpy(new_ptr, ptr, size); }
-         __except (1) {}
+         auto zone = os::GetMemoryZoneState(uintptr_t(ptr));
+         if (zone.state == os::tState::COMMITTED) {
+            size_t readable = zone.address + zone.size - uintptr_t(ptr);
+            memcpy(new_ptr, ptr, size < readable ? size : readable);
+         }
          printf("sat cannot realloc unkown buffer\n");
          return new_ptr;
       }
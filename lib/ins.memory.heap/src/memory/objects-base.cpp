@@ -4,10 +4,92 @@
 #include <ins/memory/objects-base.h>
 #include <ins/memory/contexts.h>
 #include <ins/memory/controller.h>
+#include <ins/memory/persistent.h>
+#include <ins/memory/shared.h>
+#include <ins/os/memory.h>
 
 using namespace ins;
 using namespace ins::mem;
 
+/**********************************************************************
+*
+*   Object Page Map
+*
+***********************************************************************/
+
+std::atomic_uint32_t* mem::ObjectPageMap = 0;
+
+namespace {
+   const size_t cPageLocksCount = 64;
+   std::mutex page_locks[cPageLocksCount]; // Page entry updates, for pages shared by regions
+}
+
+static void MapObjectPages(sObjectRegion* region, bool managed) {
+   auto map = mem::ObjectPageMap;
+   if (!map) return;
+   auto& infos = cst::ObjectLayoutInfos[region->layoutID];
+   ObjectPageEntry entry;
+   entry.layoutID = region->layoutID;
+   entry.region_sizeL2 = infos.region_sizeL2;
+   entry.region_objects = infos.region_objects;
+   entry.managed = managed;
+   entry.regions = 1;
+
+   auto first = uintptr_t(region) >> cst::PageSizeL2;
+   auto last = (uintptr_t(region) + (size_t(1) << infos.region_sizeL2) - 1) >> cst::PageSizeL2;
+   for (auto pageID = first; pageID <= last; pageID++) {
+      std::lock_guard<std::mutex> guard(page_locks[pageID % cPageLocksCount]);
+      ObjectPageEntry current = map[pageID].load(std::memory_order_relaxed);
+      if (current.regions == 0) {
+         current = entry;
+      }
+      else {
+         if (current.layoutID != entry.layoutID) current.mixed = 1;
+         current.regions++;
+      }
+      map[pageID].store(current.bits, std::memory_order_release);
+   }
+}
+
+static void UnmapObjectPages(sObjectRegion* region) {
+   auto map = mem::ObjectPageMap;
+   if (!map) return;
+   auto& infos = cst::ObjectLayoutInfos[region->layoutID];
+   auto first = uintptr_t(region) >> cst::PageSizeL2;
+   auto last = (uintptr_t(region) + (size_t(1) << infos.region_sizeL2) - 1) >> cst::PageSizeL2;
+   for (auto pageID = first; pageID <= last; pageID++) {
+      std::lock_guard<std::mutex> guard(page_locks[pageID % cPageLocksCount]);
+      ObjectPageEntry current = map[pageID].load(std::memory_order_relaxed);
+      _ASSERT(current.regions > 0);
+      current.regions--;
+      map[pageID].store(current.regions ? current.bits : 0, std::memory_order_release);
+   }
+}
+
+void mem::UnmapObjectArena(ArenaDescriptor* arena) {
+   auto map = mem::ObjectPageMap;
+   if (!map) return;
+   auto firstPage = size_t(arena->indice) << (cst::ArenaSizeL2 - cst::PageSizeL2);
+   for (size_t pageID = firstPage; pageID < firstPage + (cst::ArenaSize >> cst::PageSizeL2); pageID++) {
+      if (map[pageID].load(std::memory_order_relaxed)) {
+         map[pageID].store(0, std::memory_order_relaxed);
+      }
+   }
+}
+
+void mem::InitializeObjectPageMap() {
+   // Not available for spaces over 48 bits, the flat map would not fit in a sparse reservation
+   if (_INS_OBJECT_PAGE_MAP && cst::PagePerSpaceL2 <= 32 && !mem::ObjectPageMap) {
+      auto size = sizeof(ObjectPageEntry) << cst::PagePerSpaceL2;
+      mem::ObjectPageMap = (std::atomic_uint32_t*)os::AllocateSparseMemory(size);
+
+      // Map entries of an arena fit in a few huge pages, which saves TLB misses on random pointers
+      if (mem::ObjectPageMap && os::GetHugePageSize()) {
+         os::AdviseHugeMemory(uintptr_t(mem::ObjectPageMap), size);
+      }
+   }
+}
+
 /**********************************************************************
 *
 *   Object Region
@@ -17,22 +99,66 @@ using namespace ins::mem;
 sObjectRegion* sObjectRegion::New(bool managed, uint8_t layoutID, ObjectLocalContext* owner) {
    auto& infos = cst::ObjectLayoutInfos[layoutID];
 
-   auto ptr = managed
-      ? mem::AllocateManagedRegion(infos.region_sizeL2, infos.region_sizingID, owner->context)
-      : mem::AllocateUnmanagedRegion(infos.region_sizeL2, infos.region_sizingID, owner->context);
+   address_t ptr;
+   auto central = owner->context->central;
+   if (auto persistent = owner->context->persistent) {
+      ptr = persistent->AllocateRegion(managed, infos.region_sizeL2);
+   }
+   else if (auto shared = owner->context->shared) {
+      ptr = shared->AllocateRegion(managed, infos.region_sizeL2);
+   }
+   else if (auto pools = central->pools) {
+      ptr = managed
+         ? mem::AllocateManagedRegion(pools, infos.region_sizeL2, infos.region_sizingID, owner->context)
+         : mem::AllocateUnmanagedRegion(pools, infos.region_sizeL2, infos.region_sizingID, owner->context);
+   }
+   else {
+      ptr = managed
+         ? mem::AllocateManagedRegion(infos.region_sizeL2, infos.region_sizingID, owner->context, owner->context->numaNode)
+         : mem::AllocateUnmanagedRegion(infos.region_sizeL2, infos.region_sizingID, owner->context, owner->context->numaNode);
+   }
 
    auto region = new(ptr) sObjectRegion(layoutID, size_t(1) << infos.region_sizeL2, owner);
+   // Shared and persistent regions outlive this process central, and are never given to it
+   region->central = (owner->context->shared || owner->context->persistent) ? 0 : central;
    RegionLocation::New(region).layout() = layoutID;
+   if (!owner->context->persistent && !owner->context->shared) {
+      MapObjectPages(region, managed);
+   }
+
+   // Start paged regions with an active zone of one page, next pages are committed on demand
+   auto& sizing = mem::cst::RegionSizingInfos[infos.region_sizeL2].sizings[infos.region_sizingID];
+   if (sizing.committedPages > 1) {
+      if (mem::DecommitRegionPages(ptr + cst::PageSize, sizing.committedSize - cst::PageSize)) {
+         region->active_pages = 1;
+      }
+   }
    return region;
 }
 
 sObjectRegion* sObjectRegion::New(bool managed, uint8_t layoutID, size_t size, ObjectLocalContext* owner) {
+   if (owner->context->persistent) {
+      throw "Large objects are not supported by persistent heap";
+   }
+   if (owner->context->shared) {
+      throw "Large objects are not supported by shared heap";
+   }
 
-   void* ptr = managed
-      ? mem::AllocateManagedRegionEx(size + sizeof(sObjectRegion), owner->context)
-      : mem::AllocateUnmanagedRegionEx(size + sizeof(sObjectRegion), owner->context);
+   void* ptr;
+   auto central = owner->context->central;
+   if (auto pools = central->pools) {
+      ptr = managed
+         ? mem::AllocateManagedRegionEx(pools, size + sizeof(sObjectRegion), owner->context)
+         : mem::AllocateUnmanagedRegionEx(pools, size + sizeof(sObjectRegion), owner->context);
+   }
+   else {
+      ptr = managed
+         ? mem::AllocateManagedRegionEx(size + sizeof(sObjectRegion), owner->context, owner->context->numaNode)
+         : mem::AllocateUnmanagedRegionEx(size + sizeof(sObjectRegion), owner->context, owner->context->numaNode);
+   }
 
    auto region = new(ptr) sObjectRegion(layoutID, size, owner);
+   region->central = central;
    RegionLocation::New(ptr).layout() = layoutID;
    return region;
 }
@@ -47,13 +173,86 @@ void sObjectRegion::DisplayToConsole() {
    auto nobj = this->GetAvailablesCount();
    auto nobj_max = infos.region_objects;
    printf(" layout(%d) objects(%d/%d)", this->layoutID, int(nobj), int(nobj_max));
-   printf(" owner(%p)", this->owner);
+   printf(" owner(%p)", (void*)this->owner.load(std::memory_order_relaxed));
    if (this->IsDisposable()) printf(" [empty]");
 }
 
+void sObjectRegion::Promote() {
+   if (this->cold.load(std::memory_order_acquire) && mem::PromoteRegion(this)) {
+      this->cold.store(false, std::memory_order_release);
+   }
+}
+
+void sObjectRegion::GrowActiveZone(size_t requiredSize) {
+   auto& infos = cst::ObjectLayoutInfos[this->layoutID];
+   auto& sizing = mem::cst::RegionSizingInfos[infos.region_sizeL2].sizings[infos.region_sizingID];
+   _ASSERT(this->active_pages && requiredSize > this->GetActiveSize());
+   if (this->cold.load(std::memory_order_acquire)) return; // Cold region pages are all mapped from the cold storage
+
+   // Double the zone until it covers the required size
+   uint32_t requiredPages = (requiredSize + cst::PageMask) >> cst::PageSizeL2;
+   uint32_t pages = this->active_pages;
+   while (pages < requiredPages) pages <<= 1;
+   if (pages > sizing.committedPages) pages = sizing.committedPages;
+
+   auto activeSize = this->GetActiveSize();
+   if (!mem::CommitRegionPages(ObjectBytes(this) + activeSize, (size_t(pages) << cst::PageSizeL2) - activeSize, this->owner.load(std::memory_order_relaxed)->context)) {
+      throw mem::exception_missing_memory();
+   }
+   this->active_pages = pages;
+}
+
+void sObjectRegion::ShrinkActiveZone() {
+   auto& layout = cst::ObjectLayoutBase[this->layoutID];
+
+   // Compute the end of the last used object
+   size_t usedSize = cst::ObjectRegionHeadSize;
+   if (auto useds = this->GetAvailablesMap() ^ cst::ObjectLayoutMask[this->layoutID]) {
+      usedSize = layout.GetObjectOffset(bit::msb_64(useds) + 1);
+   }
+   uint32_t usedPages = (usedSize + cst::PageMask) >> cst::PageSizeL2;
+
+   // Shrink only when used pages fit in a quarter of the zone (avoid commit/decommit flip-flop)
+   if (usedPages * 4 > this->active_pages) return;
+   if (this->cold.load(std::memory_order_acquire)) return;
+   uint32_t pages = 1;
+   while (pages < usedPages) pages <<= 1;
+
+   auto pagesSize = size_t(pages) << cst::PageSizeL2;
+   if (mem::DecommitRegionPages(ObjectBytes(this) + pagesSize, this->GetActiveSize() - pagesSize)) {
+      this->active_pages = pages;
+   }
+}
+
 void sObjectRegion::Dispose() {
    auto& infos = cst::ObjectLayoutInfos[this->layoutID];
+   auto arena = RegionLocation::New(this).arena();
+   switch (arena->owner_kind) {
+   case ArenaOwnerKind::SharedHeap:
+      SharedHeap::DisposeRegion(this); // Any attached process may dispose it
+      return;
+   case ArenaOwnerKind::PersistentHeap:
+      static_cast<PersistentHeap*>(arena->owner)->DisposeRegion(this);
+      return;
+   default:
+      break;
+   }
+   this->Promote(); // Cold regions are released from the cold storage
+   if (this->layoutID < cst::ObjectLayoutMax) {
+      UnmapObjectPages(this);
+   }
+   if (this->active_pages) {
+      // Recommit the region tail, cached regions are fully committed
+      auto& sizing = mem::cst::RegionSizingInfos[infos.region_sizeL2].sizings[infos.region_sizingID];
+      auto activeSize = this->GetActiveSize();
+      if (activeSize < sizing.committedSize) {
+         mem::CommitRegionPages(ObjectBytes(this) + activeSize, sizing.committedSize - activeSize, 0);
+      }
+      this->active_pages = sizing.committedPages;
+   }
+   auto heap = this->central->heap;
    mem::DisposeRegion(this, infos.region_sizeL2, infos.region_sizingID);
+   mem::StartHeapWorker(heap); // Cached regions are purged by the worker
 }
 
 /**********************************************************************
@@ -190,27 +389,35 @@ bool mem::ObjectLocation::Free(MemoryContext* context) {
    }
 
    // Release object to region owner
-   auto owner = this->arena.managed ? &context->managed : &context->unmanaged;
-   if (region->owner == owner) {
-      if (region->availables == 0) {
-         owner->PushUsableRegion(region);
+   region->ReleaseObjects(object_bit, this->managed, context);
+   return true;
+}
+
+void sObjectRegion::ReleaseObjects(uint64_t objects_bits, bool managed, MemoryContext* context) {
+   auto local = managed ? &context->managed : &context->unmanaged;
+   auto owner = this->owner.load(std::memory_order_acquire);
+   if (owner == local) {
+      // Objects are released before the push, the region may leave the context (see PushUsableRegion)
+      auto full = this->availables == 0;
+      this->availables |= objects_bits;
+      this->UpdateActiveZone();
+      if (full) {
+         owner->PushUsableRegion(this);
       }
-      region->availables |= object_bit;
-      _ASSERT(region->availables != 0);
    }
    else {
-      if (region->notified_availables.fetch_or(object_bit) == 0) {
-         if (region->owner) {
-            auto count = region->owner->objects[region->layoutID].notifieds.Push(region);
-            if (count > 10) {
-               mem::ScheduleContextRecovery(region->owner->context);
+      if (this->notified_availables.fetch_or(objects_bits) == 0) {
+         if (owner) {
+            auto count = owner->objects[this->layoutID].notifieds.Push(this);
+            if (count > 10 && !owner->context->shared) {
+               // Note: a shared context may belong to another process, it collects its notifieds on allocation
+               mem::ScheduleContextRecovery(owner->context);
             }
          }
          else {
-            auto list = this->arena.managed ? mem::Central->managed.objects : mem::Central->unmanaged.objects;
-            list[region->layoutID].notifieds.Push(region);
+            auto list = managed ? this->central->managed.objects : this->central->unmanaged.objects;
+            list[this->layoutID].notifieds.Push(this);
          }
       }
    }
-   return true;
 }
@@ -1,19 +1,20 @@
 #include <ins/memory/objects-pool.h>
 #include <ins/memory/controller.h>
 #include <ins/timing.h>
+#include <string.h>
 
 using namespace ins;
 using namespace ins::mem;
 
 void sObjectRegion::NotifyAvailables(bool managed) {
-   if (this->owner) {
-      this->owner->objects[this->layoutID].notifieds.Push(this);
+   if (auto owner = this->owner.load(std::memory_order_acquire)) {
+      owner->objects[this->layoutID].notifieds.Push(this);
    }
    else if (managed) {
-      mem::Central->managed.objects[this->layoutID].notifieds.Push(this);
+      this->central->managed.objects[this->layoutID].notifieds.Push(this);
    }
    else {
-      mem::Central->unmanaged.objects[this->layoutID].notifieds.Push(this);
+      this->central->unmanaged.objects[this->layoutID].notifieds.Push(this);
    }
 }
 
@@ -53,6 +54,10 @@ void ObjectCentralContext::PushDisposableRegion(ObjectRegion region) {
 
 void ObjectCentralContext::PushUsableRegion(ObjectRegion region) {
    _ASSERT(region->next.used == none<sObjectRegion>());
+   if (mem::GetColdPromotion() == ColdPromotion::OnAccess) {
+      region->Promote();
+   }
+   region->idle_passes = 0;
    auto& usables = this->objects[region->layoutID].usables;
    if (usables.count > 1 && region->IsDisposable()) {
       this->PushDisposableRegion(region);
@@ -123,6 +128,12 @@ void ObjectLocalContext::Scavenge() {
    }
 }
 
+void ObjectLocalContext::ScavengeNotifieds() {
+   for (int layoutID = 0; layoutID < cst::ObjectLayoutCount; layoutID++) {
+      this->ScavengeNotifiedRegions(layoutID);
+   }
+}
+
 ObjectHeader ObjectLocalContext::AllocateObject(size_t size) {
    auto objectLayoutID = getLayoutForSize(size);
    _ASSERT(mem::cst::ObjectLayoutBase[objectLayoutID].object_multiplier == 0
@@ -194,6 +205,7 @@ uint32_t ObjectLocalContext::ScavengeNotifiedRegions(ObjectRegion region) {
          auto notified_bits = region->notified_availables.exchange(0, std::memory_order_seq_cst);
          _ASSERT(notified_bits != 0);
          region->availables |= notified_bits;
+         region->UpdateActiveZone();
          this->PushUsableRegion(region);
          collecteds++;
       }
@@ -218,6 +230,20 @@ void ObjectLocalContext::PushDisposableRegion(uint8_t layoutID, ObjectRegion reg
 void ObjectLocalContext::PushUsableRegion(ObjectRegion region) {
    auto& pool = this->objects[region->layoutID];
    if (region->next.used == none<sObjectRegion>()) {
+      if (mem::GetColdPromotion() == ColdPromotion::OnAccess) {
+         region->Promote();
+      }
+      region->idle_passes = 0;
+      if (mem::GetNumaNodeCount() > 1 && !this->context->persistent && !this->context->shared
+         && mem::GetRegionNumaNode(region) != this->context->numaNode) {
+         // Full region left on the previous home node (see SetHomeNode): given to central on its first release
+         auto& central = this->heap->objects[region->layoutID];
+         std::lock_guard<std::mutex> guard(central.lock);
+         region->owner.store(0, std::memory_order_release);
+         if (region->IsDisposable()) central.disposables.Push(region);
+         else central.usables.Push(region);
+         return;
+      }
       if (pool.usables.count > 1 && region->IsDisposable()) {
          this->PushDisposableRegion(region->layoutID, region);
       }
@@ -242,7 +268,6 @@ ObjectRegion ObjectLocalContext::PullUsableRegion(uint8_t layoutID) {
       }
    }
    else {
-      auto new_region = pool.disposables.Pop();
       if (auto new_region = pool.disposables.Pop()) {
          pool.usables.Push(new_region);
       }
@@ -258,7 +283,7 @@ ObjectRegion ObjectLocalContext::PullUsableRegion(uint8_t layoutID) {
    return pool.usables.current;
 }
 
-__declspec(noinline) ObjectHeader ObjectLocalContext::AcquireObject(uint8_t layoutID) {
+_INS_NOINLINE ObjectHeader ObjectLocalContext::AcquireObject(uint8_t layoutID) {
    auto& pool = this->objects[layoutID];
 
    // Acquire region with available objects
@@ -278,6 +303,12 @@ __declspec(noinline) ObjectHeader ObjectLocalContext::AcquireObject(uint8_t layo
    _ASSERT(index == cst::ObjectLayoutBase[layoutID].GetObjectIndex(offset));
    _ASSERT(index == cst::ObjectLayoutBase[layoutID].GetObjectIndex(offset + cst::ObjectLayoutBase[layoutID].object_multiplier - 1));
 
+   // Commit pages when object is beyond the active zone
+   auto end = offset + cst::ObjectLayoutBase[layoutID].object_multiplier;
+   if (region->active_pages && end > region->GetActiveSize()) {
+      region->GrowActiveZone(end);
+   }
+
    // Publish object as ready
    auto bit = uint64_t(1) << index;
    if ((region->availables ^= bit) == 0) {
@@ -287,3 +318,36 @@ __declspec(noinline) ObjectHeader ObjectLocalContext::AcquireObject(uint8_t layo
    _ASSERT(ObjectLocation(&obj[1]).IsAlive());
    return obj;
 }
+
+void ObjectLocalContext::AcquireObjects(uint8_t layoutID, size_t count, ObjectHeader* objects) {
+   auto& pool = this->objects[layoutID];
+   auto& layout = cst::ObjectLayoutBase[layoutID];
+   while (count) {
+      auto region = pool.usables.current;
+      if (!region) {
+         region = this->PullUsableRegion(layoutID);
+      }
+      _INS_ASSERT(region->layoutID == layoutID);
+      _INS_ASSERT(region->availables != 0);
+
+      // Claim the lowest available objects of the region at once
+      auto availables = region->availables;
+      size_t index = 0;
+      for (; count && availables; count--) {
+         index = bit::lsb_64(availables);
+         availables ^= uint64_t(1) << index;
+         *(objects++) = ObjectHeader(&ObjectBytes(region)[layout.GetObjectOffset(index)]);
+      }
+
+      // Commit pages up to the last claimed object
+      auto end = layout.GetObjectOffset(index) + layout.object_multiplier;
+      if (region->active_pages && end > region->GetActiveSize()) {
+         region->GrowActiveZone(end);
+      }
+
+      // Publish objects as ready
+      if ((region->availables = availables) == 0) {
+         pool.usables.Pop();
+      }
+   }
+}
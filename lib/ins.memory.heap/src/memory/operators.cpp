@@ -0,0 +1,80 @@
+#include <ins/memory/malloc.h>
+#include <ins/memory/structs.h>
+#include <new>
+
+#if _INS_MALLOC_OPERATORS
+
+/**********************************************************************
+*
+*   Global new/delete operators
+*
+*   Sized delete (C++14) frees without map lookup, the object layout
+*   is derived from the deleted size.
+*
+***********************************************************************/
+
+// Out of memory follows the standard: call the new handler until it fails, then throw std::bad_alloc
+static void* new_object(size_t size) {
+   for (;;) {
+      try {
+         if (auto ptr = ins_malloc(size)) return ptr;
+      }
+      catch (ins::mem::exception_missing_memory&) {
+      }
+      auto handler = std::get_new_handler();
+      if (!handler) throw std::bad_alloc();
+      handler();
+   }
+}
+
+void* operator new(size_t size) {
+   return new_object(size);
+}
+
+void* operator new[](size_t size) {
+   return new_object(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+   try {
+      return ins_malloc(size);
+   }
+   catch (...) {
+      return 0;
+   }
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+   try {
+      return ins_malloc(size);
+   }
+   catch (...) {
+      return 0;
+   }
+}
+
+void operator delete(void* ptr) noexcept {
+   if (ptr) ins_free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+   if (ptr) ins_free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+   if (ptr) ins_free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+   if (ptr) ins_free(ptr);
+}
+
+void operator delete(void* ptr, size_t size) noexcept {
+   if (ptr) ins_free_sized(ptr, size);
+}
+
+void operator delete[](void* ptr, size_t size) noexcept {
+   if (ptr) ins_free_sized(ptr, size);
+}
+
+#endif
@@ -0,0 +1,318 @@
+#include <ins/memory/persistent.h>
+#include <ins/memory/controller.h>
+#include <stdio.h>
+#include <string.h>
+
+using namespace ins;
+using namespace ins::mem;
+
+/**********************************************************************
+*
+*   Persistent Heap
+*
+***********************************************************************/
+
+mem::PersistentHeap::~PersistentHeap() {
+   if (this->context) {
+      this->SavePools();
+      this->header->closed = 1;
+      this->Flush();
+      this->context->~MemoryContext();
+      this->context = 0;
+
+      // Restore the view arenas in the arena map
+      auto baseID = uint32_t(this->header->base >> cst::ArenaSizeL2);
+      for (size_t slot = 1; slot < this->header->arenas_count; slot++) {
+         mem::ArenaMap.Set(uint32_t(baseID + slot), this->view_entries[slot]);
+      }
+   }
+   if (this->view) {
+      delete this->view;
+      this->view = 0;
+      this->header = 0;
+   }
+}
+
+void* mem::PersistentHeap::GetRoot(size_t index) {
+   _ASSERT(index < cMaxRoots);
+   return this->header->roots[index];
+}
+
+void mem::PersistentHeap::SetRoot(size_t index, void* ptr) {
+   _ASSERT(index < cMaxRoots);
+   _ASSERT(!ptr || (uintptr_t(ptr) - this->header->base) < this->view->GetExtendSizeLimit());
+   this->header->roots[index] = ptr;
+}
+
+bool mem::PersistentHeap::Flush() {
+   std::lock_guard<std::mutex> guard(this->lock);
+
+   // Save schema names, to rebind object schemas when reopened
+   auto count = mem::GetObjectSchemaCount();
+   if (count > cMaxSchemas) {
+      mem::NotifyHeapIssue(tHeapIssue::PersistentSchemasOverflow, this->header->base);
+      count = cMaxSchemas;
+   }
+   for (ObjectSchemaID id = 0; id < count; id++) {
+      auto infos = mem::GetObjectSchema(id)->infos;
+      auto name = infos ? infos->name() : "";
+      if (strlen(name) >= cSchemaNameSize) {
+         mem::NotifyHeapIssue(tHeapIssue::PersistentSchemaTruncated, this->header->base);
+      }
+      strncpy(this->header->schemas[id], name, cSchemaNameSize - 1);
+      this->header->schemas[id][cSchemaNameSize - 1] = 0;
+   }
+   this->header->schemas_count = count;
+   return this->view->Flush();
+}
+
+void* mem::PersistentHeap::AllocateMeta(size_t size) {
+   auto offset = bit::align<size_t>(this->header->meta_cursor, 64);
+   if (offset + size > cst::ArenaSize || !this->view->ExtendSize(offset + size)) {
+      throw mem::exception_missing_memory();
+   }
+   this->header->meta_cursor = offset + size;
+   return (void*)(this->header->base + offset);
+}
+
+ArenaDescriptor* mem::PersistentHeap::AcquireArena(bool managed, uint8_t sizeL2) {
+
+   // Find an arena of the region class with available regions
+   for (size_t slot = 1; slot < this->header->arenas_count; slot++) {
+      auto& entry = this->header->arenas[slot];
+      if (entry.managed == managed && entry.sizeL2 == sizeL2 && entry.descriptor->availables_count) {
+         return entry.descriptor;
+      }
+   }
+
+   // Create a new arena for the region class
+   auto slot = this->header->arenas_count;
+   if (slot >= this->arenas_limit) {
+      throw mem::exception_missing_memory();
+   }
+   auto arena = new(this->AllocateMeta(ArenaDescriptor::GetDescriptorSize(sizeL2))) ArenaDescriptor(sizeL2);
+   arena->InitializeFreeMaps();
+   arena->managed = managed;
+   arena->indice = uint32_t((this->header->base >> cst::ArenaSizeL2) + slot);
+
+   auto& entry = this->header->arenas[slot];
+   entry.descriptor = arena;
+   entry.sizeL2 = sizeL2;
+   entry.managed = managed;
+   this->header->arenas_count = slot + 1;
+   this->BindArena(slot);
+   return arena;
+}
+
+void mem::PersistentHeap::BindArena(size_t slot) {
+   auto arena = this->header->arenas[slot].descriptor;
+
+   // Reset process dependant fields
+   arena->owner = this;
+   arena->owner_kind = ArenaOwnerKind::PersistentHeap;
+   arena->numaNode = 0;
+   arena->hugePages = false;
+   arena->availables_listed = false;
+   arena->next = 0;
+
+   // Replace the view entry in the arena map
+   this->view_entries[slot] = mem::ArenaMap[arena->indice];
+   mem::ArenaMap.Set(arena->indice, ArenaEntry(arena));
+}
+
+address_t mem::PersistentHeap::AllocateRegion(bool managed, uint8_t sizeL2) {
+   std::lock_guard<std::mutex> guard(this->lock);
+   auto arena = this->AcquireArena(managed, sizeL2);
+   auto index = arena->FindFreeRegionRange(0);
+   _ASSERT(index >= 0);
+   arena->AcquireRegionRange(index, 1, RegionLayoutID::BufferRegion);
+
+   // Grow the file on the region end (file is sparse, unused arena parts are not stored)
+   auto address = arena->GetBase() + (uintptr_t(index) << sizeL2);
+   if (!this->view->ExtendSize(address + (size_t(1) << sizeL2) - this->header->base)) {
+      arena->ReleaseRegionRange(index, 1);
+      throw mem::exception_missing_memory();
+   }
+   return address;
+}
+
+void mem::PersistentHeap::DisposeRegion(address_t address) {
+   std::lock_guard<std::mutex> guard(this->lock);
+   auto loc = RegionLocation::New(address);
+   _ASSERT(loc.arena()->owner == this);
+   loc.arena()->ReleaseRegionRange(loc.index, 1);
+}
+
+bool mem::PersistentHeap::BindSchemas(ObjectSchemaID* remap) {
+   bool remapped = false;
+   for (ObjectSchemaID id = 0; id < this->header->schemas_count; id++) {
+      auto name = this->header->schemas[id];
+      remap[id] = id;
+      if (name[0]) {
+         auto schema = mem::FindObjectSchema(name);
+         if (!schema) schema = mem::ReserveObjectSchema(name);
+         remap[id] = mem::GetObjectSchemaID(schema);
+      }
+      if (remap[id] != id) remapped = true;
+   }
+   return remapped;
+}
+
+void mem::PersistentHeap::AttachRegions(ObjectSchemaID* remap) {
+   for (size_t slot = 1; slot < this->header->arenas_count; slot++) {
+      auto arena = this->header->arenas[slot].descriptor;
+      auto owner = arena->managed ? &this->context->managed : &this->context->unmanaged;
+      auto region_count = arena->GetRegionLimit();
+      for (size_t index = 0; index < region_count; index++) {
+
+         // Skip fully free region words
+         if ((index & 63) == 0 && arena->frees.word(index >> 6) == uint64_t(-1)) {
+            index += 63;
+            continue;
+         }
+         if (!arena->regions[index].IsObjectRegion()) continue;
+
+         // Rebind region to the heap context, with objects freed before close
+         auto region = ObjectRegion(arena->GetBase() + (index << arena->segmentation));
+         region->owner.store(owner, std::memory_order_relaxed);
+         region->next.used = none<sObjectRegion>();
+         region->next.notified = none<sObjectRegion>();
+         region->availables |= region->notified_availables.exchange(0);
+
+         // Rewrite schemas of used objects when ids have moved in this process
+         if (remap) {
+            auto useds = region->GetAvailablesMap() ^ cst::ObjectLayoutMask[region->layoutID];
+            while (useds) {
+               auto obj = region->GetObjectAt(bit::lsb_64(useds));
+               if (obj->schema_id < this->header->schemas_count) {
+                  obj->schema_id = remap[obj->schema_id];
+               }
+               useds &= useds - 1;
+            }
+         }
+         if (region->availables) {
+            owner->PushUsableRegion(region);
+         }
+      }
+   }
+}
+
+void mem::PersistentHeap::SavePools() {
+   ObjectLocalContext* locals[2] = { &this->context->unmanaged, &this->context->managed };
+   for (int managed = 0; managed < 2; managed++) {
+      locals[managed]->ScavengeNotifieds();
+      for (size_t layoutID = 0; layoutID < cst::ObjectLayoutCount; layoutID++) {
+         auto& pool = locals[managed]->objects[layoutID];
+         this->header->pools[managed][layoutID].usables = pool.usables;
+         this->header->pools[managed][layoutID].disposables = pool.disposables;
+      }
+   }
+}
+
+void mem::PersistentHeap::RestorePools() {
+   ObjectLocalContext* locals[2] = { &this->context->unmanaged, &this->context->managed };
+   for (int managed = 0; managed < 2; managed++) {
+      for (size_t layoutID = 0; layoutID < cst::ObjectLayoutCount; layoutID++) {
+         auto& pool = locals[managed]->objects[layoutID];
+         pool.usables = this->header->pools[managed][layoutID].usables;
+         pool.disposables = this->header->pools[managed][layoutID].disposables;
+      }
+   }
+}
+
+PersistentHeap* mem::PersistentHeap::Open(const char* filename, size_t sizeLimit, bool reset, uintptr_t base) {
+   mem::InitializeHeap();
+
+   // Read the base of an existing heap
+   bool existing = false;
+   if (!reset) {
+      if (auto file = fopen(filename, "rb")) {
+         struct { uint64_t magic; uint32_t version; uint32_t arenas_count; uintptr_t base; } head;
+         auto readed = fread(&head, 1, sizeof(head), file);
+         fclose(file);
+         if (readed == sizeof(head) && head.magic == cMagic && head.version == cVersion) {
+            base = head.base;
+            existing = true;
+         }
+         else if (readed != 0) {
+            return 0; // Not a heap file
+         }
+      }
+   }
+   _ASSERT((base & (cst::ArenaSize - 1)) == 0);
+
+   // Map the file at the heap base
+   auto view = DirectFileView::NewReadWrite(filename, sizeLimit, !existing, base);
+   if (!view) return 0;
+   auto heap = Descriptor::New<PersistentHeap>();
+   heap->view = view;
+   if (view->GetBase().ptr != base) {
+      delete heap;
+      return 0;
+   }
+   heap->arenas_limit = (view->GetExtendSizeLimit() + cst::ArenaSize - 1) >> cst::ArenaSizeL2;
+   if (heap->arenas_limit > cMaxArenas) heap->arenas_limit = cMaxArenas;
+   if (heap->arenas_limit < 2 || !view->ExtendSize(sizeof(sHeader))) {
+      delete heap;
+      return 0;
+   }
+   heap->header = (sHeader*)base;
+
+   auto header = heap->header;
+   if (existing) {
+      // Check the arenas are where the heap has left them
+      for (size_t slot = 1; slot < header->arenas_count; slot++) {
+         auto arena = header->arenas[slot].descriptor;
+         if (slot >= heap->arenas_limit || !arena || arena->indice != (base >> cst::ArenaSizeL2) + slot) {
+            mem::NotifyHeapIssue(tHeapIssue::PersistentArenaCorrupted, base + (slot << cst::ArenaSizeL2));
+            delete heap;
+            return 0;
+         }
+      }
+   }
+   else {
+      new((void*)header) sHeader();
+      header->magic = cMagic;
+      header->version = cVersion;
+      header->base = base;
+      header->arenas_count = 1;
+      header->meta_cursor = sizeof(sHeader);
+   }
+
+   // Create the heap context in arena 0 (not registered in the controller: its regions never leave it)
+   _ASSERT(cst::ObjectLayoutCount <= cMaxLayouts);
+   auto context = existing ? header->context : (MemoryContext*)heap->AllocateMeta(sizeof(MemoryContext));
+   new(context) MemoryContext();
+   context->allocated = true;
+   context->isShared = false;
+   context->numaNode = 0;
+   context->persistent = heap;
+   mem::Central->InitiateContext(context);
+   header->context = context;
+   heap->context = context;
+
+   // Rebind the stored arenas and schemas
+   for (size_t slot = 1; slot < header->arenas_count; slot++) {
+      heap->BindArena(slot);
+   }
+   ObjectSchemaID* remap = 0;
+   if (header->schemas_count) {
+      remap = new ObjectSchemaID[header->schemas_count];
+      if (!heap->BindSchemas(remap)) {
+         delete[] remap;
+         remap = 0;
+      }
+   }
+
+   // Rebind the regions: saved pools are valid only after a clean close,
+   // else (or when schemas have moved) regions are visited
+   if (header->closed && !remap) {
+      heap->RestorePools();
+   }
+   else {
+      heap->AttachRegions(remap);
+   }
+   header->closed = 0;
+   delete[] remap;
+   return heap;
+}
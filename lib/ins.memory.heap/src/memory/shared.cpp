@@ -0,0 +1,298 @@
+#include <ins/memory/shared.h>
+#include <ins/memory/controller.h>
+#include <string.h>
+#include <thread>
+#if !defined(_WIN32)
+#include <errno.h>
+#include <signal.h>
+#endif
+
+using namespace ins;
+using namespace ins::mem;
+
+/**********************************************************************
+*
+*   Shared Heap
+*
+***********************************************************************/
+
+#if defined(_WIN32)
+
+void mem::SharedHeap::sLock::Initialize() {
+   this->state = 0;
+}
+
+void mem::SharedHeap::sLock::lock() {
+   while (this->state.exchange(1, std::memory_order_acquire)) {
+      while (this->state.load(std::memory_order_relaxed)) std::this_thread::yield();
+   }
+}
+
+void mem::SharedHeap::sLock::unlock() {
+   this->state.store(0, std::memory_order_release);
+}
+
+static bool IsProcessAlive(uint32_t pid) {
+   return true; // Slots are reclaimed on detach only
+}
+
+#else
+
+void mem::SharedHeap::sLock::Initialize() {
+   pthread_mutexattr_t attr;
+   pthread_mutexattr_init(&attr);
+   pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+   pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+   pthread_mutex_init(&this->mutex, &attr);
+   pthread_mutexattr_destroy(&attr);
+}
+
+void mem::SharedHeap::sLock::lock() {
+   if (pthread_mutex_lock(&this->mutex) == EOWNERDEAD) {
+      // Holder process died in a region allocation or release: the lock is recovered,
+      // a region range it was updating may stay acquired
+      pthread_mutex_consistent(&this->mutex);
+   }
+}
+
+void mem::SharedHeap::sLock::unlock() {
+   pthread_mutex_unlock(&this->mutex);
+}
+
+static bool IsProcessAlive(uint32_t pid) {
+   return kill(pid_t(pid), 0) == 0 || errno != ESRCH;
+}
+
+#endif
+
+mem::SharedHeap::~SharedHeap() {
+   if (this->header) {
+      this->DetachContext();
+
+      // Restore the view arenas in the arena map
+      for (size_t slot = 1; slot < this->header->arenas_count; slot++) {
+         auto arena = this->header->arenas[slot].descriptor;
+         mem::ArenaMap.Set(arena->indice, this->view_entries[slot]);
+      }
+   }
+   if (this->view) {
+      delete this->view;
+      this->view = 0;
+      this->header = 0;
+   }
+}
+
+MemoryContext* mem::SharedHeap::GetContext() {
+   if (this->pid != os::GetCurrentProcessID()) {
+      this->AttachContext();
+   }
+   return this->context;
+}
+
+void* mem::SharedHeap::GetRoot(size_t index) {
+   _ASSERT(index < cMaxRoots);
+   return this->header->roots[index].load(std::memory_order_acquire);
+}
+
+void mem::SharedHeap::SetRoot(size_t index, void* ptr) {
+   _ASSERT(index < cMaxRoots);
+   this->header->roots[index].store(ptr, std::memory_order_release);
+}
+
+void* mem::SharedHeap::ExchangeRoot(size_t index, void* ptr) {
+   _ASSERT(index < cMaxRoots);
+   return this->header->roots[index].exchange(ptr, std::memory_order_acq_rel);
+}
+
+void* mem::SharedHeap::AllocateMeta(size_t size) {
+   auto offset = bit::align<size_t>(this->header->meta_cursor, 64);
+   if (offset + size > cst::ArenaSize) {
+      throw mem::exception_missing_memory();
+   }
+   this->header->meta_cursor = offset + size;
+   return (void*)(this->header->base + offset);
+}
+
+void mem::SharedHeap::BindArena(size_t slot) {
+   auto arena = this->header->arenas[slot].descriptor;
+   this->view_entries[slot] = mem::ArenaMap[arena->indice];
+   mem::ArenaMap.Set(arena->indice, ArenaEntry(arena));
+}
+
+address_t mem::SharedHeap::AllocateRegion(bool managed, uint8_t sizeL2) {
+   auto header = this->header;
+   auto size = size_t(1) << sizeL2;
+   auto slot = header->class_slots[managed][sizeL2];
+   _ASSERT(slot != 0);
+   if (header->used_bytes.fetch_add(size) + size > header->size_limit) {
+      header->used_bytes.fetch_sub(size);
+      throw mem::exception_missing_memory();
+   }
+   std::lock_guard<sLock> guard(header->lock);
+   auto arena = header->arenas[slot].descriptor;
+   auto index = arena->availables_count ? arena->FindFreeRegionRange(0) : -1;
+   if (index < 0) {
+      header->used_bytes.fetch_sub(size);
+      throw mem::exception_missing_memory();
+   }
+   arena->AcquireRegionRange(index, 1, RegionLayoutID::BufferRegion);
+   return arena->GetBase() + (uintptr_t(index) << sizeL2);
+}
+
+void mem::SharedHeap::DisposeRegion(address_t address) {
+   auto loc = RegionLocation::New(address);
+   _ASSERT(loc.arena()->owner_kind == ArenaOwnerKind::SharedHeap);
+   auto header = static_cast<sHeader*>(loc.arena()->owner);
+   {
+      std::lock_guard<sLock> guard(header->lock);
+      loc.arena()->ReleaseRegionRange(loc.index, 1);
+   }
+   header->used_bytes.fetch_sub(size_t(1) << loc.arena()->segmentation);
+}
+
+void mem::SharedHeap::AttachContext() {
+   auto header = this->header;
+   auto pid = os::GetCurrentProcessID();
+
+   // Take a free context slot, a previously used context is adopted with its regions
+   sContextSlot* slot = 0;
+   {
+      std::lock_guard<sLock> guard(header->lock);
+      for (size_t i = 0; i < cMaxContexts && !slot; i++) {
+         if (header->contexts[i].pid.load() == 0) {
+            slot = &header->contexts[i];
+            slot->pid = pid;
+         }
+      }
+      for (size_t i = 0; i < cMaxContexts && !slot; i++) {
+         // Context of a dead process, which did not detach
+         auto slotPid = header->contexts[i].pid.load();
+         if (slotPid != pid && !IsProcessAlive(slotPid)) {
+            slot = &header->contexts[i];
+            slot->pid = pid;
+         }
+      }
+      if (slot && !slot->context) {
+         slot->context = (MemoryContext*)this->AllocateMeta(sizeof(MemoryContext));
+      }
+   }
+   if (!slot) {
+      throw mem::exception_missing_memory(); // Too many attached processes
+   }
+
+   // Rebuild the context in this process, its pools and notified regions are kept
+   typedef decltype(ObjectLocalContext::objects) tPools;
+   auto context = slot->context;
+   auto pools = new tPools[2];
+   memcpy(&pools[0], &context->unmanaged.objects, sizeof(tPools));
+   memcpy(&pools[1], &context->managed.objects, sizeof(tPools));
+   new(context) MemoryContext();
+   memcpy(&context->unmanaged.objects, &pools[0], sizeof(tPools));
+   memcpy(&context->managed.objects, &pools[1], sizeof(tPools));
+   delete[] pools;
+   context->allocated = true;
+   context->isShared = false;
+   context->numaNode = 0;
+   context->persistent = 0;
+   context->shared = this;
+   mem::Central->InitiateContext(context);
+   this->context = context;
+   this->pid = pid;
+}
+
+void mem::SharedHeap::DetachContext() {
+   if (this->pid != os::GetCurrentProcessID() || !this->context) return;
+   for (size_t i = 0; i < cMaxContexts; i++) {
+      auto& slot = this->header->contexts[i];
+      if (slot.context == this->context) {
+         slot.pid = 0;
+      }
+   }
+   this->context = 0;
+   this->pid = 0;
+}
+
+SharedHeap* mem::SharedHeap::Create(const char* name, size_t sizeLimit, uintptr_t base) {
+   mem::InitializeHeap();
+   _ASSERT((base & (cst::ArenaSize - 1)) == 0);
+
+   // List the region classes of the object layouts
+   uint8_t classes[cst::ArenaSizeL2 + 1] = { 0 };
+   size_t classesCount = 0;
+   for (size_t layoutID = 0; layoutID < cst::ObjectLayoutMax; layoutID++) {
+      auto sizeL2 = cst::ObjectLayoutInfos[layoutID].region_sizeL2;
+      if (!classes[sizeL2]) {
+         classes[sizeL2] = 1;
+         classesCount++;
+      }
+   }
+   auto arenasCount = 1 + 2 * classesCount;
+   _ASSERT(arenasCount <= cMaxArenas);
+
+   // Map the shared memory at the heap base, on all its arenas
+   auto view = DirectFileView::NewShared(name, arenasCount << cst::ArenaSizeL2, true, base);
+   if (!view) return 0;
+   auto heap = Descriptor::New<SharedHeap>();
+   heap->view = view;
+   if (view->GetBase().ptr != base) {
+      delete heap;
+      return 0;
+   }
+   heap->header = (sHeader*)base;
+
+   auto header = heap->header;
+   new((void*)header) sHeader();
+   header->lock.Initialize();
+   header->magic = cMagic;
+   header->version = cVersion;
+   header->base = base;
+   header->meta_cursor = sizeof(sHeader);
+   header->size_limit = sizeLimit ? sizeLimit : size_t(-1);
+   header->used_bytes = 0;
+   header->arenas_count = 1;
+
+   // Create the arenas of all region classes
+   for (int managed = 0; managed < 2; managed++) {
+      for (uint8_t sizeL2 = 0; sizeL2 <= cst::ArenaSizeL2; sizeL2++) {
+         if (!classes[sizeL2]) continue;
+         auto slot = header->arenas_count++;
+         auto arena = new(heap->AllocateMeta(ArenaDescriptor::GetDescriptorSize(sizeL2))) ArenaDescriptor(sizeL2);
+         arena->InitializeFreeMaps();
+         arena->managed = managed;
+         arena->indice = uint32_t((base >> cst::ArenaSizeL2) + slot);
+         arena->owner = header;
+         arena->owner_kind = ArenaOwnerKind::SharedHeap;
+         arena->numaNode = 0;
+         header->arenas[slot].descriptor = arena;
+         header->arenas[slot].sizeL2 = sizeL2;
+         header->arenas[slot].managed = managed;
+         header->class_slots[managed][sizeL2] = uint8_t(slot);
+         heap->BindArena(slot);
+      }
+   }
+   return heap;
+}
+
+SharedHeap* mem::SharedHeap::Open(const char* name, uintptr_t base) {
+   mem::InitializeHeap();
+   auto view = DirectFileView::NewShared(name, 0, false, base);
+   if (!view) return 0;
+   auto heap = Descriptor::New<SharedHeap>();
+   heap->view = view;
+   auto header = (sHeader*)base;
+   if (view->GetBase().ptr != base || view->GetSize() < sizeof(sHeader) ||
+      header->magic != cMagic || header->version != cVersion || header->base != base) {
+      mem::NotifyHeapIssue(tHeapIssue::SharedHeapInvalid, base);
+      delete heap;
+      return 0;
+   }
+   heap->header = header;
+   for (size_t slot = 1; slot < header->arenas_count; slot++) {
+      heap->BindArena(slot);
+   }
+   return heap;
+}
+
+bool mem::SharedHeap::Remove(const char* name) {
+   return DirectFileView::RemoveShared(name);
+}
@@ -1,13 +1,17 @@
 #include <ins/timing.h>
 #include <chrono>
 
-static uint64_t timeOrigin = _Query_perf_counter();
-static uint64_t timeFrequency = _Query_perf_frequency();
+static uint64_t QueryPerfCounter() {
+   return uint64_t(std::chrono::steady_clock::now().time_since_epoch().count());
+}
+
+static uint64_t timeOrigin = QueryPerfCounter();
+static uint64_t timeFrequency = uint64_t(std::chrono::steady_clock::period::den / std::chrono::steady_clock::period::num);
 
 namespace ins::timing {
 
    uint64_t getCurrentTimestamp() {
-      return _Query_perf_counter() - timeOrigin;
+      return QueryPerfCounter() - timeOrigin;
    }
    uint64_t getTimestamp(double time) {
       return uint64_t(time * double(timeFrequency));
@@ -22,20 +26,20 @@ namespace ins::timing {
    }
 
    Chrono::Chrono()
-      : t0(_Query_perf_counter()) {
+      : t0(QueryPerfCounter()) {
    }
 
    void Chrono::Start() {
-      this->t0 = _Query_perf_counter();
+      this->t0 = QueryPerfCounter();
    }
 
    double Chrono::GetDiffDouble(PRECISION unit) {
-      __int64 dt = _Query_perf_counter() - this->t0;
+      int64_t dt = QueryPerfCounter() - this->t0;
       return (double)(dt * unit) / (double)timeFrequency;
    }
 
    float Chrono::GetDiffFloat(PRECISION unit) {
-      __int64 dt = _Query_perf_counter() - this->t0;
+      int64_t dt = QueryPerfCounter() - this->t0;
       return (float)((double)(dt * unit) / (double)timeFrequency);
    }
 
@@ -44,7 +48,7 @@ namespace ins::timing {
    }
 
    uint64_t Chrono::GetNumCycleClock() {
-      return _Query_perf_counter() - this->t0;
+      return QueryPerfCounter() - this->t0;
    }
 
    uint64_t Chrono::GetFreq() {
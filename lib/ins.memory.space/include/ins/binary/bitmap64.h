@@ -88,71 +88,71 @@ namespace ins::bit {
       template <AcquireMode mode>
       intptr_t acquire(size_t sizeL2);
 
-      // acquire <FirstFit>: Fit selection map based on the acquisition mode
-      template <>
-      intptr_t acquire<AcquireMode::FirstFit>(size_t sizeL2) {
-         if (uint64_t selectionMap = this->computeAvailabiltyMap(sizeL2)) {
-            return this->acquireFromSelectionMap(selectionMap, size_t(1) << sizeL2);
-         }
-         else {
-            if (this->spareSizeL2 >= sizeL2) this->spareSizeL2 = sizeL2 - 1;
-            return -1;
-         }
+      void release(int index, size_t sizeL2) {
+         size_t size = size_t(1) << sizeL2;
+         uint64_t sizeMask = (uint64_t(1) << size) - 1; // note: cpu bug with size of 64
+         this->usebits &= ~(sizeMask << index);
       }
+      void print();
+   };
 
-      // acquire <BuddyFit>: Prune upper selection map bits to priorize splitted span
-      template <>
-      intptr_t acquire<AcquireMode::BuddyFit>(size_t sizeL2) {
-         if (uint64_t selectionMap = this->computeAvailabiltyMap(sizeL2)) {
-            auto size = size_t(1) << sizeL2;
-            if (uint64_t upperMap = (selectionMap & (selectionMap >> size)) & cAlignedSelectionMask[sizeL2 + 1]) {
-               uint64_t notBuddyMap = upperMap | (upperMap << size); // Exclude upper full span
-               selectionMap = selectionMap ^ notBuddyMap;
-               if (!selectionMap) selectionMap = upperMap;
-            }
-            return this->acquireFromSelectionMap(selectionMap, size_t(1) << sizeL2);
-         }
-         else {
-            if (this->spareSizeL2 >= sizeL2) this->spareSizeL2 = sizeL2 - 1;
-            return -1;
+   // acquire <FirstFit>: Fit selection map based on the acquisition mode
+   template <>
+   inline intptr_t AlignedHierarchyBitmap64::acquire<AcquireMode::FirstFit>(size_t sizeL2) {
+      if (uint64_t selectionMap = this->computeAvailabiltyMap(sizeL2)) {
+         return this->acquireFromSelectionMap(selectionMap, size_t(1) << sizeL2);
+      }
+      else {
+         if (this->spareSizeL2 >= sizeL2) this->spareSizeL2 = sizeL2 - 1;
+         return -1;
+      }
+   }
+
+   // acquire <BuddyFit>: Prune upper selection map bits to priorize splitted span
+   template <>
+   inline intptr_t AlignedHierarchyBitmap64::acquire<AcquireMode::BuddyFit>(size_t sizeL2) {
+      if (uint64_t selectionMap = this->computeAvailabiltyMap(sizeL2)) {
+         auto size = size_t(1) << sizeL2;
+         if (uint64_t upperMap = (selectionMap & (selectionMap >> size)) & cAlignedSelectionMask[sizeL2 + 1]) {
+            uint64_t notBuddyMap = upperMap | (upperMap << size); // Exclude upper full span
+            selectionMap = selectionMap ^ notBuddyMap;
+            if (!selectionMap) selectionMap = upperMap;
          }
+         return this->acquireFromSelectionMap(selectionMap, size_t(1) << sizeL2);
       }
+      else {
+         if (this->spareSizeL2 >= sizeL2) this->spareSizeL2 = sizeL2 - 1;
+         return -1;
+      }
+   }
 
-      // acquire <BestFit>: Prune upper selection map bits to priorize smallest span splitting
-      template <>
-      intptr_t acquire<AcquireMode::BestFit>(size_t sizeL2) {
-         if (uint64_t selectionMap = this->computeAvailabiltyMap(sizeL2)) {
-            auto size = size_t(1) << sizeL2;
-            size_t upperShift = size;
-            for (;;) {
-               sizeL2++;
-               if (uint64_t upperMap = (selectionMap & (selectionMap >> upperShift)) & cAlignedSelectionMask[sizeL2]) {
-                  uint64_t notBuddyMap = upperMap | (upperMap << upperShift);
-                  if (uint64_t fittedMap = selectionMap ^ notBuddyMap) {
-                     return this->acquireFromSelectionMap(fittedMap, size);
-                  }
-                  selectionMap = upperMap;
-                  upperShift <<= 1;
-               }
-               else {
-                  if (this->spareSizeL2 >= sizeL2) this->spareSizeL2 = sizeL2 - 1;
-                  return this->acquireFromSelectionMap(selectionMap, size);
+   // acquire <BestFit>: Prune upper selection map bits to priorize smallest span splitting
+   template <>
+   inline intptr_t AlignedHierarchyBitmap64::acquire<AcquireMode::BestFit>(size_t sizeL2) {
+      if (uint64_t selectionMap = this->computeAvailabiltyMap(sizeL2)) {
+         auto size = size_t(1) << sizeL2;
+         size_t upperShift = size;
+         for (;;) {
+            sizeL2++;
+            if (uint64_t upperMap = (selectionMap & (selectionMap >> upperShift)) & cAlignedSelectionMask[sizeL2]) {
+               uint64_t notBuddyMap = upperMap | (upperMap << upperShift);
+               if (uint64_t fittedMap = selectionMap ^ notBuddyMap) {
+                  return this->acquireFromSelectionMap(fittedMap, size);
                }
+               selectionMap = upperMap;
+               upperShift <<= 1;
+            }
+            else {
+               if (this->spareSizeL2 >= sizeL2) this->spareSizeL2 = sizeL2 - 1;
+               return this->acquireFromSelectionMap(selectionMap, size);
             }
-         }
-         else {
-            if (this->spareSizeL2 >= sizeL2) this->spareSizeL2 = sizeL2 - 1;
-            return -1;
          }
       }
-
-      void release(int index, size_t sizeL2) {
-         size_t size = size_t(1) << sizeL2;
-         uint64_t sizeMask = (uint64_t(1) << size) - 1; // note: cpu bug with size of 64
-         this->usebits &= ~(sizeMask << index);
+      else {
+         if (this->spareSizeL2 >= sizeL2) this->spareSizeL2 = sizeL2 - 1;
+         return -1;
       }
-      void print();
-   };
+   }
 
    struct BinaryHierarchyBitmap64 : Bitmap64 {
 
@@ -220,18 +220,6 @@ namespace ins::bit {
       template <AcquireMode mode>
       intptr_t acquire(size_t sizeL2);
 
-      // acquire <FirstFit>: Fit selection map based on the acquisition mode
-      template <>
-      intptr_t acquire<AcquireMode::FirstFit>(size_t sizeL2) {
-         if (uint64_t availabilityMap = this->computeAvailabiltyMap(sizeL2)) {
-            uint64_t selectionMap = availabilityMap & ~(availabilityMap << 1);
-            return this->acquireFromSelectionMap(selectionMap, size_t(1) << sizeL2);
-         }
-         else {
-            return -1;
-         }
-      }
-
       intptr_t adjustAvailabilityMap(size_t sizeL2, uint64_t availabilityMap) {
          uint64_t selectionMap = availabilityMap & ~(availabilityMap << 1);
 #if 0
@@ -273,21 +261,6 @@ namespace ins::bit {
 #endif
       }
 
-      // acquire <BestFit>: Prune upper selection map bits to priorize smallest span splitting
-      template <>
-      intptr_t acquire<AcquireMode::BestFit>(size_t sizeL2) {
-         if (this->usebits == 0) {
-            return this->acquireFromSelectionMap(1, size_t(1) << sizeL2);
-         }
-         else if (uint64_t availabilityMap = this->computeAvailabiltyMap(sizeL2)) {
-            uint64_t selectionMap = this->adjustAvailabilityMap(sizeL2, availabilityMap);
-            return this->acquireFromSelectionMap(selectionMap, size_t(1) << sizeL2);
-         }
-         else {
-            return -1;
-         }
-      }
-
       void release(int index, size_t sizeL2) {
          size_t size = size_t(1) << sizeL2;
          uint64_t sizeMask = (uint64_t(1) << size) - 1; // note: cpu bug with size of 64
@@ -296,6 +269,33 @@ namespace ins::bit {
       void print();
    };
 
+   // acquire <FirstFit>: Fit selection map based on the acquisition mode
+   template <>
+   inline intptr_t BinaryHierarchyBitmap64::acquire<AcquireMode::FirstFit>(size_t sizeL2) {
+      if (uint64_t availabilityMap = this->computeAvailabiltyMap(sizeL2)) {
+         uint64_t selectionMap = availabilityMap & ~(availabilityMap << 1);
+         return this->acquireFromSelectionMap(selectionMap, size_t(1) << sizeL2);
+      }
+      else {
+         return -1;
+      }
+   }
+
+   // acquire <BestFit>: Prune upper selection map bits to priorize smallest span splitting
+   template <>
+   inline intptr_t BinaryHierarchyBitmap64::acquire<AcquireMode::BestFit>(size_t sizeL2) {
+      if (this->usebits == 0) {
+         return this->acquireFromSelectionMap(1, size_t(1) << sizeL2);
+      }
+      else if (uint64_t availabilityMap = this->computeAvailabiltyMap(sizeL2)) {
+         uint64_t selectionMap = this->adjustAvailabilityMap(sizeL2, availabilityMap);
+         return this->acquireFromSelectionMap(selectionMap, size_t(1) << sizeL2);
+      }
+      else {
+         return -1;
+      }
+   }
+
    struct UniformBitmap64 : Bitmap64 {
       int acquire() {
          if (this->usebits != -1) return -1;
@@ -308,4 +308,158 @@ namespace ins::bit {
       }
    };
 
+   // MultiLevelBitmap64: bitmap of any length over external words, with one summary bit
+   // per non empty word at each upper level (first set bit is found with one lsb per level)
+   struct MultiLevelBitmap64 {
+      static const int cMaxLevels = 6;
+      uint64_t* words = 0;
+      uint8_t levels = 0;
+      uint32_t levelOffsets[cMaxLevels] = { 0 };
+      uint32_t levelCounts[cMaxLevels] = { 0 };
+
+      static size_t GetWordCount(size_t length) {
+         size_t count = 0;
+         do {
+            length = (length + 63) >> 6;
+            count += length;
+         } while (length > 1);
+         return count;
+      }
+      void Initialize(uint64_t* words, size_t length, bool cleared = false) {
+         this->words = words;
+         this->levels = 0;
+         size_t offset = 0;
+         do {
+            length = (length + 63) >> 6;
+            this->levelOffsets[this->levels] = uint32_t(offset);
+            this->levelCounts[this->levels] = uint32_t(length);
+            this->levels++;
+            offset += length;
+         } while (length > 1);
+         if (!cleared) {
+            for (size_t i = 0; i < offset; i++) words[i] = 0;
+         }
+      }
+      uint64_t* level(int index) {
+         return &this->words[this->levelOffsets[index]];
+      }
+      uint64_t word(size_t index) {
+         return this->words[index];
+      }
+      bool get(size_t index) {
+         return (this->words[index >> 6] >> (index & 63)) & 1;
+      }
+      void set(size_t index) {
+         for (int l = 0; l < this->levels; l++) {
+            uint64_t& w = this->level(l)[index >> 6];
+            uint64_t prev = w;
+            w = prev | (uint64_t(1) << (index & 63));
+            if (prev) break;
+            index >>= 6;
+         }
+      }
+      void reset(size_t index) {
+         for (int l = 0; l < this->levels; l++) {
+            uint64_t& w = this->level(l)[index >> 6];
+            w &= ~(uint64_t(1) << (index & 63));
+            if (w) break;
+            index >>= 6;
+         }
+      }
+      void fill(size_t length) {
+         this->fill(0, length);
+      }
+      void fill(size_t from, size_t to) {
+         // Set the bits [from, to), by words on each level
+         if (from >= to) return;
+         for (int l = 0; l < this->levels; l++) {
+            auto words = this->level(l);
+            size_t first = from >> 6, last = (to - 1) >> 6;
+            uint64_t firstMask = uint64_t(-1) << (from & 63);
+            uint64_t lastMask = uint64_t(-1) >> (63 - ((to - 1) & 63));
+            if (first == last) {
+               words[first] |= firstMask & lastMask;
+            }
+            else {
+               words[first] |= firstMask;
+               for (size_t i = first + 1; i < last; i++) words[i] = uint64_t(-1);
+               words[last] |= lastMask;
+            }
+            from = first;
+            to = last + 1;
+         }
+      }
+
+      // findWord: first non empty word of index >= from, or -1
+      intptr_t findWord(size_t from) {
+         if (this->levels == 1) {
+            return (from == 0 && this->words[0]) ? 0 : -1;
+         }
+         size_t pos = from;
+         int l = 1;
+         for (;;) {
+            if ((pos >> 6) >= this->levelCounts[l]) return -1;
+            uint64_t w = this->level(l)[pos >> 6] & (uint64_t(-1) << (pos & 63));
+            if (w) {
+               pos = (pos & ~size_t(63)) | lsb_64(w);
+               break;
+            }
+            if (++l >= this->levels) return -1;
+            pos = (pos >> 6) + 1;
+         }
+         while (--l > 0) {
+            pos = (pos << 6) | lsb_64(this->level(l)[pos]);
+         }
+         return pos;
+      }
+   };
+
+   // MultiLevelRunsBitmap64: multi level bitmap with, for each aligned run size 2^k (k = 1..6), a summary
+   // bitmap of one bit per word holding such a run of set bits, so a run is found without visiting
+   // the words lacking it. Summaries are kept by fill, set/reset callers refresh them with updateRuns.
+   struct MultiLevelRunsBitmap64 : MultiLevelBitmap64 {
+      static const int cRunSizes = 6;
+      MultiLevelBitmap64 runs[cRunSizes]; // runs[k - 1]: words holding an aligned run of 2^k bits
+
+      static size_t GetWordCount(size_t length) {
+         return MultiLevelBitmap64::GetWordCount(length) + cRunSizes * MultiLevelBitmap64::GetWordCount((length + 63) >> 6);
+      }
+      void Initialize(uint64_t* words, size_t length, bool cleared = false) {
+         this->MultiLevelBitmap64::Initialize(words, length, cleared);
+         auto runsWords = &words[MultiLevelBitmap64::GetWordCount(length)];
+         auto runsLength = (length + 63) >> 6;
+         for (int k = 0; k < cRunSizes; k++) {
+            this->runs[k].Initialize(&runsWords[k * MultiLevelBitmap64::GetWordCount(runsLength)], runsLength, cleared);
+         }
+      }
+      void fill(size_t from, size_t to) {
+         // Full words hold all the runs, partial edge words are evaluated
+         if (from >= to) return;
+         this->MultiLevelBitmap64::fill(from, to);
+         size_t first = from >> 6, last = (to - 1) >> 6;
+         for (int k = 0; k < cRunSizes; k++) {
+            this->runs[k].fill(first + 1, last);
+         }
+         this->updateRuns(first);
+         this->updateRuns(last);
+      }
+      void updateRuns(size_t wordIndex) {
+         uint64_t spreadMap = this->word(wordIndex);
+         for (int k = 1; k <= cRunSizes; k++) {
+            spreadMap &= spreadMap >> (1 << (k - 1));
+            if (spreadMap & AlignedHierarchyBitmap64::cAlignedSelectionMask[k]) this->runs[k - 1].set(wordIndex);
+            else this->runs[k - 1].reset(wordIndex);
+         }
+      }
+
+      // findRunWord: first word holding an aligned run of 2^sizeL2 set bits, or -1
+      intptr_t findRunWord(size_t sizeL2) {
+         if (sizeL2 == 0) return this->findWord(0);
+         auto& summary = this->runs[sizeL2 - 1];
+         auto w = summary.findWord(0);
+         if (w < 0) return -1;
+         return (w << 6) + lsb_64(summary.word(w));
+      }
+   };
+
 }
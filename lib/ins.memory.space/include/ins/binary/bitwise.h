@@ -201,7 +201,7 @@ namespace ins::bit {
       return lo + ((unsigned long long)hi << 32);
    }
 
-#else
+#elif defined(_MSC_VER)
 
 #include <intrin.h>
 
@@ -261,6 +261,32 @@ namespace ins::bit {
    }
 #endif
 
+#else
+
+   static inline size_t lsb_32(unsigned x)
+   {
+      return __builtin_ctz(x);
+   }
+
+   static inline size_t msb_32(unsigned x)
+   {
+      return 31 - __builtin_clz(x);
+   }
+
+   static inline size_t lsb_64(unsigned long long x)
+   {
+      return __builtin_ctzll(x);
+   }
+
+   static inline size_t msb_64(unsigned long long x)
+   {
+      return 63 - __builtin_clzll(x);
+   }
+
+   static inline void* xchg_ptr(void* ptr, void* x)
+   {
+      return __atomic_exchange_n((void**)ptr, x, __ATOMIC_SEQ_CST);
+   }
 
 #endif
 
@@ -2,16 +2,47 @@
 
 #define _INS_PROTECTION 1
 
+#if defined(_MSC_VER)
+#define _INS_BREAK() __debugbreak()
+#define _INS_NOINLINE __declspec(noinline)
+#define _INS_FORCEINLINE __forceinline
+#define _INS_TLS __declspec(thread)
+#else
+#define _INS_BREAK() __builtin_trap()
+#define _INS_NOINLINE __attribute__((noinline))
+#define _INS_FORCEINLINE inline __attribute__((always_inline))
+#define _INS_TLS __thread __attribute__((tls_model("initial-exec"))) // Static TLS: no tls_get_addr call, the library cannot be dlopen-ed
+#endif
+
+// Replace the global new/delete operators by ins_malloc/ins_free (see operators.cpp)
+#if !defined(_INS_MALLOC_OPERATORS)
+#define _INS_MALLOC_OPERATORS 0
+#endif
+
+#if defined(__cpp_constinit)
+#define _INS_CONSTINIT constinit
+#else
+#define _INS_CONSTINIT
+#endif
+
 #if _DEBUG || _INS_PROTECTION
-#define _INS_ASSERT(x) {if(!(x)) __debugbreak();}
+#define _INS_ASSERT(x) {if(!(x)) _INS_BREAK();}
 #define _INS_PROTECT_CONDITION(x) _INS_ASSERT(x)
-#define _INS_PROFILE __declspec(noinline)
+#define _INS_PROFILE _INS_NOINLINE
 #else
 #define _INS_ASSERT(x)
 #define _INS_PROTECT_CONDITION(x) if (!x) throw;
 #define _INS_PROFILE
 #endif
 
+#if !defined(_ASSERT)
+#if _DEBUG
+#define _ASSERT(x) _INS_ASSERT(x)
+#else
+#define _ASSERT(x)
+#endif
+#endif
+
 #if 0
 #define _INS_TRACE(x) x
 #else
@@ -17,6 +17,7 @@ namespace ins::mem {
          DescriptorHeap = 3,
          Arena = 4,
          ObjectRegion = 5,
+         CachedBlock = 6,
       };
    };
 
@@ -39,7 +40,7 @@ namespace ins::mem {
    static_assert(sizeof(sDescriptorEntry) == sizeof(uint64_t), "bad size");
 
    struct Descriptor {
-      Descriptor();
+      constexpr Descriptor() {}
       Descriptor(uint8_t typeID);
       DescriptorEntry GetEntry();
       size_t GetSize();
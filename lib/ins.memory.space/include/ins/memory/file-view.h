@@ -3,10 +3,34 @@
 
 namespace ins::mem {
 
+   struct FileView;
+
+   // Window on a mapped file content (zero copy, valid while the buffer or the view is alive)
    struct FileBuffer {
-      FileBuffer(uintptr_t base) {
+      uint8_t* bytes = 0;
+      size_t size = 0;
+      FileView* view = 0; // Owner view of the referenced window (0 when not referenced)
+      void* window = 0;
+      FileBuffer() {
+      }
+      FileBuffer(uintptr_t base, size_t size, FileView* view = 0, void* window = 0)
+         : bytes((uint8_t*)base), size(size), view(view), window(window) {
+      }
+      FileBuffer(FileBuffer&& other)
+         : bytes(other.bytes), size(other.size), view(other.view), window(other.window) {
+         other.view = 0;
+         other.window = 0;
       }
-      ~FileBuffer() {
+      FileBuffer(const FileBuffer&) = delete;
+      FileBuffer& operator = (FileBuffer&& other);
+      ~FileBuffer();
+      void Release();
+      operator bool() {
+         return this->bytes != 0;
+      }
+      template<typename T>
+      T* as() {
+         return (T*)this->bytes;
       }
    };
 
@@ -15,7 +39,10 @@ namespace ins::mem {
       virtual size_t GetSize() = 0;
       virtual size_t GetExtendSizeLimit() = 0;
       virtual bool ExtendSize(size_t size) = 0;
-      virtual FileBuffer MapBuffer(uint32_t offset, size_t size) = 0;
+      virtual FileBuffer MapBuffer(size_t offset, size_t size) = 0;
+      virtual void ReleaseBuffer(void* window) {}
+      virtual bool Flush() { return true; } // Write back modified pages to the file
+      virtual bool MapBufferAt(uintptr_t address, size_t offset, size_t size) { return false; } // Map a file range in place of the address pages
    };
 
    struct DirectFileView : FileView {
@@ -26,9 +53,57 @@ namespace ins::mem {
    public:
       address_t GetBase();
       size_t GetSize() override final;
-      FileBuffer MapBuffer(uint32_t offset, size_t size) override final;
+      FileBuffer MapBuffer(size_t offset, size_t size) override final;
       static DirectFileView* NewReadOnly(const char* filename);
-      static DirectFileView* NewReadWrite(const char* filename, size_t size, bool reset = false);
+      static DirectFileView* NewReadWrite(const char* filename, size_t size, bool reset = false, uintptr_t base = 0);
+
+      // Shared memory view, mapped on its whole size at the same base in every process:
+      // - named: shared memory object, opened by name from any process (size is ignored when not created)
+      // - unnamed: anonymous memory file, shared only with the forked processes
+      static DirectFileView* NewShared(const char* name, size_t size, bool create, uintptr_t base);
+      static bool RemoveShared(const char* name);
+   };
+
+
+   // File view mapped by fixed size windows on demand, for files larger than the address budget:
+   // - a window maps 2 window sizes, so a buffer up to the window size never straddles windows
+   // - windows are referenced by their buffers, unreferenced windows are kept in a LRU cache
+   struct WindowedFileView : FileView {
+      static const size_t cDefaultWindowSizeL2 = 26; // 64Mo
+      static const size_t cDefaultResidentWindows = 16;
+   protected:
+      struct Window : Descriptor {
+         size_t index = 0;
+         uintptr_t base = 0;
+         size_t size = 0;
+         uint32_t references = 0;
+         Window* lru_prev = 0, * lru_next = 0;
+      };
+      std::mutex lock;
+      size_t size = 0;
+      uint8_t windowSizeL2 = 0;
+      size_t residentWindows = 0;
+      size_t mappedWindows = 0;
+      Window** windows = 0; // Window table, by window index
+      size_t windowsCount = 0;
+      Window* lru_head = 0; // Most recently used unreferenced window
+      Window* lru_tail = 0;
+      static size_t GetDescriptorSize(size_t baseSize, size_t size, uint8_t windowSizeL2);
+      void InitializeWindows(size_t size, uint8_t windowSizeL2, size_t residentWindows, Window** table);
+      void DisposeWindows();
+      void EvictWindows(size_t residentWindows);
+      virtual uintptr_t MapWindow(size_t offset, size_t size) = 0;
+      virtual void UnmapWindow(uintptr_t base, size_t size) = 0;
+   public:
+      size_t GetSize() override final;
+      size_t GetExtendSizeLimit() override final;
+      bool ExtendSize(size_t size) override final;
+      FileBuffer MapBuffer(size_t offset, size_t size) override final;
+      void ReleaseBuffer(void* window) override final;
+      size_t GetWindowSize();
+      size_t GetMappedWindowsCount();
+      void SetResidentWindows(size_t count);
+      static WindowedFileView* NewReadOnly(const char* filename, uint8_t windowSizeL2 = cDefaultWindowSizeL2, size_t residentWindows = cDefaultResidentWindows);
    };
 
-}
\ No newline at end of file
+}
@@ -1,8 +1,13 @@
 #pragma once
+#include <thread>
 #include <ins/memory/descriptors.h>
+#include <ins/binary/bitmap64.h>
 
 namespace ins::mem {
 
+   struct ArenaClassPool;
+   struct RegionPools;
+
    struct IMemoryConsumer {
       virtual void RescueStarvingSituation(size_t expectedByteLength) = 0;
    };
@@ -16,26 +21,30 @@ namespace ins::mem {
          // Specific region
          BufferRegion = 0x80,
          DescriptorHeapRegion = 0x81,
+         FileViewRegion = 0x82, // Arena mapped by a file view (owner is the view)
 
          // Space management region
          FreeRegion = 0xff,
          FreeCachedRegion = 0xfe,
+         FreeDrainingRegion = 0xfd, // Cached region held by a page release pass
       };
-      uint8_t value;
-      RegionLayoutID(uint8_t value = 0)
-         : value(value) {
+
+      // Stored complemented: zeroed region tables read as free, so fresh descriptor pages need no fill
+      uint8_t code;
+      constexpr RegionLayoutID(uint8_t value = 0)
+         : code(uint8_t(~value)) {
       }
-      bool IsFree() {
-         return this->value == RegionLayoutID::FreeRegion;
+      bool IsFree() const {
+         return this->code == uint8_t(~RegionLayoutID::FreeRegion);
       }
-      bool IsObjectRegion() {
-         return this->value <= RegionLayoutID::Reserved_ObjectRegionMax;
+      bool IsObjectRegion() const {
+         return this->code >= uint8_t(~RegionLayoutID::Reserved_ObjectRegionMax);
       }
       void operator = (uint8_t value) {
-         this->value = value;
+         this->code = uint8_t(~value);
       }
-      operator uint8_t() {
-         return this->value;
+      operator uint8_t() const {
+         return uint8_t(~this->code);
       }
       const char* GetLabel();
    };
@@ -62,6 +71,15 @@ namespace ins::mem {
    *   Arena Descriptor
    *
    ***********************************************************************/
+   // Type of the arena owner: the owner may live in a memory shared by processes, so it is
+   // identified by a tag rather than by a process local state
+   enum class ArenaOwnerKind : uint8_t {
+      None,
+      FileView,
+      PersistentHeap,
+      SharedHeap, // Owner is the header of the shared heap memory
+   };
+
    struct ArenaDescriptor : Descriptor {
       static ArenaDescriptor UnusedArena;
       static ArenaDescriptor ForbiddenArena;
@@ -69,27 +87,136 @@ namespace ins::mem {
       // Arena location
       bool managed = false;
       uint8_t segmentation = cst::ArenaSizeL2;
-      uint16_t indice = 0;
+      bool hugePages = false;
+      uint8_t numaNode = 0;
+      uint32_t indice = 0;
 
       // Region allocation state
-      uint32_t availables_scan_position = 0;
       std::atomic_uint32_t availables_count = 0;
+      bool availables_listed = false;
+      ArenaOwnerKind owner_kind = ArenaOwnerKind::None; // Type of the owner below
       ArenaDescriptor* next = 0;
 
+      // Free regions maps (stored after the region table):
+      // - frees: one bit per free region
+      // - frees_words: one bit per frees word fully free, for ranges of 64 regions and more
+      // Each map keeps per run size the words holding an aligned free run, searches skip the others.
+      // Regions from frees_limit are free but not listed yet, the maps are extended by chunks on demand
+      static const size_t cFreeMapsChunk = size_t(1) << 15; // 4KB of frees words
+      bit::MultiLevelRunsBitmap64 frees;
+      bit::MultiLevelRunsBitmap64 frees_words;
+      uint32_t frees_limit = 0;
+
+      // Used regions count per page, for regions batched in pages (stored after the free maps)
+      std::atomic_uint8_t* pages_useds = 0;
+
+      // Descriptor owning the arena content (file view arenas)
+      Descriptor* owner = 0;
+
+      // Class pool providing the arena regions, and next arena of this pool
+      ArenaClassPool* pool = 0;
+      ArenaDescriptor* next_pooled = 0;
+
       // Region table
       RegionLayoutID regions[1] = { RegionLayoutID::FreeRegion };
 
-      ArenaDescriptor();
+      constexpr ArenaDescriptor() {}
       ArenaDescriptor(uint8_t sizeL2);
       void Initialize(uint8_t segmentation);
+      void ResetTables();
+      void InitializeFreeMaps();
+      bool ExtendFreeMaps();
+      void UpdateFreeRuns(size_t index, size_t count);
+      intptr_t FindFreeRegionRange(uint16_t batchSizeL2);
+      void AcquireRegionRange(size_t index, size_t count, uint8_t layoutID);
+      void ReleaseRegionRange(size_t index, size_t count);
       uintptr_t GetBase() {
          return uintptr_t(this->indice) << cst::ArenaSizeL2;
       }
+      std::atomic_uint8_t& GetPageUseds(size_t regionIndex) {
+         return this->pages_useds[regionIndex >> (cst::PageSizeL2 - this->segmentation)];
+      }
       size_t GetRegionCount() {
          return size_t(1) << (cst::ArenaSizeL2 - this->segmentation);
       }
+      size_t GetRegionLimit() {
+         // Regions beyond the free maps limit have never been used
+         return this->frees.words ? this->frees_limit : this->GetRegionCount();
+      }
       static size_t GetDescriptorSize(uint8_t sizeL2) {
-         return sizeof(ArenaDescriptor) + (cst::ArenaSize >> sizeL2) * sizeof(RegionLayoutID);
+         auto count = cst::ArenaSize >> sizeL2;
+         auto mapsWords = bit::MultiLevelRunsBitmap64::GetWordCount(count) + bit::MultiLevelRunsBitmap64::GetWordCount(count >> 6);
+         auto pagesCount = (sizeL2 < cst::PageSizeL2) ? cst::ArenaSize >> cst::PageSizeL2 : 0;
+         return sizeof(ArenaDescriptor) + bit::align<size_t>(count * sizeof(RegionLayoutID), sizeof(uint64_t)) + mapsWords * sizeof(uint64_t) + pagesCount;
+      }
+   };
+
+   /**********************************************************************
+   *
+   *   Arena Registry
+   *   (dense list of live arenas, lock-free for visitors)
+   *
+   ***********************************************************************/
+   struct ArenaRegistry {
+      static const size_t cEntriesCount = cst::ArenaPerSpace < (size_t(1) << 20) ? cst::ArenaPerSpace : (size_t(1) << 20);
+      std::mutex lock;
+      std::atomic_uint32_t count = 0;
+      std::atomic_uint32_t entries[cEntriesCount] = {}; // arenaID + 1, or 0 when removed
+      std::atomic_uint32_t epoch = 0;
+      std::atomic_uint32_t readers[2] = {}; // Visitors count per epoch parity
+      std::mutex synchronizing;
+
+      void Register(uint32_t arenaID) {
+         std::lock_guard<std::mutex> guard(this->lock);
+         auto index = this->count.load(std::memory_order_relaxed);
+         if (index >= cEntriesCount) throw exception_missing_memory();
+         this->entries[index].store(arenaID + 1, std::memory_order_release);
+         this->count.store(index + 1, std::memory_order_release);
+      }
+      void Unregister(uint32_t arenaID) {
+         std::lock_guard<std::mutex> guard(this->lock);
+         auto count = this->count.load(std::memory_order_relaxed);
+         for (uint32_t i = 0; i < count; i++) {
+            if (this->entries[i].load(std::memory_order_relaxed) == arenaID + 1) {
+               // Move the last entry in the hole: a concurrent visitor may see it twice or miss it once
+               this->entries[i].store(this->entries[count - 1].load(std::memory_order_relaxed), std::memory_order_release);
+               this->entries[count - 1].store(0, std::memory_order_release);
+               this->count.store(count - 1, std::memory_order_release);
+               return;
+            }
+         }
+      }
+      // Wait the visitors which may have seen an unregistered arena, before its release
+      void Synchronize() {
+         std::lock_guard<std::mutex> guard(this->synchronizing);
+         std::atomic_thread_fence(std::memory_order_seq_cst);
+         auto& readers = this->readers[this->epoch.fetch_add(1) & 1];
+         while (readers.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+         }
+      }
+      template<typename Visitor>
+      bool Foreach(Visitor&& visitor) {
+         std::atomic_uint32_t* readers;
+         for (;;) {
+            auto epoch = this->epoch.load(std::memory_order_relaxed);
+            readers = &this->readers[epoch & 1];
+            readers->fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (this->epoch.load(std::memory_order_relaxed) == epoch) break;
+            readers->fetch_sub(1, std::memory_order_release);
+         }
+         struct Exit {
+            std::atomic_uint32_t* readers;
+            ~Exit() { readers->fetch_sub(1, std::memory_order_release); }
+         } exit{ readers };
+         auto count = this->count.load(std::memory_order_acquire);
+         for (uint32_t i = 0; i < count; i++) {
+            if (auto entry = this->entries[i].load(std::memory_order_acquire)) {
+               if (!visitor(uint32_t(entry - 1))) return false;
+            }
+         }
+         return true;
       }
    };
 
@@ -99,6 +226,8 @@ namespace ins::mem {
    *
    ***********************************************************************/
    union ArenaEntry {
+      // Descriptors are 8 bytes aligned: their pointer is shifted when the space exceeds the reference bits
+      static const size_t ReferenceShift = cst::SpaceSizeL2 > 55 ? 3 : 0;
       uint64_t bits;
       struct {
          uint64_t segmentation : 8;
@@ -109,13 +238,13 @@ namespace ins::mem {
          : bits(0) {
       }
       ArenaEntry(ArenaDescriptor* desc)
-         : reference(uint64_t(desc)), segmentation(desc->segmentation), managed(desc->managed) {
+         : reference(uint64_t(desc) >> ReferenceShift), segmentation(desc->segmentation), managed(desc->managed) {
       }
       ArenaDescriptor* descriptor() {
-         return (ArenaDescriptor*)this->reference;
+         return (ArenaDescriptor*)(uint64_t(this->reference) << ReferenceShift);
       }
       RegionLayoutID& layout(size_t regionIndex) {
-         return ((ArenaDescriptor*)this->reference)->regions[regionIndex];
+         return this->descriptor()->regions[regionIndex];
       }
       operator bool() {
          return this->bits != 0;
@@ -123,25 +252,105 @@ namespace ins::mem {
    };
    static_assert(sizeof(ArenaEntry) == 8, "bad size");
 
+   /**********************************************************************
+   *
+   *   Arena Map
+   *   (two level directory of arena entries, leaves committed on first arena registration)
+   *
+   ***********************************************************************/
+   struct ArenaDirectory {
+      static const size_t ArenaPerLeafL2 = cst::PageSizeL2 - 3; // One page of entries per leaf
+      static const size_t ArenaPerLeaf = size_t(1) << ArenaPerLeafL2;
+      static const size_t LeafPerSpace = cst::ArenaPerSpace >> ArenaPerLeafL2;
+
+      // Leaves of the space, unused leaves are the shared leaf of unused arenas (read only)
+      std::atomic<ArenaEntry*> leaves[LeafPerSpace] = {};
+      std::atomic_size_t leaves_count = 0;
+
+      ArenaEntry operator [] (uint32_t arenaID) {
+         return this->leaves[arenaID >> ArenaPerLeafL2].load(std::memory_order_relaxed)[arenaID & (ArenaPerLeaf - 1)];
+      }
+      void Initialize();
+      void Set(uint32_t arenaID, ArenaEntry entry); // Commits the arena leaf when unused
+      size_t GetUsedBytes() {
+         return sizeof(this->leaves) + (this->leaves_count << cst::PageSizeL2);
+      }
+   };
+
    /**********************************************************************
    *
    *   Memory Region
    *
    ***********************************************************************/
-   extern ArenaEntry* ArenaMap;
+   extern ArenaDirectory ArenaMap;
+   extern ArenaRegistry ManagedArenas;
+   extern ArenaRegistry UnmanagedArenas;
 
    extern void InitializeMemory();
 
    extern size_t GetMaxUsablePhysicalBytes();
    extern void SetMaxUsablePhysicalBytes(size_t size);
 
+   // Physical bytes accounting slack (bytes leased to processors, unused but counted against the limit)
+   extern void SetPhysicalBytesSlack(size_t slack);
+   extern size_t GetPhysicalBytesSlack();
+
+   // Huge pages management (applies to regions allocated after the option change,
+   // batched small regions keep the option set at the first allocation of their class)
+   enum class HugePagesMode {
+      Disabled,      // standard pages only
+      Transparent,   // huge arenas are advised for transparent huge pages
+      Explicit,      // huge regions are committed from the reserved huge pages pool, transparent as fallback
+   };
+   extern void SetHugePagesOption(HugePagesMode mode);
+   extern HugePagesMode GetHugePagesOption();
+
+   // Cached regions purge (cached regions idle for a period are decommitted with the half-life decay)
+   extern void SetCachePurgeOptions(uint32_t halfLifeMs, uint32_t periodMs); // halfLifeMs = 0 disables purge
+   extern uint32_t GetCachePurgePeriod();
+   extern size_t PurgeCachedRegions(uint32_t elapsedMs);
+
+   // Cold regions management (linux only): the content of a cold region is moved to a swap file,
+   // mapped at the same address, so its pointers stay valid while its physical pages are freed.
+   // Opt-in: nothing is demoted before SetColdStorage and a non zero demotion period. While a region moves,
+   // its writes are blocked by a userfaultfd write protection when the kernel supports it (linux 6.4),
+   // else the region is read only and a SIGSEGV handler is installed, chained to the previous one:
+   // then a system call writing the moved region fails with EFAULT
+   enum class ColdPromotion {
+      Disabled,   // cold regions stay in the swap file until disposed
+      OnAccess,   // cold regions are promoted back to memory when the heap reuses them (free, allocation)
+   };
+   extern bool SetColdStorage(const char* filename, size_t sizeLimit); // filename = 0 closes the storage (fails while cold regions exist)
+   extern void SetColdRegionsOptions(uint32_t periodMs, uint32_t idlePasses, ColdPromotion promotion); // periodMs = 0 disables demotion
+   extern uint32_t GetColdRegionsPeriod();
+   extern uint32_t GetColdRegionsIdlePasses();
+   extern ColdPromotion GetColdPromotion();
+   extern bool DemoteRegion(address_t address, size_t size, std::function<bool()>&& validate); // validate runs while region writes are blocked
+   extern bool PromoteRegion(address_t address);
+   extern bool IsColdRegion(address_t address); // Takes the storage lock, region owners keep their own cold flag
+
+   // Write sampling of the cold candidates (soft-dirty pages, linux): reset clears the bits of the whole
+   // process, so the next writes of every page take a minor fault
+   extern bool IsWriteSamplingSupported();
+   extern bool IsRegionWritten(address_t address, size_t size); // Written since the last reset (true when not supported)
+   extern void ResetRegionWrites();
+   extern size_t GetColdBytes();
+
    // Global memory management
    extern bool RequirePhysicalBytes(size_t size, IMemoryConsumer* consumer);
    extern void ReleasePhysicalBytes(size_t size);
    extern size_t GetUsedPhysicalBytes();
+   extern size_t ReconcilePhysicalBytes(); // Compare accounting to process resident bytes, returns resident bytes
+   extern void SetPhysicalBytesReconciliation(bool enabled); // When disabled, the purge trigger applies on committed bytes
+   extern bool IsPhysicalBytesSoftLimitReached(); // Purge trigger: touched bytes close to the limit (the limit applies on committed bytes)
+
+   // Region pages management (page range inside an allocated region, not applicable to huge pages arenas)
+   extern bool CommitRegionPages(address_t address, size_t size, IMemoryConsumer* consumer); // consumer = 0 forces the commit
+   extern bool DecommitRegionPages(address_t address, size_t size);
 
    // Arena management
    extern address_t ReserveArena();
+   extern void RegisterArena(ArenaDescriptor* arena);
 
    // Region management
    extern Descriptor* GetRegionDescriptor(address_t address);
@@ -149,25 +358,55 @@ namespace ins::mem {
    extern void ForeachRegion(std::function<bool(ArenaDescriptor* arena, RegionLayoutID layout, address_t addr)>&& visitor);
    extern void PerformRegionsCleanup();
 
+   // Numa nodes management (allocations default to the node of the calling thread)
+   extern uint8_t GetNumaNodeCount();
+   extern uint8_t GetCurrentNumaNode();
+   extern uint8_t GetRegionNumaNode(address_t address);
+   extern void SetNumaNodesOption(uint8_t count); // Logical nodes beyond physical ones are folded on them (fake numa)
+
    // Standard size allocation management
-   extern address_t AllocateUnmanagedRegion(uint8_t sizeL2, uint8_t sizingID, IMemoryConsumer* consumer);
-   extern address_t AllocateManagedRegion(uint8_t sizeL2, uint8_t sizingID, IMemoryConsumer* consumer);
-   extern address_t ReserveUnmanagedRegion(uint8_t sizeL2);
-   extern address_t ReserveManagedRegion(uint8_t sizeL2);
+   extern address_t AllocateUnmanagedRegion(uint8_t sizeL2, uint8_t sizingID, IMemoryConsumer* consumer, uint8_t numaNode = cst::NumaNodeAny);
+   extern address_t AllocateManagedRegion(uint8_t sizeL2, uint8_t sizingID, IMemoryConsumer* consumer, uint8_t numaNode = cst::NumaNodeAny);
+   extern address_t ReserveUnmanagedRegion(uint8_t sizeL2, uint8_t numaNode = cst::NumaNodeAny);
+   extern address_t ReserveManagedRegion(uint8_t sizeL2, uint8_t numaNode = cst::NumaNodeAny);
+   extern void ReleaseReservedRegion(address_t address, uint8_t sizeL2); // Reserved regions are not accounted, pages committed meanwhile are decommitted
    extern void ReleaseRegion(address_t address, uint8_t sizeL2, uint8_t sizingID);
    extern void DisposeRegion(address_t address, uint8_t sizeL2, uint8_t sizingID);
 
    // Adjusted size allocation management
-   extern address_t AllocateUnmanagedRegionEx(size_t size, IMemoryConsumer* consumer);
-   extern address_t AllocateManagedRegionEx(size_t size, IMemoryConsumer* consumer);
+   extern address_t AllocateUnmanagedRegionEx(size_t size, IMemoryConsumer* consumer, uint8_t numaNode = cst::NumaNodeAny);
+   extern address_t AllocateManagedRegionEx(size_t size, IMemoryConsumer* consumer, uint8_t numaNode = cst::NumaNodeAny);
    extern void ReleaseRegionEx(address_t address, size_t size);
    extern void DisposeRegionEx(address_t address, size_t size);
 
+   // Region pools management (isolated arenas with their own physical limit, used by heap instances):
+   // regions are disposed and released with the standard API, an arena serves only one pools
+   extern RegionPools* CreateRegionPools(size_t maxPhysicalBytes); // 0 for no limit beyond the process one
+   extern void DeleteRegionPools(RegionPools* pools); // Releases the pools arenas, without visiting their regions
+   extern RegionPools* GetRegionPools(address_t address); // 0 for regions of the process pools
+   extern size_t GetRegionPoolsUsedBytes(RegionPools* pools);
+   extern size_t PurgeRegionPools(RegionPools* pools, uint32_t elapsedMs);
+   extern void CleanRegionPools(RegionPools* pools);
+   extern void ForeachArena(RegionPools* pools, std::function<bool(ArenaDescriptor* arena)>&& visitor);
+   extern address_t AllocateUnmanagedRegion(RegionPools* pools, uint8_t sizeL2, uint8_t sizingID, IMemoryConsumer* consumer);
+   extern address_t AllocateManagedRegion(RegionPools* pools, uint8_t sizeL2, uint8_t sizingID, IMemoryConsumer* consumer);
+   extern address_t AllocateUnmanagedRegionEx(RegionPools* pools, size_t size, IMemoryConsumer* consumer);
+   extern address_t AllocateManagedRegionEx(RegionPools* pools, size_t size, IMemoryConsumer* consumer);
+
    // Utils API
    struct tMemoryStats {
       size_t descriptors_used_bytes = 0;
       size_t arenas_map_used_bytes = 0;
       size_t used_bytes = 0;
+      size_t leased_bytes = 0;
+      size_t untouched_bytes = 0;
+      size_t resident_bytes = 0;
+      size_t huge_page_size = 0;
+      size_t huge_pages_count = 0;
+      size_t purged_bytes = 0;
+      size_t purged_regions = 0;
+      size_t cold_bytes = 0; // Region bytes moved to the cold storage (used_bytes are the hot ones)
+      size_t cold_regions = 0;
    };
    extern tMemoryStats GetMemoryStats();
    extern void PrintMemoryInfos();
@@ -198,7 +437,7 @@ namespace ins::mem {
       }
       static RegionLocation New(address_t address) {
          auto entry = mem::ArenaMap[address.arenaID];
-         return RegionLocation(entry, address.position >> entry.segmentation);
+         return RegionLocation(entry, uintptr_t(address.position) >> entry.segmentation);
       }
    };
 
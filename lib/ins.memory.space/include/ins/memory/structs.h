@@ -1,11 +1,17 @@
 #pragma once
 #include <atomic>
 #include <exception>
+#include <stdexcept>
 #include <functional>
 #include <ins/macros.h>
 #include <ins/binary/bitwise.h>
 #include <stdio.h>
 
+// Space size: 48 bits for 4-level paging hosts, up to 57 bits for 5-level paging hosts
+#ifndef _INS_SPACE_SIZE_L2
+#define _INS_SPACE_SIZE_L2 48
+#endif
+
 namespace ins::mem {
 
    typedef size_t index_t;
@@ -20,9 +26,13 @@ namespace ins::mem {
       // Space <- Arena <- Region <- Page
 
       // Space: all accessible virtual memory
-      const size_t SpaceSizeL2 = 48;
+      const size_t SpaceSizeL2 = _INS_SPACE_SIZE_L2;
       const size_t SpaceSize = size_t(1) << SpaceSizeL2;
       const uintptr_t SpaceMask = SpaceSize - 1;
+      static_assert(SpaceSizeL2 >= 48 && SpaceSizeL2 <= 57, "unsupported space size");
+
+      // Packed pointers: bits above the space are free for tags (version of lock-free lists)
+      const size_t PointerTagBits = 64 - SpaceSizeL2;
 
       // Page: physical memory mapping granularity
       const size_t PageSizeL2 = 16;
@@ -41,7 +51,20 @@ namespace ins::mem {
       const size_t RegionSizeMax = size_t(1) << RegionSizeMaxL2;
       const size_t RegionSizingCount = 33;
 
+      // Numa node: memory locality domain, with its own arena pools
+      const size_t NumaNodeMax = 8;
+      const uint8_t NumaNodeAny = 0xff;
+
+      // Region cache: per processor magazines, overflowing in a shared stack
+      const size_t RegionCacheMagazineCount = 16;
+      const size_t RegionCacheMagazineSize = 32;
+
+      // Physical bytes budget: per processor leases, reserved by chunks on the global budget
+      const size_t PhysicalBytesLeaseCount = 16;
+      const size_t PhysicalBytesSlackDefault = size_t(32) << 20;
+
       const size_t PagePerArenaL2 = ArenaSizeL2 - PageSizeL2;
+      const size_t PagePerSpaceL2 = SpaceSizeL2 - PageSizeL2;
       const size_t ArenaPerSpaceL2 = SpaceSizeL2 - ArenaSizeL2;
       const size_t ArenaPerSpace = size_t(1) << ArenaPerSpaceL2;
    }
@@ -63,7 +86,7 @@ namespace ins::mem {
       address_t() : ptr(0) {}
       address_t(uintptr_t ptr) : ptr(ptr) {}
       address_t(void* ptr) : ptr(uintptr_t(ptr)) {}
-      address_t(uint32_t arenaID, uint32_t position) : arenaID(arenaID), position(position) {}
+      address_t(uint32_t arenaID, uint32_t position) : ptr((uintptr_t(arenaID) << 32) | position) {}
       operator uintptr_t() { return ptr; }
       operator void* () { return (void*)ptr; }
       void operator = (uintptr_t ptr) { this->ptr = ptr; }
@@ -25,7 +25,38 @@ namespace ins::os {
    uintptr_t AllocateMemory(uintptr_t base, uintptr_t limit, uintptr_t size, uintptr_t alignement);
    uintptr_t ReserveMemory(uintptr_t base, uintptr_t limit, uintptr_t size, uintptr_t alignement);
 
+   // Sparse memory: readable zero pages, committed by the system on first write (returns 0 when not supported)
+   uintptr_t AllocateSparseMemory(uintptr_t size);
+
    bool CommitMemory(uintptr_t base, uintptr_t size);
    bool DecommitMemory(uintptr_t base, uintptr_t size);
    bool ReleaseMemory(uintptr_t base, uintptr_t size);
+
+   // Discard the content of committed memory: pages stay committed and read back as zero
+   bool ResetMemory(uintptr_t base, uintptr_t size);
+
+   // Huge pages (GetHugePageSize returns 0 when not supported)
+   uintptr_t GetHugePageSize();
+   bool AdviseHugeMemory(uintptr_t base, uintptr_t size);
+   bool CommitHugeMemory(uintptr_t base, uintptr_t size);
+   bool DecommitHugeMemory(uintptr_t base, uintptr_t size);
+   void EnumerateHugeMemoryZone(std::function<void(uintptr_t address, uintptr_t size, uintptr_t hugeBytes)> visitor);
+
+   // Sequential access hint, with read ahead of the range (for mapped files)
+   bool AdviseSequentialMemory(uintptr_t base, uintptr_t size);
+
+   // NUMA nodes
+   uint32_t GetNumaNodeCount();
+   uint32_t GetCurrentNumaNode();
+   bool BindMemoryToNumaNode(uintptr_t base, uintptr_t size, uint32_t node);
+
+   // Process memory limit and usage (GetMemoryLimit returns 0 when not limited)
+   uintptr_t GetMemoryLimit();
+   uintptr_t GetResidentMemorySize();
+
+   // Memory pressure monitor (OpenMemoryPressureMonitor returns 0 when not supported)
+   // WaitMemoryPressure returns 1 when pressure is signaled, 0 on timeout, -1 on failure
+   uintptr_t OpenMemoryPressureMonitor(uint32_t stallUs, uint32_t windowUs);
+   int WaitMemoryPressure(uintptr_t monitor, uint32_t timeoutMs);
+   void CloseMemoryPressureMonitor(uintptr_t monitor);
 }
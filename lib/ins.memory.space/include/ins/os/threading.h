@@ -18,4 +18,10 @@ namespace ins::os {
    private:
       uint64_t d0, d1;
    };
+
+   // Processor running the calling thread (hint only, thread may migrate)
+   uint32_t GetCurrentProcessor();
+
+   // Identifier of the calling process
+   uint32_t GetCurrentProcessID();
 }
@@ -0,0 +1,453 @@
+#include <ins/memory/map.h>
+#include <ins/memory/file-view.h>
+#include <ins/os/memory.h>
+#include <string.h>
+#include "./descriptors-allocator.h"
+#include "./regions-allocator.h"
+
+using namespace ins;
+using namespace ins::mem;
+
+/**********************************************************************
+*
+*   Cold Storage
+*   (swap file of the cold regions)
+*
+***********************************************************************/
+
+namespace {
+   struct ColdRegion : Descriptor {
+      uintptr_t address = 0;
+      size_t size = 0;
+      size_t offset = 0; // Slot offset in the swap file
+      ColdRegion* next = 0;
+   };
+
+   struct ColdStorage : Descriptor {
+      static const size_t cBucketsCount = 4096;
+      std::mutex lock;
+      FileView* view = 0;
+      uintptr_t view_base = 0;
+      size_t cursor = 0; // Offset of the never used slots
+      size_t frees[cst::ArenaSizeL2 + 1] = { 0 }; // Free slots by sizeL2 (offset + 1, chained in the slot first word)
+      ColdRegion* buckets[cBucketsCount] = { 0 };
+
+      static size_t GetBucket(uintptr_t address) {
+         return (address >> cst::PageSizeL2) % cBucketsCount;
+      }
+      ColdRegion** FindRegion(uintptr_t address) {
+         auto pregion = &this->buckets[GetBucket(address)];
+         while (*pregion && (*pregion)->address != address) {
+            pregion = &(*pregion)->next;
+         }
+         return pregion;
+      }
+      intptr_t AcquireSlot(size_t size) {
+         auto sizeL2 = bit::log2_ceil_64(size);
+         if (auto slot = this->frees[sizeL2]) {
+            auto offset = slot - 1;
+            this->frees[sizeL2] = *(size_t*)(this->view_base + offset);
+            return offset;
+         }
+         auto offset = this->cursor;
+         if (!this->view->ExtendSize(offset + (size_t(1) << sizeL2))) {
+            return -1;
+         }
+         this->cursor += size_t(1) << sizeL2;
+         return offset;
+      }
+      void ReleaseSlot(size_t offset, size_t size) {
+         auto sizeL2 = bit::log2_ceil_64(size);
+         *(size_t*)(this->view_base + offset) = this->frees[sizeL2];
+         this->frees[sizeL2] = offset + 1;
+      }
+   };
+
+   ColdStorage* storage = 0;
+   std::atomic_size_t coldBytes = 0;
+   std::atomic_size_t coldRegions = 0;
+   uint32_t coldPeriodMs = 0;
+   uint32_t coldIdlePasses = 4;
+   ColdPromotion coldPromotion = ColdPromotion::OnAccess;
+}
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/userfaultfd.h>
+#include <signal.h>
+#include <pthread.h>
+#include <sched.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#if !defined(UFFD_FEATURE_WP_UNPOPULATED)
+#define UFFD_FEATURE_WP_UNPOPULATED (1 << 13) // Linux 6.4, older headers
+#endif
+
+/**********************************************************************
+*
+*   Write sampling
+*   (soft-dirty bits of the region pages, cleared for the process at each pass)
+*
+***********************************************************************/
+
+namespace {
+   int pagemap_fd = -1;
+   bool sampling_supported = false;
+   volatile uint64_t sampling_probe[512] = { 0 }; // Spans a system page at least
+
+   bool ClearSoftDirtyBits() {
+      int fd = open("/proc/self/clear_refs", O_WRONLY | O_CLOEXEC);
+      if (fd < 0) return false;
+      bool cleared = write(fd, "4", 1) == 1;
+      close(fd);
+      return cleared;
+   }
+
+   bool IsPageWritten(uintptr_t address) {
+      uint64_t entry = 0;
+      auto offset = (address / uintptr_t(sysconf(_SC_PAGESIZE))) * sizeof(uint64_t);
+      if (pread(pagemap_fd, &entry, sizeof(entry), offset) != sizeof(entry)) return false;
+      return (entry >> 55) & 1;
+   }
+
+   void InitializeWriteSampling() {
+      if (pagemap_fd >= 0) return;
+      pagemap_fd = open("/proc/self/pagemap", O_RDONLY | O_CLOEXEC);
+      if (pagemap_fd < 0) return;
+
+      // Kernels without soft-dirty support accept the clear but never set the bit
+      auto probe = uintptr_t(&sampling_probe[256]);
+      if (ClearSoftDirtyBits()) {
+         sampling_probe[256] = sampling_probe[256] + 1;
+         sampling_supported = IsPageWritten(probe);
+      }
+   }
+}
+
+bool mem::IsWriteSamplingSupported() {
+   return sampling_supported;
+}
+
+bool mem::IsRegionWritten(address_t address, size_t size) {
+   if (!sampling_supported) return true;
+   const size_t cBatchCount = 64;
+   uint64_t entries[cBatchCount];
+   auto pageSize = uintptr_t(sysconf(_SC_PAGESIZE));
+   auto first = address.ptr / pageSize;
+   auto count = (size + pageSize - 1) / pageSize;
+   for (size_t i = 0; i < count; i += cBatchCount) {
+      auto batch = (count - i < cBatchCount) ? count - i : cBatchCount;
+      auto bytes = pread(pagemap_fd, entries, batch * sizeof(uint64_t), (first + i) * sizeof(uint64_t));
+      if (bytes != ssize_t(batch * sizeof(uint64_t))) return true;
+      for (size_t k = 0; k < batch; k++) {
+         if ((entries[k] >> 55) & 1) return true;
+      }
+   }
+   return false;
+}
+
+void mem::ResetRegionWrites() {
+   if (sampling_supported) ClearSoftDirtyBits();
+}
+
+/**********************************************************************
+*
+*   Write barrier
+*   (region pages are write protected while moved, writers wait the move end)
+*
+***********************************************************************/
+// With userfaultfd write protection, writers (system calls included) wait in the kernel until the
+// barrier wakes them. Otherwise (older kernels, file pages of a promoted region) the pages are read
+// only and a SIGSEGV handler, chained to the previous one, holds the faulting writers: only user
+// space writes fault, a system call writing in the moved pages fails with EFAULT instead of waiting.
+// The barrier lasts a region copy, on regions full of objects left unwritten for several sampling passes.
+
+namespace {
+   int barrier_uffd = -1;
+   bool barrier_uffd_protected = false; // Current barrier is a userfaultfd write protection
+   std::atomic_uintptr_t barrier_base = 0;
+   std::atomic_uintptr_t barrier_end = 0;
+   struct sigaction previous_segv;
+   bool barrier_installed = false;
+
+   int OpenWriteProtectFaults() {
+      // Kernel faults are caught too when the process may (vm.unprivileged_userfaultfd, CAP_SYS_PTRACE),
+      // else only user faults are
+      int fd = int(syscall(__NR_userfaultfd, O_CLOEXEC | O_NONBLOCK));
+      if (fd < 0) fd = int(syscall(__NR_userfaultfd, O_CLOEXEC | O_NONBLOCK | UFFD_USER_MODE_ONLY));
+      if (fd < 0) return -1;
+
+      // Unpopulated pages shall be protected too, a write would map a new page behind the copy
+      struct uffdio_api api;
+      memset(&api, 0, sizeof(api));
+      api.api = UFFD_API;
+      api.features = UFFD_FEATURE_PAGEFAULT_FLAG_WP | UFFD_FEATURE_WP_UNPOPULATED;
+      if (ioctl(fd, UFFDIO_API, &api) != 0) {
+         close(fd);
+         return -1;
+      }
+      return fd;
+   }
+
+   void ChainFaultHandler(int sig, siginfo_t* info, void* context) {
+      // Run the previous handler as the system would have: with its mask, and its reset flag applied
+      // (the barrier handler is installed again by the next barrier)
+      sigset_t mask, saved;
+      pthread_sigmask(SIG_SETMASK, 0, &saved);
+      sigorset(&mask, &saved, &previous_segv.sa_mask);
+      if (previous_segv.sa_flags & SA_NODEFER) sigdelset(&mask, sig);
+      auto previous = previous_segv;
+      if (previous.sa_flags & SA_RESETHAND) {
+         signal(sig, SIG_DFL);
+         barrier_installed = false;
+      }
+      pthread_sigmask(SIG_SETMASK, &mask, 0);
+      if (previous.sa_flags & SA_SIGINFO) {
+         previous.sa_sigaction(sig, info, context);
+      }
+      else {
+         previous.sa_handler(sig);
+      }
+      pthread_sigmask(SIG_SETMASK, &saved, 0);
+   }
+
+   void BarrierFaultHandler(int sig, siginfo_t* info, void* context) {
+      auto address = uintptr_t(info->si_addr);
+      auto base = barrier_base.load();
+      if (base && address >= base && address < barrier_end.load()) {
+         while (barrier_base.load() == base) sched_yield();
+         return; // Retry the access on the new mapping
+      }
+      if ((previous_segv.sa_flags & SA_SIGINFO) || (previous_segv.sa_handler != SIG_DFL && previous_segv.sa_handler != SIG_IGN)) {
+         ChainFaultHandler(sig, info, context);
+      }
+      else {
+         signal(sig, SIG_DFL); // Fault again with the default action
+      }
+   }
+
+   bool InstallFaultHandler() {
+      if (!barrier_installed) {
+         // The host alternate stack flag is kept: stack overflows still reach its handler
+         struct sigaction previous;
+         if (sigaction(SIGSEGV, 0, &previous) != 0) return false;
+         struct sigaction action;
+         memset(&action, 0, sizeof(action));
+         action.sa_sigaction = BarrierFaultHandler;
+         action.sa_flags = SA_SIGINFO | (previous.sa_flags & SA_ONSTACK);
+         sigemptyset(&action.sa_mask);
+         previous_segv = previous;
+         if (sigaction(SIGSEGV, &action, 0) != 0) return false;
+         barrier_installed = true;
+      }
+      return true;
+   }
+
+   void InstallBarrier() {
+      if (barrier_uffd < 0) barrier_uffd = OpenWriteProtectFaults();
+   }
+
+   bool BeginBarrier(uintptr_t base, size_t size) {
+      if (barrier_uffd >= 0) {
+         // Register fails on mappings not supported by the write protection (regular file pages)
+         struct uffdio_register reg;
+         memset(&reg, 0, sizeof(reg));
+         reg.range.start = base;
+         reg.range.len = size;
+         reg.mode = UFFDIO_REGISTER_MODE_WP;
+         if (ioctl(barrier_uffd, UFFDIO_REGISTER, &reg) == 0) {
+            struct uffdio_writeprotect wp;
+            wp.range = reg.range;
+            wp.mode = UFFDIO_WRITEPROTECT_MODE_WP;
+            if (ioctl(barrier_uffd, UFFDIO_WRITEPROTECT, &wp) == 0) {
+               barrier_uffd_protected = true;
+               return true;
+            }
+            ioctl(barrier_uffd, UFFDIO_UNREGISTER, &reg.range);
+            return false;
+         }
+      }
+      if (!InstallFaultHandler()) return false;
+      barrier_end = base + size;
+      barrier_base = base;
+      if (mprotect((void*)base, size, PROT_READ) != 0) {
+         barrier_base = 0;
+         return false;
+      }
+      return true;
+   }
+
+   void EndBarrier(uintptr_t base, size_t size, bool moved) {
+      if (barrier_uffd_protected) {
+         // The moved range is a new mapping, else the protection is removed, then the waiting writers retry
+         struct uffdio_range range = { base, size };
+         if (!moved) {
+            struct uffdio_writeprotect wp = { range, 0 };
+            ioctl(barrier_uffd, UFFDIO_WRITEPROTECT, &wp);
+            ioctl(barrier_uffd, UFFDIO_UNREGISTER, &range);
+         }
+         ioctl(barrier_uffd, UFFDIO_WAKE, &range);
+         barrier_uffd_protected = false;
+         return;
+      }
+      if (!moved) mprotect((void*)base, size, PROT_READ | PROT_WRITE);
+      barrier_base = 0;
+   }
+}
+
+bool mem::SetColdStorage(const char* filename, size_t sizeLimit) {
+   mem::InitializeMemory();
+   std::lock_guard<std::mutex> guard(space->lock);
+   if (storage) {
+      if (coldRegions) return false;
+      delete storage->view;
+      delete storage;
+      storage = 0;
+   }
+   if (filename) {
+      InstallBarrier();
+      InitializeWriteSampling();
+      auto view = DirectFileView::NewReadWrite(filename, sizeLimit, true);
+      if (!view) return false;
+      storage = Descriptor::New<ColdStorage>();
+      storage->view = view;
+      storage->view_base = view->GetBase();
+   }
+   return true;
+}
+
+bool mem::DemoteRegion(address_t address, size_t size, std::function<bool()>&& validate) {
+   _ASSERT((address.position & cst::PageMask) == 0 && (size & cst::PageMask) == 0);
+   auto storage = ::storage;
+   if (!storage) return false;
+   std::lock_guard<std::mutex> guard(storage->lock);
+   if (*storage->FindRegion(address)) return false;
+   auto offset = storage->AcquireSlot(size);
+   if (offset < 0) return false;
+
+   // Copy the region to its slot, then map the slot at the region address
+   bool moved = false;
+   if (BeginBarrier(address, size)) {
+      if (validate()) {
+         memcpy((void*)(storage->view_base + offset), address, size);
+         moved = storage->view->MapBufferAt(address, offset, size);
+      }
+      EndBarrier(address, size, moved);
+   }
+   if (!moved) {
+      storage->ReleaseSlot(offset, size);
+      return false;
+   }
+
+   // Keep the slot pages mapped only at the region address, and write them back to the file
+   madvise((void*)(storage->view_base + offset), size, MADV_DONTNEED);
+#if defined(MADV_PAGEOUT)
+   madvise(address, size, MADV_PAGEOUT);
+#endif
+
+   auto region = Descriptor::New<ColdRegion>();
+   region->address = address;
+   region->size = size;
+   region->offset = offset;
+   auto pregion = storage->FindRegion(address);
+   *pregion = region;
+   coldBytes += size;
+   coldRegions++;
+   mem::ReleasePhysicalBytes(size);
+   return true;
+}
+
+bool mem::PromoteRegion(address_t address) {
+   auto storage = ::storage;
+   if (!storage || !coldRegions.load(std::memory_order_relaxed)) return false;
+   std::lock_guard<std::mutex> guard(storage->lock);
+   auto pregion = storage->FindRegion(address);
+   auto region = *pregion;
+   if (!region) return false;
+
+   // Copy the region to new pages, then move them at the region address
+   auto size = region->size;
+   auto pages = mmap(0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+   if (pages == MAP_FAILED) return false;
+   bool moved = false;
+   if (BeginBarrier(address, size)) {
+      memcpy(pages, address, size);
+      moved = mremap(pages, size, size, MREMAP_MAYMOVE | MREMAP_FIXED, (void*)address.ptr) != MAP_FAILED;
+      EndBarrier(address, size, moved);
+   }
+   if (!moved) {
+      munmap(pages, size);
+      return false;
+   }
+
+   *pregion = region->next;
+   storage->ReleaseSlot(region->offset, size);
+   coldBytes -= size;
+   coldRegions--;
+   space->physicalBytes.Force(size);
+   delete region;
+   return true;
+}
+
+#else
+
+bool mem::SetColdStorage(const char* filename, size_t sizeLimit) {
+   return !filename; // Region pages cannot be replaced by file pages in place
+}
+
+bool mem::DemoteRegion(address_t address, size_t size, std::function<bool()>&& validate) {
+   return false;
+}
+
+bool mem::PromoteRegion(address_t address) {
+   return false;
+}
+
+bool mem::IsWriteSamplingSupported() {
+   return false;
+}
+
+bool mem::IsRegionWritten(address_t address, size_t size) {
+   return true;
+}
+
+void mem::ResetRegionWrites() {
+}
+
+#endif
+
+bool mem::IsColdRegion(address_t address) {
+   auto storage = ::storage;
+   if (!storage || !coldRegions.load(std::memory_order_relaxed)) return false;
+   std::lock_guard<std::mutex> guard(storage->lock);
+   return *storage->FindRegion(address) != 0;
+}
+
+void mem::SetColdRegionsOptions(uint32_t periodMs, uint32_t idlePasses, ColdPromotion promotion) {
+   coldPeriodMs = periodMs;
+   coldIdlePasses = idlePasses;
+   coldPromotion = promotion;
+}
+
+uint32_t mem::GetColdRegionsPeriod() {
+   return storage ? coldPeriodMs : 0;
+}
+
+uint32_t mem::GetColdRegionsIdlePasses() {
+   return coldIdlePasses;
+}
+
+ColdPromotion mem::GetColdPromotion() {
+   return coldPromotion;
+}
+
+size_t mem::GetColdBytes() {
+   return coldBytes;
+}
+
+size_t mem::GetColdRegionsCount() {
+   return coldRegions;
+}
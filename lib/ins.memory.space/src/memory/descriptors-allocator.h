@@ -1,4 +1,5 @@
 #pragma once
+#include <stdexcept>
 #include <ins/memory/descriptors.h>
 #include <ins/os/memory.h>
 
@@ -75,17 +76,22 @@ namespace ins::mem {
             auto& anchor = blocks[block->sizeL2];
             block->bucketAnchor = &anchor;
             block->bucketNext = anchor;
+            if (anchor) anchor->bucketAnchor = &block->bucketNext;
             anchor = block;
             sizesMap |= uint32_t(1) << block->sizeL2;
          }
+         void UnlinkBlock(BlockDescriptor block) {
+            block->bucketAnchor[0] = block->bucketNext;
+            if (block->bucketNext) block->bucketNext->bucketAnchor = block->bucketAnchor;
+            if (!blocks[block->sizeL2]) {
+               sizesMap &= ~(uint32_t(1) << block->sizeL2);
+            }
+         }
          BlockDescriptor PullBlock(size_t minSizeL2) {
             auto fsizeL2 = GetAvailableSizeL2(minSizeL2, sizesMap);
             if (fsizeL2 > 0) {
                auto block = blocks[fsizeL2];
-               block->bucketAnchor[0] = block->bucketNext;
-               if (!blocks[fsizeL2]) {
-                  sizesMap ^= uint32_t(1) << fsizeL2;
-               }
+               this->UnlinkBlock(block);
                return block;
             }
             return 0;
@@ -106,38 +112,16 @@ namespace ins::mem {
                this->PushBlock(buddy);
             }
          }
-         void MergeBlocks() {
-            // Bubble merging algorithm, iterate from small to big size
-            for (auto sizeL2 = cBlockSizeL2_Min; sizeL2 < cBlockSizeL2_Max; sizeL2++) {
-
-               // Merge blocks
-               auto block = blocks[sizeL2];
-               auto buddyBit = uintptr_t(1) << sizeL2;
-               while (block) {
-                  auto buddy = BlockDescriptor(uintptr_t(block) ^ buddyBit);
-                  if (buddy->typeID == DescriptorTypeID::FreeBlock && buddy->sizeL2 == sizeL2) {
-                     // Unlink buddies
-                     buddy->bucketAnchor[0] = buddy->bucketNext;
-                     block->bucketAnchor[0] = block->bucketNext;
-                     auto nextBlock = block->bucketNext;
-
-                     // Push upper block
-                     if (uintptr_t(block) & buddyBit) block = buddy;
-                     block->sizeL2++;
-                     this->PushBlock(block);
-
-                     block = nextBlock;
-                  }
-                  else {
-                     block = block->bucketNext;
-                  }
-               }
-
-               // Update sizes map
-               if (!blocks[sizeL2]) {
-                  sizesMap &= ~(uint32_t(1) << sizeL2);
-               }
+         void ReleaseBlock(BlockDescriptor block, size_t sizeL2, size_t maxSizeL2) {
+            // Coalesce with the free buddy of each level, until the buddy is in use or split
+            while (sizeL2 < maxSizeL2) {
+               auto buddy = BlockDescriptor(uintptr_t(block) ^ (uintptr_t(1) << sizeL2));
+               if (buddy->typeID != DescriptorTypeID::FreeBlock || buddy->sizeL2 != sizeL2) break;
+               this->UnlinkBlock(buddy);
+               if (buddy < block) block = buddy;
+               sizeL2++;
             }
+            this->PushBlock(block->Reset(uint8_t(sizeL2)));
          }
       };
 
@@ -153,14 +137,16 @@ namespace ins::mem {
             span->bucketNext = anchor;
             anchor = span;
             this->lengthsMap |= uint32_t(1) << span->lengthL2;
-            this->paging = AVL::Operators::insertAt(this->paging, &AVL::Insert(span), span);
+            AVL::Insert insert(span);
+            this->paging = AVL::Operators::insertAt(this->paging, &insert, span);
          }
          PageSpanDescriptor PullSpan(size_t minLengthL2) {
             auto flengthL2 = GetAvailableSizeL2(minLengthL2, this->lengthsMap);
             if (flengthL2 >= 0) {
                auto span = this->spans[flengthL2];
                span->bucketAnchor[0] = span->bucketNext;
-               this->paging = AVL::Operators::removeAt(this->paging, &AVL::Key(span->ptr), span);
+               AVL::Key key(span->ptr);
+               this->paging = AVL::Operators::removeAt(this->paging, &key, span);
                if (!this->spans[flengthL2]) {
                   this->lengthsMap ^= uint32_t(1) << flengthL2;
                }
@@ -184,12 +170,68 @@ namespace ins::mem {
             }
             return spanPtr;
          }
-         void FeedBlocksBucket(BlockDescriptorBucket& blocks, DescriptorsAllocator* allocator) {
+         bool FeedBlocksBucket(BlockDescriptorBucket& blocks, DescriptorsAllocator* allocator) {
             if (auto span = this->PullSpan(0)) {
                auto spanPtr = span->ptr;
                allocator->CommitSpan(spanPtr, cst::PageSize);
                blocks.PushBlock(BlockDescriptor(spanPtr)->Reset(cst::PageSizeL2));
                this->SlicePageSpan(spanPtr, span->lengthL2, 0, blocks);
+               return true;
+            }
+            return false;
+         }
+      };
+
+      // Per thread cache of blocks (64 bytes to 16KB, the memory context class), exchanged by batch with the allocator
+      // Bins hold 32 small blocks, and about 8KB of bigger blocks (2 at least)
+      struct ThreadCache {
+         static const size_t cSizeL2_Min = BlockDescriptorBucket::cBlockSizeL2_Min;
+         static const size_t cSizeL2_Max = 14;
+         static const size_t cBinCapacity = 32;
+         static const size_t cBinBytes = 8192;
+         static_assert(cSizeL2_Max < cst::PageSizeL2, "thread cached descriptors are page blocks");
+
+         static size_t GetBinCapacity(size_t sizeL2) {
+            auto capacity = cBinBytes >> sizeL2;
+            return capacity > cBinCapacity ? cBinCapacity : (capacity < 2 ? 2 : capacity);
+         }
+
+         struct Bin {
+            BlockDescriptor blocks = 0;
+            uint32_t count = 0;
+         };
+         DescriptorsAllocator* allocator = 0;
+         Bin bins[cSizeL2_Max - cSizeL2_Min + 1];
+
+         DescriptorEntry Allocate(DescriptorsAllocator* allocator, size_t sizeL2) {
+            auto& bin = this->bins[sizeL2 - cSizeL2_Min];
+            if (!bin.blocks) {
+               this->allocator = allocator;
+               allocator->AllocateBatch(sizeL2, GetBinCapacity(sizeL2) / 2, bin);
+            }
+            auto block = bin.blocks;
+            bin.blocks = block->bucketNext;
+            bin.count--;
+            block->typeID = 0;
+            return block;
+         }
+         void Dispose(DescriptorsAllocator* allocator, DescriptorEntry entry) {
+            auto& bin = this->bins[entry->sizeL2 - cSizeL2_Min];
+            auto block = BlockDescriptor(entry);
+            block->typeID = DescriptorTypeID::CachedBlock;
+            block->bucketNext = bin.blocks;
+            bin.blocks = block;
+            auto capacity = GetBinCapacity(entry->sizeL2);
+            if (++bin.count > capacity) {
+               this->allocator = allocator;
+               allocator->DisposeBatch(bin, capacity / 2);
+            }
+         }
+         void Flush() {
+            if (this->allocator) {
+               for (auto& bin : this->bins) {
+                  if (bin.count) this->allocator->DisposeBatch(bin, bin.count);
+               }
             }
          }
       };
@@ -198,17 +240,15 @@ namespace ins::mem {
       BlockDescriptorBucket blocks;
       PageSpanDescriptorBucket spans;
       uint32_t lengthL2 = 0; // length in pages count
+      uint32_t arenas_count = 0;
+      uintptr_t reserve_page = 0; // Page hosting the memory descriptor and the initial block reserve
+      uint8_t reserve_sizeL2 = 0;
       size_t used_bytes = 0;
 
       DescriptorEntry Allocate(size_t sizeL2, size_t usedSizeL2 = 0) {
          std::lock_guard<std::mutex> guard(this->lock);
          if (sizeL2 < cst::PageSizeL2) {
-            auto block = this->blocks.MakeBlock(sizeL2);
-            if (!block) {
-               this->spans.FeedBlocksBucket(this->blocks, this);
-               block = this->blocks.MakeBlock(sizeL2);
-            }
-            _ASSERT(block);
+            auto block = this->AcquireBlock(sizeL2);
             block->typeID = 0;
             return block;
          }
@@ -216,6 +256,11 @@ namespace ins::mem {
             _ASSERT(usedSizeL2 >= cst::PageSizeL2);
             auto lengthL2 = sizeL2 - cst::PageSizeL2;
             auto spanPtr = this->spans.MakeSpan(lengthL2, this->blocks);
+            if (!spanPtr) {
+               this->ExtendArena();
+               spanPtr = this->spans.MakeSpan(lengthL2, this->blocks);
+               if (!spanPtr) throw std::runtime_error("Descriptor too large");
+            }
             this->CommitSpan(spanPtr, size_t(1) << usedSizeL2);
             auto entry = DescriptorEntry(spanPtr);
             entry->typeID = 0;
@@ -224,6 +269,16 @@ namespace ins::mem {
             return entry;
          }
       }
+      void AllocateBatch(size_t sizeL2, size_t count, ThreadCache::Bin& bin) {
+         std::lock_guard<std::mutex> guard(this->lock);
+         for (size_t i = 0; i < count; i++) {
+            auto block = this->AcquireBlock(sizeL2);
+            block->typeID = DescriptorTypeID::CachedBlock;
+            block->bucketNext = bin.blocks;
+            bin.blocks = block;
+         }
+         bin.count += uint32_t(count);
+      }
       void Extends(DescriptorEntry entry, size_t usedSizeL2) {
          if (entry->sizeL2 < usedSizeL2) {
             throw "overflow";
@@ -243,15 +298,24 @@ namespace ins::mem {
          std::lock_guard<std::mutex> guard(this->lock);
          auto sizeL2 = entry->sizeL2;
          if (sizeL2 < cst::PageSizeL2) {
-            this->blocks.PushBlock(BlockDescriptor(entry)->Reset(sizeL2));
+            this->ReleaseBlock(BlockDescriptor(entry));
          }
          else {
             this->DecommitSpan(uintptr_t(entry), size_t(1) << entry->usedSizeL2);
             auto lengthL2 = sizeL2 - cst::PageSizeL2;
-            auto span = PageSpanDescriptor(this->blocks.MakeBlock(6));
+            auto span = PageSpanDescriptor(this->AcquireBlock(6));
             this->spans.PushSpan(span->Reset(uintptr_t(entry), lengthL2));
          }
       }
+      void DisposeBatch(ThreadCache::Bin& bin, size_t count) {
+         std::lock_guard<std::mutex> guard(this->lock);
+         for (size_t i = 0; i < count; i++) {
+            auto block = bin.blocks;
+            bin.blocks = block->bucketNext;
+            this->ReleaseBlock(block);
+         }
+         bin.count -= uint32_t(count);
+      }
       void Initialize(uintptr_t base, uintptr_t offset, uint32_t arena_countL2) {
          this->used_bytes = cst::PageSize;
 
@@ -260,12 +324,33 @@ namespace ins::mem {
          auto block_sizeL2 = bit::log2_floor_64(cst::PageSize - offset);
          auto block = BlockDescriptor(base + cst::PageSize - (size_t(1) << block_sizeL2));
          this->blocks.PushBlock(BlockDescriptor(block)->Reset(block_sizeL2));
+         this->reserve_page = base;
+         this->reserve_sizeL2 = uint8_t(block_sizeL2);
 
          // Register free page spans
+         this->arenas_count = 1;
          this->lengthL2 = arena_countL2 + cst::ArenaSizeL2 - cst::PageSizeL2;
          this->spans.SlicePageSpan(uintptr_t(base), this->lengthL2, 0, blocks);
       }
    private:
+      BlockDescriptor AcquireBlock(size_t sizeL2) {
+         auto block = this->blocks.MakeBlock(sizeL2);
+         if (!block) {
+            if (!this->spans.FeedBlocksBucket(this->blocks, this)) {
+               this->ExtendArena();
+               this->spans.FeedBlocksBucket(this->blocks, this);
+            }
+            block = this->blocks.MakeBlock(sizeL2);
+         }
+         _ASSERT(block);
+         return block;
+      }
+      void ReleaseBlock(BlockDescriptor block) {
+         // Blocks of the reserve page never merge over the reserve (its buddy is the memory descriptor)
+         auto maxSizeL2 = (uintptr_t(block) & ~cst::PageMask) == this->reserve_page ? this->reserve_sizeL2 : cst::PageSizeL2;
+         this->blocks.ReleaseBlock(block, block->sizeL2, maxSizeL2);
+      }
+      void ExtendArena();
       void CommitSpan(uintptr_t ptr, size_t size) {
          this->used_bytes += size;
          os::CommitMemory(ptr, size);
@@ -7,6 +7,53 @@
 using namespace ins;
 using namespace ins::mem;
 
+/**********************************************************************
+*
+*   Descriptors thread cache
+*
+***********************************************************************/
+
+namespace {
+   struct DescriptorsThreadCache : DescriptorsAllocator::ThreadCache {
+      ~DescriptorsThreadCache() {
+         this->Flush();
+         closed = true;
+      }
+      static thread_local bool closed;
+   };
+   thread_local bool DescriptorsThreadCache::closed = false;
+   thread_local DescriptorsThreadCache descriptors_cache;
+}
+
+void mem::DescriptorsAllocator::ExtendArena() {
+   address_t base = mem::ReserveArena();
+   if (!base) throw std::runtime_error("OOM");
+
+   // First page feeds the blocks, it hosts the arena descriptor and the span descriptors
+   this->CommitSpan(base, cst::PageSize);
+   this->blocks.PushBlock(BlockDescriptor(uintptr_t(base))->Reset(cst::PageSizeL2));
+
+   // Register arena
+   auto entry = this->blocks.MakeBlock(sDescriptorEntry::GetBufferSizeL2(sizeof(ArenaDescriptor)));
+   entry->typeID = DescriptorTypeID::Arena;
+   auto arena = new(entry->GetBuffer()) ArenaDescriptor();
+   arena->Initialize(cst::ArenaSizeL2);
+   arena->indice = base.arenaID;
+   arena->availables_count--;
+   arena->regions[0] = RegionLayoutID::DescriptorHeapRegion;
+   mem::RegisterArena(arena);
+
+   // Register free page spans
+   this->spans.SlicePageSpan(uintptr_t(base), cst::ArenaSizeL2 - cst::PageSizeL2, 0, this->blocks);
+   this->arenas_count++;
+}
+
+/**********************************************************************
+*
+*   Descriptor
+*
+***********************************************************************/
+
 BufferBytes mem::sDescriptorEntry::GetBuffer() {
    return BufferBytes(&this[1]);
 }
@@ -29,15 +76,18 @@ BufferBytes mem::Descriptor::AllocateDescriptor(size_t size, size_t usedSize) {
    else if (size >= cst::PageSize) usedSizeL2 = sDescriptorEntry::GetBufferSizeL2(size);
    else usedSizeL2 = cst::PageSizeL2;
 
-   DescriptorEntry result = space->descriptors_allocator.Allocate(sizeL2, usedSizeL2);
+   DescriptorEntry result;
+   if (sizeL2 <= DescriptorsAllocator::ThreadCache::cSizeL2_Max && !DescriptorsThreadCache::closed) {
+      result = descriptors_cache.Allocate(&space->descriptors_allocator, sizeL2);
+   }
+   else {
+      result = space->descriptors_allocator.Allocate(sizeL2, usedSizeL2);
+   }
    _ASSERT(!result || result->sizeL2 == sizeL2);
    _ASSERT(!result || result->usedSizeL2 == 0 || result->usedSizeL2 == usedSizeL2);
    return result->GetBuffer();
 }
 
-mem::Descriptor::Descriptor() {
-}
-
 mem::Descriptor::Descriptor(uint8_t typeID) {
    if (auto header = this->GetEntry()) {
       header->typeID = typeID;
@@ -78,7 +128,12 @@ size_t mem::Descriptor::GetUsedSize() {
 
 void mem::Descriptor::operator delete(void* ptr) {
    if (auto entry = ((Descriptor*)ptr)->GetEntry()) {
-      space->descriptors_allocator.Dispose(entry);
+      if (entry->sizeL2 <= DescriptorsAllocator::ThreadCache::cSizeL2_Max && !DescriptorsThreadCache::closed) {
+         descriptors_cache.Dispose(&space->descriptors_allocator, entry);
+      }
+      else {
+         space->descriptors_allocator.Dispose(entry);
+      }
    }
    else {
       printf("not deletable descriptor");
@@ -1,9 +1,12 @@
+#include <string.h>
 #include <ins/memory/file-view.h>
 #include <ins/memory/map.h>
+#include <ins/os/memory.h>
 
 using namespace ins;
 using namespace ins::mem;
 
+#if defined(_WIN32)
 #define WIN32_LEAN_AND_MEAN
 #include <Windows.h>
 namespace {
@@ -107,6 +110,9 @@ struct Win32DirectFileView : mem::DirectFileView {
    size_t GetExtendSizeLimit()  override final {
       return this->view_size;
    }
+   bool Flush() override final {
+      return FlushViewOfFile((LPCVOID)this->base, this->size) != 0;
+   }
    ~Win32DirectFileView() override {
       UnmapViewOfFile((LPVOID)this->base);
       CloseHandle(this->hSection);
@@ -115,6 +121,7 @@ struct Win32DirectFileView : mem::DirectFileView {
       this->size = 0;
    }
 };
+#endif
 
 using namespace ins;
 
@@ -126,10 +133,173 @@ size_t mem::DirectFileView::GetSize() {
    return this->size;
 }
 
-FileBuffer mem::DirectFileView::MapBuffer(uint32_t offset, size_t size) {
-   return FileBuffer(this->base + offset);
+FileBuffer mem::DirectFileView::MapBuffer(size_t offset, size_t size) {
+   if (offset + size > this->size) {
+      if (this->readOnly || !this->ExtendSize(offset + size)) return FileBuffer();
+   }
+   auto ptr = this->base + offset;
+   os::AdviseSequentialMemory(ptr, size);
+   return FileBuffer(ptr, size);
+}
+
+/**********************************************************************
+*
+*   File Buffer
+*
+***********************************************************************/
+
+FileBuffer& mem::FileBuffer::operator = (FileBuffer&& other) {
+   if (this != &other) {
+      this->Release();
+      this->bytes = other.bytes;
+      this->size = other.size;
+      this->view = other.view;
+      this->window = other.window;
+      other.view = 0;
+      other.window = 0;
+   }
+   return *this;
+}
+
+mem::FileBuffer::~FileBuffer() {
+   this->Release();
+}
+
+void mem::FileBuffer::Release() {
+   if (this->window) {
+      this->view->ReleaseBuffer(this->window);
+   }
+   this->view = 0;
+   this->window = 0;
+}
+
+/**********************************************************************
+*
+*   Windowed File View
+*
+***********************************************************************/
+
+size_t mem::WindowedFileView::GetDescriptorSize(size_t baseSize, size_t size, uint8_t windowSizeL2) {
+   if (windowSizeL2 < cst::PageSizeL2) windowSizeL2 = cst::PageSizeL2;
+   return baseSize + ((size >> windowSizeL2) + 1) * sizeof(Window*);
+}
+
+void mem::WindowedFileView::InitializeWindows(size_t size, uint8_t windowSizeL2, size_t residentWindows, Window** table) {
+   if (windowSizeL2 < cst::PageSizeL2) windowSizeL2 = cst::PageSizeL2;
+   this->size = size;
+   this->windowSizeL2 = windowSizeL2;
+   this->residentWindows = residentWindows;
+   this->windowsCount = (size >> windowSizeL2) + 1;
+   this->windows = table;
+   memset(this->windows, 0, this->windowsCount * sizeof(Window*));
+}
+
+void mem::WindowedFileView::DisposeWindows() {
+   std::lock_guard<std::mutex> guard(this->lock);
+   for (size_t i = 0; i < this->windowsCount; i++) {
+      if (auto window = this->windows[i]) {
+         _ASSERT(window->references == 0);
+         this->UnmapWindow(window->base, window->size);
+         this->windows[i] = 0;
+         delete window;
+      }
+   }
+   this->mappedWindows = 0;
+   this->lru_head = this->lru_tail = 0;
+}
+
+void mem::WindowedFileView::EvictWindows(size_t residentWindows) {
+   while (this->mappedWindows > residentWindows && this->lru_tail) {
+      auto window = this->lru_tail;
+      this->lru_tail = window->lru_prev;
+      if (this->lru_tail) this->lru_tail->lru_next = 0;
+      else this->lru_head = 0;
+      this->UnmapWindow(window->base, window->size);
+      this->windows[window->index] = 0;
+      this->mappedWindows--;
+      delete window;
+   }
+}
+
+size_t mem::WindowedFileView::GetSize() {
+   return this->size;
+}
+
+size_t mem::WindowedFileView::GetExtendSizeLimit() {
+   return this->size;
+}
+
+bool mem::WindowedFileView::ExtendSize(size_t size) {
+   return size <= this->size;
+}
+
+size_t mem::WindowedFileView::GetWindowSize() {
+   return size_t(1) << this->windowSizeL2;
+}
+
+size_t mem::WindowedFileView::GetMappedWindowsCount() {
+   return this->mappedWindows;
+}
+
+void mem::WindowedFileView::SetResidentWindows(size_t count) {
+   std::lock_guard<std::mutex> guard(this->lock);
+   this->residentWindows = count;
+   this->EvictWindows(count);
 }
 
+FileBuffer mem::WindowedFileView::MapBuffer(size_t offset, size_t size) {
+   auto windowSize = size_t(1) << this->windowSizeL2;
+   if (size > windowSize || offset + size > this->size) return FileBuffer();
+   auto index = offset >> this->windowSizeL2;
+   auto windowOffset = index << this->windowSizeL2;
+
+   std::lock_guard<std::mutex> guard(this->lock);
+   auto window = this->windows[index];
+   if (!window) {
+
+      // Map window on 2 window sizes, after making room in the resident budget
+      auto mapSize = this->size - windowOffset;
+      if (mapSize > 2 * windowSize) mapSize = 2 * windowSize;
+      this->EvictWindows(this->residentWindows ? this->residentWindows - 1 : 0);
+      auto base = this->MapWindow(windowOffset, mapSize);
+      if (!base) return FileBuffer();
+
+      window = Descriptor::New<Window>();
+      window->index = index;
+      window->base = base;
+      window->size = mapSize;
+      this->windows[index] = window;
+      this->mappedWindows++;
+   }
+   else if (window->references == 0) {
+
+      // Unlink from the unreferenced windows
+      if (window->lru_prev) window->lru_prev->lru_next = window->lru_next;
+      else this->lru_head = window->lru_next;
+      if (window->lru_next) window->lru_next->lru_prev = window->lru_prev;
+      else this->lru_tail = window->lru_prev;
+      window->lru_prev = window->lru_next = 0;
+   }
+   window->references++;
+   auto ptr = window->base + (offset - windowOffset);
+   return FileBuffer(ptr, size, this, window);
+}
+
+void mem::WindowedFileView::ReleaseBuffer(void* ptr) {
+   auto window = (Window*)ptr;
+   std::lock_guard<std::mutex> guard(this->lock);
+   _ASSERT(window->references > 0);
+   if (--window->references == 0) {
+      window->lru_prev = 0;
+      window->lru_next = this->lru_head;
+      if (this->lru_head) this->lru_head->lru_prev = window;
+      else this->lru_tail = window;
+      this->lru_head = window;
+      this->EvictWindows(this->residentWindows);
+   }
+}
+
+#if defined(_WIN32)
 mem::DirectFileView* mem::DirectFileView::NewReadOnly(const char* filename) {
    __init_section_API();
    HANDLE hFile = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, 0, OPEN_EXISTING, 0, 0);
@@ -167,7 +337,7 @@ mem::DirectFileView* mem::DirectFileView::NewReadOnly(const char* filename) {
    return 0;
 }
 
-mem::DirectFileView* mem::DirectFileView::NewReadWrite(const char* filename, size_t size, bool reset) {
+mem::DirectFileView* mem::DirectFileView::NewReadWrite(const char* filename, size_t size, bool reset, uintptr_t base) {
    __init_section_API();
    HANDLE hFile = CreateFileA(filename, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, 0, reset ? CREATE_ALWAYS : OPEN_ALWAYS, 0, 0);
    if (hFile != INVALID_HANDLE_VALUE) {
@@ -193,7 +363,7 @@ mem::DirectFileView* mem::DirectFileView::NewReadWrite(const char* filename, siz
 
       // Map section on the required view size
       if (status >= 0) {
-         PVOID BaseAddress = 0;
+         PVOID BaseAddress = PVOID(base);
          SIZE_T ViewSize = SIZE_T(view_size);
          auto status = NtMapViewOfSection(hSection, GetCurrentProcess(), &BaseAddress,
             0, 0, 0, &ViewSize, ViewUnmap, MEM_RESERVE, PAGE_READWRITE);
@@ -221,3 +391,257 @@ mem::DirectFileView* mem::DirectFileView::NewReadWrite(const char* filename, siz
    CloseHandle(hFile);
    return false;
 }
+
+mem::DirectFileView* mem::DirectFileView::NewShared(const char* name, size_t size, bool create, uintptr_t base) {
+   return 0; // Not supported: sections cannot be reserved at a fixed base shared by the processes
+}
+
+bool mem::DirectFileView::RemoveShared(const char* name) {
+   return false;
+}
+
+struct Win32WindowedFileView : mem::WindowedFileView {
+   HANDLE hSection = 0;
+   uintptr_t MapWindow(size_t offset, size_t size) override final {
+      return uintptr_t(MapViewOfFile(this->hSection, FILE_MAP_READ, DWORD(uint64_t(offset) >> 32), DWORD(offset), size));
+   }
+   void UnmapWindow(uintptr_t base, size_t size) override final {
+      UnmapViewOfFile((LPVOID)base);
+   }
+   ~Win32WindowedFileView() override {
+      this->DisposeWindows();
+      CloseHandle(this->hSection);
+      this->hSection = 0;
+   }
+};
+
+mem::WindowedFileView* mem::WindowedFileView::NewReadOnly(const char* filename, uint8_t windowSizeL2, size_t residentWindows) {
+   HANDLE hFile = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, 0, OPEN_EXISTING, 0, 0);
+   if (hFile != INVALID_HANDLE_VALUE) {
+      LARGE_INTEGER FileSize;
+      if (GetFileSizeEx(hFile, &FileSize) && FileSize.QuadPart > 0) {
+         if (HANDLE hSection = CreateFileMapping(hFile, 0, PAGE_READONLY, 0, 0, NULL)) {
+            CloseHandle(hFile);
+            auto size = size_t(FileSize.QuadPart);
+            auto view = Descriptor::NewBuffer<Win32WindowedFileView>(GetDescriptorSize(sizeof(Win32WindowedFileView), size, windowSizeL2));
+            view->hSection = hSection;
+            view->InitializeWindows(size, windowSizeL2, residentWindows, (Window**)&view[1]);
+            return view;
+         }
+      }
+   }
+   CloseHandle(hFile);
+   return 0;
+}
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+struct PosixDirectFileView : mem::DirectFileView {
+   int fd = -1;
+   size_t view_size = 0; // Reserved range, on arenas boundaries
+   size_t size_limit = 0;
+   size_t page_size = 0;
+   std::mutex lock;
+   bool ExtendSize(size_t new_size) override final {
+
+      // Check if mapping extension shall be done
+      if (new_size <= this->size) return true;
+      new_size = bit::align(new_size, this->page_size);
+      if (new_size > this->size_limit || this->readOnly) return false;
+      std::lock_guard<std::mutex> guard(lock);
+      if (new_size <= this->size) return true;
+
+      // Grow file, then map the new part in place (base never moves)
+      struct stat st;
+      if (fstat(this->fd, &st) != 0) return false;
+      if (size_t(st.st_size) < new_size && ftruncate(this->fd, off_t(new_size)) != 0) return false;
+      auto ptr = mmap((void*)(this->base + this->size), new_size - this->size,
+         PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, this->fd, off_t(this->size));
+      if (ptr == MAP_FAILED) return false;
+      this->size = new_size;
+      return true;
+   }
+   size_t GetExtendSizeLimit()  override final {
+      return this->size_limit;
+   }
+   bool Flush() override final {
+      return this->readOnly || msync((void*)this->base, this->size, MS_SYNC) == 0;
+   }
+   bool MapBufferAt(uintptr_t address, size_t offset, size_t size) override final {
+      if (this->readOnly || offset + size > this->size) return false;
+      auto ptr = mmap((void*)address, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, this->fd, off_t(offset));
+      return ptr != MAP_FAILED;
+   }
+   bool ReserveView(size_t size_limit, uintptr_t fixed_base = 0) {
+      this->page_size = os::GetSlabSize();
+      this->size_limit = bit::align(size_limit, this->page_size);
+      this->view_size = (this->size_limit + cst::ArenaSize - 1) & ~(cst::ArenaSize - 1);
+      if (fixed_base) {
+         // Reserve exactly at the required base (fails when the range is used)
+         this->base = os::ReserveMemory(fixed_base, fixed_base + this->view_size, this->view_size, cst::ArenaSize);
+      }
+      else {
+         this->base = os::ReserveMemory(0, cst::SpaceSize, this->view_size, cst::ArenaSize);
+      }
+      if (!this->base) return false;
+
+      // Register view arenas, to resolve the view from its addresses
+      address_t base(this->base);
+      for (size_t i = 0; i < (this->view_size >> cst::ArenaSizeL2); i++) {
+         auto arena = Descriptor::New<ArenaDescriptor>(uint8_t(cst::ArenaSizeL2));
+         arena->indice = uint32_t(base.arenaID + i);
+         arena->availables_count = 0;
+         arena->regions[0] = RegionLayoutID::FileViewRegion;
+         arena->owner = this;
+         arena->owner_kind = ArenaOwnerKind::FileView;
+         mem::ArenaMap.Set(arena->indice, ArenaEntry(arena));
+      }
+      return true;
+   }
+   ~PosixDirectFileView() override {
+      if (this->base) {
+         address_t base(this->base);
+         for (size_t i = 0; i < (this->view_size >> cst::ArenaSizeL2); i++) {
+            auto arena = mem::ArenaMap[base.arenaID + i].descriptor();
+            mem::ArenaMap.Set(base.arenaID + i, ArenaEntry(&ArenaDescriptor::UnusedArena));
+            delete arena;
+         }
+         os::ReleaseMemory(this->base, this->view_size);
+      }
+      if (this->fd >= 0) close(this->fd);
+      this->fd = -1;
+      this->base = 0;
+      this->size = 0;
+   }
+};
+
+mem::DirectFileView* mem::DirectFileView::NewReadOnly(const char* filename) {
+   int fd = open(filename, O_RDONLY);
+   if (fd < 0) return 0;
+
+   // Adjust view size to file size
+   struct stat st;
+   if (fstat(fd, &st) != 0) {
+      close(fd);
+      return 0;
+   }
+   auto view = Descriptor::New<PosixDirectFileView>();
+   view->readOnly = true;
+   view->fd = fd;
+   view->size = 0;
+   if (view->ReserveView(st.st_size ? size_t(st.st_size) : 1)) {
+      view->size = view->size_limit;
+      if (mmap((void*)view->base, view->size, PROT_READ, MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED) {
+         return view;
+      }
+   }
+   delete view;
+   return 0;
+}
+
+mem::DirectFileView* mem::DirectFileView::NewReadWrite(const char* filename, size_t size, bool reset, uintptr_t base) {
+   int fd = open(filename, O_RDWR | O_CREAT | (reset ? O_TRUNC : 0), 0644);
+   if (fd < 0) return 0;
+
+   // Adjust used size to file size
+   struct stat st;
+   if (fstat(fd, &st) != 0) {
+      close(fd);
+      return 0;
+   }
+   size_t used_size = size_t(st.st_size);
+   if (used_size < os::GetSlabSize()) used_size = os::GetSlabSize();
+
+   // Reserve the view on the required size, then map the used size
+   auto view = Descriptor::New<PosixDirectFileView>();
+   view->readOnly = false;
+   view->fd = fd;
+   view->size = 0;
+   if (view->ReserveView(size > used_size ? size : used_size, base)) {
+      if (view->ExtendSize(used_size)) {
+         return view;
+      }
+   }
+   delete view;
+   return 0;
+}
+
+mem::DirectFileView* mem::DirectFileView::NewShared(const char* name, size_t size, bool create, uintptr_t base) {
+   int fd = -1;
+   if (name) {
+      fd = shm_open(name, O_RDWR | (create ? O_CREAT | O_EXCL : 0), 0600);
+   }
+#if defined(__linux__)
+   else if (create) {
+      fd = memfd_create("ins.shared", 0);
+   }
+#endif
+   if (fd < 0) return 0;
+
+   // Adjust view size to the shared object size
+   if (!create) {
+      struct stat st;
+      if (fstat(fd, &st) != 0 || st.st_size == 0) {
+         close(fd);
+         return 0;
+      }
+      size = size_t(st.st_size);
+   }
+
+   // Reserve the view, then map the whole object (pages are allocated on first touch)
+   auto view = Descriptor::New<PosixDirectFileView>();
+   view->readOnly = false;
+   view->fd = fd;
+   view->size = 0;
+   if (view->ReserveView(size, base)) {
+      if (!create || ftruncate(fd, off_t(view->size_limit)) == 0) {
+         if (mmap((void*)view->base, view->size_limit, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED) {
+            view->size = view->size_limit;
+            return view;
+         }
+      }
+   }
+   delete view;
+   if (create && name) shm_unlink(name);
+   return 0;
+}
+
+bool mem::DirectFileView::RemoveShared(const char* name) {
+   return shm_unlink(name) == 0;
+}
+
+struct PosixWindowedFileView : mem::WindowedFileView {
+   int fd = -1;
+   uintptr_t MapWindow(size_t offset, size_t size) override final {
+      auto ptr = mmap(0, size, PROT_READ, MAP_SHARED, this->fd, off_t(offset));
+      if (ptr == MAP_FAILED) return 0;
+      return uintptr_t(ptr);
+   }
+   void UnmapWindow(uintptr_t base, size_t size) override final {
+      munmap((void*)base, size);
+   }
+   ~PosixWindowedFileView() override {
+      this->DisposeWindows();
+      if (this->fd >= 0) close(this->fd);
+      this->fd = -1;
+   }
+};
+
+mem::WindowedFileView* mem::WindowedFileView::NewReadOnly(const char* filename, uint8_t windowSizeL2, size_t residentWindows) {
+   int fd = open(filename, O_RDONLY);
+   if (fd < 0) return 0;
+   struct stat st;
+   if (fstat(fd, &st) != 0 || st.st_size == 0) {
+      close(fd);
+      return 0;
+   }
+   auto size = size_t(st.st_size);
+   auto view = Descriptor::NewBuffer<PosixWindowedFileView>(GetDescriptorSize(sizeof(PosixWindowedFileView), size, windowSizeL2));
+   view->fd = fd;
+   view->InitializeWindows(size, windowSizeL2, residentWindows, (Window**)&view[1]);
+   return view;
+}
+#endif
@@ -1,24 +1,60 @@
 #include <ins/memory/map.h>
 #include <ins/os/memory.h>
+#include <string.h>
+#include <math.h>
 #include "./descriptors-allocator.h"
 #include "./regions-allocator.h"
 
 using namespace ins;
 using namespace ins::mem;
 
-ArenaEntry* mem::ArenaMap = 0;
+_INS_CONSTINIT ArenaDirectory mem::ArenaMap;
+_INS_CONSTINIT ArenaRegistry mem::ManagedArenas;
+_INS_CONSTINIT ArenaRegistry mem::UnmanagedArenas;
 mem::MemoryDescriptor* mem::space = 0;
 
-ArenaDescriptor mem::ArenaDescriptor::UnusedArena;
-ArenaDescriptor mem::ArenaDescriptor::ForbiddenArena;
+_INS_CONSTINIT ArenaDescriptor mem::ArenaDescriptor::UnusedArena;
+_INS_CONSTINIT ArenaDescriptor mem::ArenaDescriptor::ForbiddenArena;
 
-mem::RegionsSpaceInitiator::RegionsSpaceInitiator() {
-   mem::InitializeMemory();
+/**********************************************************************
+*
+*   Arena Map
+*
+***********************************************************************/
+
+namespace {
+   ArenaEntry unused_leaf[ArenaDirectory::ArenaPerLeaf];
+   std::mutex leaves_lock;
 }
 
-mem::ArenaDescriptor::ArenaDescriptor()
-   : Descriptor()
-{
+void mem::ArenaDirectory::Initialize() {
+   for (size_t i = 0; i < ArenaPerLeaf; i++) {
+      unused_leaf[i] = ArenaEntry(&ArenaDescriptor::UnusedArena);
+   }
+   for (size_t i = 0; i < LeafPerSpace; i++) {
+      this->leaves[i].store(unused_leaf, std::memory_order_relaxed);
+   }
+}
+
+void mem::ArenaDirectory::Set(uint32_t arenaID, ArenaEntry entry) {
+   auto& slot = this->leaves[arenaID >> ArenaPerLeafL2];
+   auto leaf = slot.load(std::memory_order_acquire);
+   if (leaf == unused_leaf) {
+      std::lock_guard<std::mutex> guard(leaves_lock);
+      leaf = slot.load(std::memory_order_relaxed);
+      if (leaf == unused_leaf) {
+         leaf = (ArenaEntry*)os::AllocateMemory(0, cst::SpaceSize, sizeof(ArenaEntry) * ArenaPerLeaf, cst::PageSize);
+         if (!leaf) throw exception_missing_memory();
+         memcpy(leaf, unused_leaf, sizeof(unused_leaf));
+         slot.store(leaf, std::memory_order_release);
+         this->leaves_count++;
+      }
+   }
+   leaf[arenaID & (ArenaPerLeaf - 1)] = entry;
+}
+
+mem::RegionsSpaceInitiator::RegionsSpaceInitiator() {
+   mem::InitializeMemory();
 }
 
 mem::ArenaDescriptor::ArenaDescriptor(uint8_t segmentation)
@@ -29,20 +65,123 @@ mem::ArenaDescriptor::ArenaDescriptor(uint8_t segmentation)
 }
 
 void mem::ArenaDescriptor::Initialize(uint8_t segmentation) {
+   // Region table is zero in fresh descriptor memory, which reads as free regions
    this->segmentation = segmentation;
    this->availables_count = cst::ArenaSize >> segmentation;
-   memset(this->regions, RegionLayoutID::FreeRegion, this->availables_count);
+}
+
+void mem::ArenaDescriptor::ResetTables() {
+   // Zero the region table, the free maps and the page counters of a recycled descriptor,
+   // whole pages are reset by the system so fresh pages are not touched
+   auto begin = uintptr_t(this->regions);
+   auto end = uintptr_t(this) + GetDescriptorSize(this->segmentation);
+   auto pageBegin = bit::align<uintptr_t>(begin, cst::PageSize);
+   auto pageEnd = end & ~cst::PageMask;
+   if (pageBegin >= pageEnd || !os::ResetMemory(pageBegin, pageEnd - pageBegin)) {
+      memset((void*)begin, 0, end - begin);
+      return;
+   }
+   memset((void*)begin, 0, pageBegin - begin);
+   memset((void*)pageEnd, 0, end - pageEnd);
+}
+
+void mem::ArenaDescriptor::InitializeFreeMaps() {
+   // Region table, maps and page counters are expected zero (fresh descriptor memory or ResetTables)
+   auto count = this->GetRegionCount();
+   auto words = (uint64_t*)bit::align<uintptr_t>(uintptr_t(&this->regions[count]), sizeof(uint64_t));
+   this->frees.Initialize(words, count, true);
+   this->frees_words.Initialize(&words[bit::MultiLevelRunsBitmap64::GetWordCount(count)], count >> 6, true);
+   if (this->segmentation < cst::PageSizeL2) {
+      auto mapsWords = bit::MultiLevelRunsBitmap64::GetWordCount(count) + bit::MultiLevelRunsBitmap64::GetWordCount(count >> 6);
+      this->pages_useds = (std::atomic_uint8_t*)&words[mapsWords];
+   }
+
+   // All regions are free, the first chunk is listed in the maps
+   _ASSERT(this->regions[count - 1].IsFree());
+   this->frees_limit = 0;
+   this->ExtendFreeMaps();
+   this->availables_count = uint32_t(count);
+}
+
+bool mem::ArenaDescriptor::ExtendFreeMaps() {
+   auto count = this->GetRegionCount();
+   if (this->frees_limit >= count) return false;
+   auto limit = std::min(count, size_t(this->frees_limit) + cFreeMapsChunk);
+   this->frees.fill(this->frees_limit, limit);
+   this->frees_words.fill(this->frees_limit >> 6, limit >> 6);
+   this->frees_limit = uint32_t(limit);
+   return true;
+}
+
+intptr_t mem::ArenaDescriptor::FindFreeRegionRange(uint16_t batchSizeL2) {
+
+   // Ranges under 64 regions are found in frees words, bigger ones in frees_words words
+   auto& map = (batchSizeL2 < 6) ? this->frees : this->frees_words;
+   auto rangeL2 = (batchSizeL2 < 6) ? batchSizeL2 : batchSizeL2 - 6;
+   auto unitL2 = (batchSizeL2 < 6) ? 0 : 6;
+   if (rangeL2 > 6) throw "region range too large";
+
+   // Lowest address first, the maps are extended when the listed regions are exhausted
+   do {
+      auto w = map.findRunWord(rangeL2);
+      if (w >= 0) {
+         bit::AlignedHierarchyBitmap64 usebits(~map.word(w));
+         uint64_t selectionMap = usebits.computeAvailabiltyMap(rangeL2);
+         _ASSERT(selectionMap != 0);
+         return ((w << 6) + bit::lsb_64(selectionMap)) << unitL2;
+      }
+   } while (this->ExtendFreeMaps());
+   return -1;
+}
+
+void mem::ArenaDescriptor::AcquireRegionRange(size_t index, size_t count, uint8_t layoutID) {
+   for (size_t i = index; i < index + count; i++) {
+      _ASSERT(this->regions[i].IsFree());
+      if (this->frees.word(i >> 6) == uint64_t(-1)) {
+         this->frees_words.reset(i >> 6);
+      }
+      this->frees.reset(i);
+      this->regions[i] = layoutID;
+   }
+   this->UpdateFreeRuns(index, count);
+   this->availables_count -= uint32_t(count);
+}
+
+void mem::ArenaDescriptor::ReleaseRegionRange(size_t index, size_t count) {
+   for (size_t i = index; i < index + count; i++) {
+      this->regions[i] = RegionLayoutID::FreeRegion;
+      this->frees.set(i);
+      if (this->frees.word(i >> 6) == uint64_t(-1)) {
+         this->frees_words.set(i >> 6);
+      }
+   }
+   this->UpdateFreeRuns(index, count);
+   this->availables_count += uint32_t(count);
+}
+
+void mem::ArenaDescriptor::UpdateFreeRuns(size_t index, size_t count) {
+   auto last = index + count - 1;
+   for (size_t w = index >> 6; w <= (last >> 6); w++) {
+      this->frees.updateRuns(w);
+   }
+   if (this->GetRegionCount() >= 64) {
+      for (size_t w = index >> 12; w <= (last >> 12); w++) {
+         this->frees_words.updateRuns(w);
+      }
+   }
 }
 
 const char* RegionLayoutID::GetLabel() {
-   if (this->value <= RegionLayoutID::Reserved_ObjectRegionMax) {
+   if (this->IsObjectRegion()) {
       return "ObjectRegion";
    }
-   switch (this->value) {
+   switch (uint8_t(*this)) {
    case RegionLayoutID::BufferRegion: return "BufferRegion";
    case RegionLayoutID::DescriptorHeapRegion: return "DescriptorHeapRegion";
+   case RegionLayoutID::FileViewRegion: return "FileViewRegion";
    case RegionLayoutID::FreeRegion: return "FreeRegion";
    case RegionLayoutID::FreeCachedRegion: return "FreeCachedRegion";
+   case RegionLayoutID::FreeDrainingRegion: return "FreeDrainingRegion";
    default: return "(UnkownRegion)";
    }
 }
@@ -53,7 +192,7 @@ const char* RegionLayoutID::GetLabel() {
 *
 ***********************************************************************/
 
-void ArenaClassPool::Initialize(uint8_t index, bool managed) {
+void ArenaClassPool::Initialize(uint8_t index, bool managed, uint8_t numaNode) {
    auto& infos = mem::cst::RegionSizingInfos[index];
    this->sizings[0] = infos.sizings[0];
    this->sizings[1] = infos.sizings[1];
@@ -62,14 +201,38 @@ void ArenaClassPool::Initialize(uint8_t index, bool managed) {
    this->pageSizeL2 = infos.pageSizeL2;
    this->sizeL2 = index;
    this->managed = managed;
+   this->numaNode = numaNode;
    if (this->pageSizeL2 > this->sizeL2) {
       this->batchSizeL2 = this->pageSizeL2 - this->sizeL2;
    }
 }
 
+void ArenaClassPool::SetHugePages(bool enabled) {
+   std::lock_guard<std::mutex> guard(this->lock);
+   auto& infos = mem::cst::RegionSizingInfos[this->sizeL2];
+   auto batchSizeL2 = (infos.pageSizeL2 > this->sizeL2) ? infos.pageSizeL2 - this->sizeL2 : 0;
+   if (batchSizeL2 && this->arenas) {
+      // Batch size is kept once the pool owns arenas: its cached regions and page counters follow it
+      return;
+   }
+   this->hugePages = false;
+   this->batchSizeL2 = batchSizeL2;
+   if (enabled && space->hugePageSizeL2) {
+      if (this->sizeL2 >= space->hugePageSizeL2) {
+         this->hugePages = true;
+      }
+      else if (this->batchSizeL2) {
+         // Small regions are batched by huge page instead of standard page
+         this->hugePages = true;
+         this->batchSizeL2 = space->hugePageSizeL2 - this->sizeL2;
+      }
+   }
+}
+
 void ArenaClassPool::Clean() {
    if (this->batchSizeL2) {
-      printf("Cannot release batched regions\n");
+      this->free_pages = 1;
+      space->purgedBytes += this->ReleaseFreePages(size_t(-1));
    }
    else {
       for (int i = 0; i < 4; i++) {
@@ -80,29 +243,151 @@ void ArenaClassPool::Clean() {
    }
 }
 
+bool ArenaClassPool::RequireBytes(size_t size, IMemoryConsumer* consumer) {
+   auto pools = this->pools;
+   if (!pools) return mem::RequirePhysicalBytes(size, consumer);
+   if (!pools->physicalBytes.Require(size)) {
+      pools->physicalBytes.Reclaim();
+      if (consumer) consumer->RescueStarvingSituation(size);
+      if (!pools->physicalBytes.Require(size)) return false;
+   }
+   if (!mem::RequirePhysicalBytes(size, consumer)) {
+      pools->physicalBytes.Release(size);
+      return false;
+   }
+   return true;
+}
+
+void ArenaClassPool::ForceBytes(size_t size) {
+   if (this->pools) this->pools->physicalBytes.Force(size);
+   space->physicalBytes.Force(size);
+}
+
+void ArenaClassPool::ReleaseBytes(size_t size) {
+   if (this->pools) this->pools->physicalBytes.Release(size);
+   mem::ReleasePhysicalBytes(size);
+}
+
+size_t ArenaClassPool::Purge(double ratio) {
+   size_t purgedBytes = 0;
+   if (this->batchSizeL2) {
+      // Free pages are released for the idle part of the cache only, the reused part stays committed
+      auto idles = this->caches[0].ResetLowWatermark();
+      auto count = size_t(idles * ratio + 0.5);
+      if (idles && !count) count = 1;
+      return count ? this->ReleaseFreePages(count) : 0;
+   }
+   for (int i = 0; i < 4; i++) {
+      auto idles = this->caches[i].ResetLowWatermark();
+      auto count = size_t(idles * ratio + 0.5);
+      if (idles && !count) count = 1;
+
+      // Release the coldest regions, the recently cached ones are the next reused
+      auto region = this->caches[i].PopColdRegions(count);
+      while (region) {
+         auto next = ArenaRegionStack::Next(region);
+         this->ReleaseRegion(region, i);
+         purgedBytes += this->sizings[i].committedSize;
+         space->purgedRegions++;
+         region = next;
+      }
+   }
+   return purgedBytes;
+}
+
+address_t ArenaClassPool::UseBatchedRegion(address_t address) {
+   auto loc = RegionLocation::New(address);
+   loc.arena()->GetPageUseds(loc.index).fetch_add(1, std::memory_order_relaxed);
+   return address;
+}
+
+size_t ArenaClassPool::ReleaseFreePages(size_t maxRegions) {
+   // Release passes are serialized (worker purge and heap cleanup): a drained page shall be released
+   // once, and the drain links stored in the regions shall not be decommitted by another pass
+   std::lock_guard<std::mutex> guard(this->release_lock);
+   if (!this->free_pages.exchange(0)) return 0;
+   auto pageRegions = size_t(1) << (cst::PageSizeL2 - this->sizeL2);
+   size_t releasedBytes = 0;
+
+   // Drain cached regions, a page is releasable when all its regions are drained
+   // (drain links are read before any page of the pass is released, the drain does not count as a reuse)
+   address_t drained;
+   while (auto region = this->caches[0].DrainRegion()) {
+      RegionLocation::New(region).layout() = RegionLayoutID::FreeDrainingRegion;
+      *region.as<address_t>() = drained;
+      drained = region;
+   }
+
+   // Schedule releasable pages up to maxRegions, coldest first (drain chain is in reverse order of the pops)
+   // (release list is chained at the page second word, the first is the drain chain)
+   address_t releaseds;
+   size_t scheduledRegions = 0;
+   while (auto region = drained) {
+      drained = *region.as<address_t>();
+      auto loc = RegionLocation::New(region);
+      auto arena = loc.arena();
+      if (loc.layout() == RegionLayoutID::FreeRegion) {
+         continue; // page already scheduled
+      }
+      auto pageIndex = loc.index & ~(pageRegions - 1);
+      bool releasable = scheduledRegions < maxRegions && !arena->hugePages && arena->GetPageUseds(loc.index).load(std::memory_order_relaxed) == 0;
+      for (size_t i = 0; releasable && i < pageRegions; i++) {
+         releasable = arena->regions[pageIndex + i] == RegionLayoutID::FreeDrainingRegion;
+      }
+      if (releasable) {
+         memset((void*)&arena->regions[pageIndex], 0, pageRegions); // (free regions are zero)
+         auto page = address_t(arena->indice, uint32_t(pageIndex << this->sizeL2));
+         page.as<address_t>()[1] = releaseds;
+         releaseds = page;
+         scheduledRegions += pageRegions;
+      }
+      else {
+         if (arena->GetPageUseds(loc.index).load(std::memory_order_relaxed) == 0) {
+            this->free_pages++;
+         }
+         loc.layout() = RegionLayoutID::FreeCachedRegion;
+         this->caches[0].PushRegion(region);
+      }
+   }
+
+   // Release scheduled pages
+   while (auto page = releaseds) {
+      releaseds = page.as<address_t>()[1];
+      auto loc = RegionLocation::New(page);
+      auto arena = loc.arena();
+      this->DecommitRegionRange(page, cst::PageSize);
+      this->ReleaseBytes(cst::PageSize);
+      releasedBytes += cst::PageSize;
+      space->purgedRegions += pageRegions;
+
+      this->ReleaseRegionRange(arena, loc.index, pageRegions);
+   }
+   return releasedBytes;
+}
+
 address_t ArenaClassPool::AllocateRegion(uint8_t sizingID, IMemoryConsumer* consumer) {
-   if (this->caches[sizingID].size()) {
-      auto addr = this->caches[sizingID].PopRegion();
-      if (addr) return addr;
+   if (auto addr = this->caches[sizingID].PopRegion()) {
+      return this->batchSizeL2 ? this->UseBatchedRegion(addr) : addr;
    }
+   auto batchSizeL2 = this->batchSizeL2;
    auto committedSize = this->sizings[sizingID].committedSize;
-   auto committedCount = committedSize < cst::PageSize ? cst::PageSize / committedSize : 1;
-   if (mem::RequirePhysicalBytes(committedSize, consumer)) {
-      auto ptr = this->AcquireRegionRange(RegionLayoutID::FreeCachedRegion);
-      os::CommitMemory(ptr, committedSize);
-      if (this->batchSizeL2) {
-         auto batchSize = size_t(1) << this->batchSizeL2;
-         for (size_t i = 1; i < batchSize; i++) {
-            auto offset = i << this->sizeL2;
-            this->caches[0].PushRegion(ptr + offset);
-         }
+   if (batchSizeL2) {
+      committedSize = size_t(1) << (this->sizeL2 + batchSizeL2);
+   }
+   if (this->RequireBytes(committedSize, consumer)) {
+      auto ptr = this->AcquireRegionRange(RegionLayoutID::FreeCachedRegion, batchSizeL2);
+      this->CommitRegionRange(ptr, committedSize);
+      if (batchSizeL2) {
+         auto batchSize = size_t(1) << batchSizeL2;
+         auto size = size_t(1) << this->sizeL2;
+         this->caches[0].PushRegions(ptr + size, size, batchSize - 1);
+         return this->UseBatchedRegion(ptr);
       }
       return ptr;
    }
    else {
-      if (this->caches[sizingID].size()) {
-         auto addr = this->caches[sizingID].PopRegion();
-         if (addr) return addr;
+      if (auto addr = this->caches[sizingID].PopRegion()) {
+         return this->batchSizeL2 ? this->UseBatchedRegion(addr) : addr;
       }
       throw mem::exception_missing_memory();
    }
@@ -113,9 +398,8 @@ void ArenaClassPool::DisposeRegion(address_t address, uint8_t sizingID) {
       if (sizingID != 0) throw "not supported";
       this->CacheRegion(address, sizingID);
    }
-   else if (this->caches[sizingID].size() > 1024) {
-      auto committeSize = this->sizings[sizingID].committedSize;
-      this->ReleaseRegion(address, committeSize);
+   else if (this->caches[sizingID].IsFull(1024)) {
+      this->ReleaseRegion(address, sizingID);
    }
    else {
       this->CacheRegion(address, sizingID);
@@ -126,79 +410,151 @@ void ArenaClassPool::CacheRegion(address_t address, uint8_t sizingID) {
    auto loc = RegionLocation::New(address);
    _ASSERT(loc.entry.segmentation == this->sizeL2);
    if (loc.position() != address.position) {
-      throw std::exception("Region mis aligned");
+      throw std::runtime_error("Region mis aligned");
    }
    if (loc.layout().IsFree()) {
-      throw std::exception("Region not free");
+      throw std::runtime_error("Region not free");
    }
    loc.layout() = RegionLayoutID::FreeCachedRegion;
+   if (this->batchSizeL2) {
+      if (loc.arena()->GetPageUseds(loc.index).fetch_sub(1, std::memory_order_relaxed) == 1) {
+         this->free_pages.fetch_add(1, std::memory_order_relaxed);
+      }
+   }
    this->caches[sizingID].PushRegion(address);
 }
 
 void ArenaClassPool::ReleaseRegion(address_t address, uint8_t sizingID) {
    if (this->batchSizeL2) {
+      // Batched regions are released by pages, when all page regions are free
       if (sizingID != 0) throw "not supported";
-      throw "not supported";
+      this->CacheRegion(address, sizingID);
    }
    else {
       this->ReleaseRegionEx(address, this->sizings[sizingID].committedSize);
    }
 }
 
-address_t ArenaClassPool::AcquireRegionRange(uint8_t layoutID) {
-   std::lock_guard<std::mutex> guard(this->lock);
+address_t ArenaClassPool::AcquireRegionRange(uint8_t layoutID, uint16_t batchSizeL2) {
+   auto batchSize = size_t(1) << batchSizeL2;
+
+   for (;;) {
 
-   // Acquire a arena with availables regions
-   auto arena = this->availables;
-   if (!arena) {
-      address_t base = mem::ReserveArena();
-      if (!base) throw std::exception("OOM");
-      arena = Descriptor::NewBuffer<ArenaDescriptor>(ArenaDescriptor::GetDescriptorSize(this->sizeL2), this->sizeL2);
-      arena->indice = base.arenaID;
-      arena->next = this->availables;
-      if (this->managed) {
-         auto bitmapLen = arena->availables_count * 8;
-         arena->managed = true;
+      // Acquire a arena with availables regions
+      auto arena = this->availables.load(std::memory_order_acquire);
+      if (!arena) {
+         arena = this->CreateArena();
       }
-      this->availables = arena;
-      space->arenas_map[base.arenaID] = arena;
-   }
-
-   // Remove arena from availables list
-   if (0 == --arena->availables_count) {
-      this->availables = arena->next;
-      arena->next = 0;
-   }
-
-   // Find free region in arena 
-   auto size = size_t(1) << this->sizeL2;
-   auto regionPerArena = cst::ArenaSize >> this->sizeL2;
-   auto scan_position = arena->availables_scan_position;
-   for (int c = 0; c < regionPerArena; c++) {
-      auto index = scan_position;
-      if ((++scan_position) >= regionPerArena) scan_position = 0;
-      if (arena->regions[index].IsFree()) {
-         address_t ptr(arena->indice, index * size);
-         if (this->batchSizeL2) {
-            auto batchSize = size_t(1) << this->batchSizeL2;
-            _ASSERT(index % batchSize == 0);
-            for (int i = 0; i < batchSize; i++) {
-               arena->regions[index + i] = layoutID;
-            }
+
+      // Find free region range in arena (the pool lock is not held, only the arena one)
+      {
+         std::lock_guard<std::mutex> guard(this->GetArenaLock(arena));
+         if (this->hugePages && !arena->hugePages) {
+            arena->hugePages = os::AdviseHugeMemory(arena->GetBase(), cst::ArenaSize) || space->hugePagesMode == HugePagesMode::Explicit;
          }
-         else {
-            arena->regions[index] = layoutID;
+         if (arena->availables_count >= batchSize) {
+            auto index = arena->FindFreeRegionRange(batchSizeL2);
+            if (index >= 0) {
+               arena->AcquireRegionRange(index, batchSize, layoutID);
+               return address_t(arena->indice, uint32_t(size_t(index) << this->sizeL2));
+            }
          }
-         arena->availables_scan_position = scan_position;
-         return ptr;
       }
+
+      // Remove exhausted arena from availables list
+      this->UnlistArena(arena, batchSizeL2);
+   }
+}
+
+void ArenaClassPool::ReleaseRegionRange(ArenaDescriptor* arena, size_t index, size_t count) {
+   {
+      std::lock_guard<std::mutex> guard(this->GetArenaLock(arena));
+      arena->ReleaseRegionRange(index, count);
+      if (arena->availables_listed) return;
+   }
+
+   // Relist the arena, it was exhausted
+   // (the listed flag changes under both locks: a listed arena seen here is not unlisted with these regions free)
+   std::lock_guard<std::mutex> guard(this->lock);
+   std::lock_guard<std::mutex> arena_guard(this->GetArenaLock(arena));
+   if (!arena->availables_listed) {
+      arena->availables_listed = true;
+      arena->next = this->availables.load(std::memory_order_relaxed);
+      this->availables.store(arena, std::memory_order_release);
+   }
+}
+
+ArenaDescriptor* ArenaClassPool::CreateArena() {
+   std::lock_guard<std::mutex> guard(this->lock);
+   if (auto arena = this->availables.load(std::memory_order_relaxed)) {
+      return arena; // Created or relisted by another thread
+   }
+   address_t base = mem::ReserveArena();
+   if (!base) throw std::runtime_error("OOM");
+   auto arena = Descriptor::NewBuffer<ArenaDescriptor>(ArenaDescriptor::GetDescriptorSize(this->sizeL2), this->sizeL2);
+   arena->ResetTables();
+   arena->InitializeFreeMaps();
+   arena->indice = base.arenaID;
+   arena->numaNode = this->numaNode;
+   arena->next = 0;
+   arena->pool = this;
+   arena->next_pooled = this->arenas;
+   this->arenas = arena;
+   if (space->nodes_count > 1 && !this->pools) {
+      os::BindMemoryToNumaNode(base, cst::ArenaSize, this->numaNode % space->nodes_physical_count);
    }
-   throw std::exception("crash");
+   if (this->managed) {
+      arena->managed = true;
+   }
+   arena->availables_listed = true;
+   mem::RegisterArena(arena);
+   this->availables.store(arena, std::memory_order_release);
+   return arena;
+}
+
+void ArenaClassPool::UnlistArena(ArenaDescriptor* arena, uint16_t batchSizeL2) {
+   std::lock_guard<std::mutex> guard(this->lock);
+   if (this->availables.load(std::memory_order_relaxed) != arena) {
+      return; // Already unlisted, or covered by a relisted arena
+   }
+
+   // Regions may have been released since the failed search
+   std::lock_guard<std::mutex> arena_guard(this->GetArenaLock(arena));
+   if (arena->availables_count >= (size_t(1) << batchSizeL2) && arena->FindFreeRegionRange(batchSizeL2) >= 0) {
+      return;
+   }
+   arena->availables_listed = false;
+   this->availables.store(arena->next, std::memory_order_relaxed);
+   arena->next = 0;
 }
 
 address_t ArenaClassPool::ReserveRegion() {
    if (this->batchSizeL2) throw "cannot reserve batched region";
-   return this->AcquireRegionRange(RegionLayoutID::BufferRegion);
+   return this->AcquireRegionRange(RegionLayoutID::BufferRegion, 0);
+}
+
+void ArenaClassPool::ReleaseReservedRegion(address_t address) {
+   // Reserved regions are not accounted, the pages committed by their owner are decommitted
+   if (this->batchSizeL2) throw "cannot release batched region";
+   this->ReleaseRegionEx(address, size_t(1) << this->sizeL2, false);
+}
+
+void ArenaClassPool::CommitRegionRange(address_t address, size_t size) {
+   auto arena = RegionLocation::New(address).arena();
+   if (arena->hugePages && space->hugePagesMode == HugePagesMode::Explicit) {
+      auto hugeSize = size & ~((size_t(1) << space->hugePageSizeL2) - 1);
+      if (hugeSize && os::CommitHugeMemory(address, hugeSize)) {
+         if (size > hugeSize) os::CommitMemory(address + hugeSize, size - hugeSize);
+         return;
+      }
+   }
+   os::CommitMemory(address, size);
+}
+
+void ArenaClassPool::DecommitRegionRange(address_t address, size_t size) {
+   auto arena = RegionLocation::New(address).arena();
+   if (arena->hugePages) os::DecommitHugeMemory(address, size);
+   else os::DecommitMemory(address, size);
 }
 
 address_t ArenaClassPool::AllocateRegionEx(size_t size, IMemoryConsumer* consumer) {
@@ -213,10 +569,10 @@ address_t ArenaClassPool::AllocateRegionEx(size_t size, IMemoryConsumer* consume
       }
    }
    auto committedSize = pages << this->pageSizeL2;
-   if (mem::RequirePhysicalBytes(committedSize, consumer)) {
+   if (this->RequireBytes(committedSize, consumer)) {
       auto address = this->ReserveRegion();
       _ASSERT(committedSize <= this->sizings[0].committedSize);
-      os::CommitMemory(address, committedSize);
+      this->CommitRegionRange(address, committedSize);
       return address;
    }
    else {
@@ -235,22 +591,24 @@ void ArenaClassPool::DisposeRegionEx(address_t address, size_t size) {
          return this->DisposeRegion(address, i);
       }
    }
-   this->ReleaseRegion(address, pages << this->pageSizeL2);
+   this->ReleaseRegionEx(address, pages << this->pageSizeL2);
 }
 
-void ArenaClassPool::ReleaseRegionEx(address_t address, size_t size) {
+void ArenaClassPool::ReleaseRegionEx(address_t address, size_t size, bool accounted) {
    auto loc = RegionLocation::New(address);
    _ASSERT(loc.entry.segmentation == this->sizeL2);
    if (loc.position() != address.position) {
-      throw std::exception("Region mis aligned");
+      throw std::runtime_error("Region mis aligned");
    }
    if (loc.layout().IsFree()) {
-      throw std::exception("Region not free");
+      throw std::runtime_error("Region not free");
    }
    loc.layout() = RegionLayoutID::FreeCachedRegion;
-   os::DecommitMemory(address.ptr, size);
-   mem::ReleasePhysicalBytes(size);
-   loc.layout() = RegionLayoutID::FreeRegion;
+   this->DecommitRegionRange(address, size);
+   if (accounted) this->ReleaseBytes(size);
+
+   // Give back region to arena
+   this->ReleaseRegionRange(loc.arena(), size_t(address.position) >> this->sizeL2, 1);
 }
 
 /**********************************************************************
@@ -266,43 +624,138 @@ static size_t GetBufferRegionSizing(size_t size) {
 void mem::InitializeMemory() {
    if (!space) {
       space = MemoryDescriptor::New();
-      mem::ArenaMap = space->arenas_map;
+      space->SetNodesCount(space->nodes_physical_count);
+
+      // Follow the process memory limit (cgroup v2 on linux, job object on win32)
+      if (auto limit = os::GetMemoryLimit()) {
+         space->physicalBytes.maxBytes = limit;
+      }
+   }
+}
+
+void MemoryDescriptor::SetNodesCount(uint8_t count) {
+   std::lock_guard<std::mutex> guard(this->lock);
+   if (count < this->nodes_physical_count) count = this->nodes_physical_count;
+   if (count > cst::NumaNodeMax) count = cst::NumaNodeMax;
+   for (uint8_t i = 0; i < count; i++) {
+      if (!this->nodes[i]) {
+         auto pools = Descriptor::New<ArenaNodePools>();
+         pools->Initialize(i);
+         pools->SetHugePages(this->hugePagesMode != HugePagesMode::Disabled);
+         this->nodes[i] = pools;
+      }
    }
+   this->nodes_count = count;
 }
 
 void mem::SetMaxUsablePhysicalBytes(size_t size) {
-   space->maxUsablePhysicalBytes = size;
+   space->physicalBytes.maxBytes = size;
 }
 
 size_t mem::GetMaxUsablePhysicalBytes() {
-   return space->maxUsablePhysicalBytes;
+   return space->physicalBytes.maxBytes;
+}
+
+void mem::SetPhysicalBytesSlack(size_t slack) {
+   space->physicalBytes.leaseSize = bit::align<size_t>(slack / (2 * cst::PhysicalBytesLeaseCount), cst::PageSize);
+   space->physicalBytes.Reclaim();
+}
+
+size_t mem::GetPhysicalBytesSlack() {
+   return space->physicalBytes.leaseSize * 2 * cst::PhysicalBytesLeaseCount;
+}
+
+void mem::SetHugePagesOption(HugePagesMode mode) {
+   if (!space->hugePageSizeL2) mode = HugePagesMode::Disabled;
+   space->hugePagesMode = mode;
+
+   bool enabled = (mode != HugePagesMode::Disabled);
+   for (int n = 0; n < space->nodes_count; n++) {
+      space->nodes[n]->SetHugePages(enabled);
+   }
+}
+
+HugePagesMode mem::GetHugePagesOption() {
+   return space->hugePagesMode;
 }
 
 bool mem::RequirePhysicalBytes(size_t size, IMemoryConsumer* consumer) {
-   space->usedPhysicalBytes += size;
-   if (space->usedPhysicalBytes > space->maxUsablePhysicalBytes) {
+   if (space->physicalBytes.Require(size)) {
+      return true;
+   }
+
+   // Give back the leased bytes to reach the exact limit
+   space->physicalBytes.Reclaim();
+   if (space->physicalBytes.Require(size)) {
+      return true;
+   }
+   if (consumer) {
       consumer->RescueStarvingSituation(size);
-      if (space->usedPhysicalBytes > space->maxUsablePhysicalBytes) {
-         space->usedPhysicalBytes -= size;
-         return false;
-      }
    }
-   return true;
+   return space->physicalBytes.Require(size);
 }
 
 void mem::ReleasePhysicalBytes(size_t size) {
-   space->usedPhysicalBytes -= size;
+   space->physicalBytes.Release(size);
 }
 
 size_t mem::GetUsedPhysicalBytes() {
-   return space->usedPhysicalBytes;
+   return space->physicalBytes.GetUsedBytes();
+}
+
+size_t mem::ReconcilePhysicalBytes() {
+   if (!space->physicalBytes.reconciled) return 0;
+   auto residentBytes = os::GetResidentMemorySize();
+   if (residentBytes) {
+      space->physicalBytes.Reconcile(residentBytes);
+   }
+   return residentBytes;
+}
+
+bool mem::IsPhysicalBytesSoftLimitReached() {
+   return space->physicalBytes.IsSoftLimitReached();
+}
+
+void mem::SetPhysicalBytesReconciliation(bool enabled) {
+   space->physicalBytes.reconciled = enabled;
+   space->physicalBytes.Reconcile(enabled ? os::GetResidentMemorySize() : size_t(-1));
+}
+
+bool mem::CommitRegionPages(address_t address, size_t size, IMemoryConsumer* consumer) {
+   _ASSERT((address.position & cst::PageMask) == 0 && (size & cst::PageMask) == 0);
+   auto arena = mem::ArenaMap[address.arenaID].descriptor();
+   if (arena->hugePages || arena->owner) {
+      return false; // Huge pages and file backed arenas are not paged
+   }
+   if (consumer) {
+      if (!arena->pool->RequireBytes(size, consumer)) return false;
+   }
+   else {
+      arena->pool->ForceBytes(size);
+   }
+   os::CommitMemory(address, size);
+   return true;
+}
+
+bool mem::DecommitRegionPages(address_t address, size_t size) {
+   _ASSERT((address.position & cst::PageMask) == 0 && (size & cst::PageMask) == 0);
+   auto arena = mem::ArenaMap[address.arenaID].descriptor();
+   if (arena->hugePages || arena->owner) {
+      return false; // Huge pages and file backed arenas are not paged
+   }
+   os::DecommitMemory(address, size);
+   arena->pool->ReleaseBytes(size);
+   return true;
 }
 
 Descriptor* mem::GetRegionDescriptor(address_t address) {
-   if (auto arena = space->arenas_map[address.arenaID]) {
-      auto regionID = address.position >> arena.segmentation;
+   if (auto arena = mem::ArenaMap[address.arenaID]) {
+      auto regionID = uintptr_t(address.position) >> arena.segmentation;
       auto regionEntry = arena.descriptor()->regions[regionID];
-      if (!regionEntry.IsFree()) {
+      if (regionEntry == RegionLayoutID::FileViewRegion) {
+         return arena.descriptor()->owner;
+      }
+      else if (!regionEntry.IsFree()) {
          address.position = regionID << arena.segmentation;
          return (Descriptor*)address.ptr;
       }
@@ -311,7 +764,7 @@ Descriptor* mem::GetRegionDescriptor(address_t address) {
 }
 
 size_t mem::GetRegionSize(address_t address) {
-   auto arena = space->arenas_map[address.arenaID];
+   auto arena = mem::ArenaMap[address.arenaID];
    return size_t(1) << arena.segmentation;
 }
 
@@ -319,106 +772,290 @@ address_t mem::ReserveArena() {
    return os::ReserveMemory(0, cst::SpaceSize, cst::ArenaSize, cst::ArenaSize);
 }
 
-address_t mem::ReserveUnmanagedRegion(uint8_t sizeL2) {
-   return space->arenas_unmanaged[sizeL2].ReserveRegion();
+void mem::RegisterArena(ArenaDescriptor* arena) {
+   mem::ArenaMap.Set(arena->indice, ArenaEntry(arena));
+   if (arena->managed) mem::ManagedArenas.Register(arena->indice);
+   else mem::UnmanagedArenas.Register(arena->indice);
+}
+
+uint8_t mem::GetNumaNodeCount() {
+   return space->nodes_count;
+}
+
+uint8_t mem::GetCurrentNumaNode() {
+   return uint8_t(os::GetCurrentNumaNode() % space->nodes_count);
+}
+
+uint8_t mem::GetRegionNumaNode(address_t address) {
+   return mem::ArenaMap[address.arenaID].descriptor()->numaNode;
+}
+
+void mem::SetNumaNodesOption(uint8_t count) {
+   space->SetNodesCount(count);
+}
+
+address_t mem::ReserveUnmanagedRegion(uint8_t sizeL2, uint8_t numaNode) {
+   return space->GetNodePools(numaNode).arenas_unmanaged[sizeL2].ReserveRegion();
+}
+
+address_t mem::ReserveManagedRegion(uint8_t sizeL2, uint8_t numaNode) {
+   return space->GetNodePools(numaNode).arenas_managed[sizeL2].ReserveRegion();
 }
 
-address_t mem::ReserveManagedRegion(uint8_t sizeL2) {
-   return space->arenas_managed[sizeL2].ReserveRegion();
+void mem::ReleaseReservedRegion(address_t address, uint8_t sizeL2) {
+   auto arena = mem::ArenaMap[address.arenaID];
+   if (arena.segmentation != sizeL2) {
+      throw "invalid sizeL2";
+   }
+   else {
+      arena.descriptor()->pool->ReleaseReservedRegion(address);
+   }
 }
 
-address_t mem::AllocateUnmanagedRegion(uint8_t sizeL2, uint8_t sizingID, IMemoryConsumer* consumer) {
-   return space->arenas_unmanaged[sizeL2].AllocateRegion(sizingID, consumer);
+address_t mem::AllocateUnmanagedRegion(uint8_t sizeL2, uint8_t sizingID, IMemoryConsumer* consumer, uint8_t numaNode) {
+   return space->GetNodePools(numaNode).arenas_unmanaged[sizeL2].AllocateRegion(sizingID, consumer);
 }
 
-address_t mem::AllocateManagedRegion(uint8_t sizeL2, uint8_t sizingID, IMemoryConsumer* consumer) {
-   return space->arenas_managed[sizeL2].AllocateRegion(sizingID, consumer);
+address_t mem::AllocateManagedRegion(uint8_t sizeL2, uint8_t sizingID, IMemoryConsumer* consumer, uint8_t numaNode) {
+   return space->GetNodePools(numaNode).arenas_managed[sizeL2].AllocateRegion(sizingID, consumer);
 }
 
 void mem::ReleaseRegion(address_t address, uint8_t sizeL2, uint8_t sizingID) {
-   auto arena = space->arenas_map[address.arenaID];
+   auto arena = mem::ArenaMap[address.arenaID];
    if (arena.segmentation != sizeL2) {
       throw "invalid sizeL2";
    }
    else {
-      auto list = arena.managed ? space->arenas_managed : space->arenas_unmanaged;
-      list[arena.segmentation].ReleaseRegion(address, sizingID);
+      arena.descriptor()->pool->ReleaseRegion(address, sizingID);
    }
 }
 
 void mem::DisposeRegion(address_t address, uint8_t sizeL2, uint8_t sizingID) {
-   auto arena = space->arenas_map[address.arenaID];
+   auto arena = mem::ArenaMap[address.arenaID];
    if (arena.segmentation != sizeL2) {
       throw "invalid sizeL2";
    }
    else {
-      auto list = arena.managed ? space->arenas_managed : space->arenas_unmanaged;
-      list[arena.segmentation].DisposeRegion(address, sizingID);
+      arena.descriptor()->pool->DisposeRegion(address, sizingID);
    }
 }
 
-address_t mem::AllocateUnmanagedRegionEx(size_t size, IMemoryConsumer* consumer) {
+address_t mem::AllocateUnmanagedRegionEx(size_t size, IMemoryConsumer* consumer, uint8_t numaNode) {
    auto sizeL2 = GetBufferRegionSizing(size);
-   return space->arenas_unmanaged[sizeL2].AllocateRegionEx(size, consumer);
+   return space->GetNodePools(numaNode).arenas_unmanaged[sizeL2].AllocateRegionEx(size, consumer);
 }
 
-address_t mem::AllocateManagedRegionEx(size_t size, IMemoryConsumer* consumer) {
+address_t mem::AllocateManagedRegionEx(size_t size, IMemoryConsumer* consumer, uint8_t numaNode) {
    auto sizeL2 = GetBufferRegionSizing(size);
-   return space->arenas_managed[sizeL2].AllocateRegionEx(size, consumer);
+   return space->GetNodePools(numaNode).arenas_managed[sizeL2].AllocateRegionEx(size, consumer);
 }
 
 void mem::ReleaseRegionEx(address_t address, size_t size) {
-   auto arena = space->arenas_map[address.arenaID];
+   auto arena = mem::ArenaMap[address.arenaID];
    auto sizeL2 = GetBufferRegionSizing(size);
    if (arena.segmentation != sizeL2) {
       throw "invalid sizeL2";
    }
    else {
-      auto list = arena.managed ? space->arenas_managed : space->arenas_unmanaged;
-      list[arena.segmentation].ReleaseRegionEx(address, size);
+      arena.descriptor()->pool->ReleaseRegionEx(address, size);
    }
 }
 
 void mem::DisposeRegionEx(address_t address, size_t size) {
-   auto arena = space->arenas_map[address.arenaID];
+   auto arena = mem::ArenaMap[address.arenaID];
    auto sizeL2 = GetBufferRegionSizing(size);
    if (arena.segmentation != sizeL2) {
       throw "invalid sizeL2";
    }
    else {
-      auto list = arena.managed ? space->arenas_managed : space->arenas_unmanaged;
-      list[arena.segmentation].DisposeRegionEx(address, size);
+      arena.descriptor()->pool->DisposeRegionEx(address, size);
+   }
+}
+
+void mem::SetCachePurgeOptions(uint32_t halfLifeMs, uint32_t periodMs) {
+   space->purgeHalfLifeMs = halfLifeMs;
+   space->purgePeriodMs = periodMs ? periodMs : 1;
+}
+
+uint32_t mem::GetCachePurgePeriod() {
+   return space->purgeHalfLifeMs ? space->purgePeriodMs : 0;
+}
+
+static double GetPurgeRatio(uint32_t elapsedMs) {
+   // Part of idle regions to purge: 1 - 2^(-elapsed/halflife)
+   return 1.0 - exp2(-double(elapsedMs) / double(space->purgeHalfLifeMs));
+}
+
+size_t mem::PurgeCachedRegions(uint32_t elapsedMs) {
+   if (!space->purgeHalfLifeMs) return 0;
+   double ratio = GetPurgeRatio(elapsedMs);
+   size_t purgedBytes = 0;
+   for (int n = 0; n < space->nodes_count; n++) {
+      purgedBytes += space->nodes[n]->Purge(ratio);
    }
+   space->purgedBytes += purgedBytes;
+   return purgedBytes;
 }
 
 void mem::PerformRegionsCleanup() {
+   for (int n = 0; n < space->nodes_count; n++) {
+      space->nodes[n]->Clean();
+   }
+}
+
+/**********************************************************************
+*
+*   Region Pools
+*
+***********************************************************************/
+
+RegionPools* mem::CreateRegionPools(size_t maxPhysicalBytes) {
+   mem::InitializeMemory();
+   auto pools = Descriptor::New<RegionPools>(maxPhysicalBytes);
+   pools->classes.SetHugePages(space->hugePagesMode != HugePagesMode::Disabled);
+   return pools;
+}
+
+void mem::DeleteRegionPools(RegionPools* pools) {
+   auto unregisterArenas = [](ArenaClassPool& pool) {
+      for (auto arena = pool.arenas; arena; arena = arena->next_pooled) {
+         auto arenaID = arena->indice;
+         mem::ArenaMap.Set(arenaID, ArenaEntry(&ArenaDescriptor::UnusedArena));
+         if (arena->managed) mem::ManagedArenas.Unregister(arenaID);
+         else mem::UnmanagedArenas.Unregister(arenaID);
+      }
+   };
+   auto releaseArenas = [](ArenaClassPool& pool) {
+      while (auto arena = pool.arenas) {
+         pool.arenas = arena->next_pooled;
+         os::ReleaseMemory(arena->GetBase(), cst::ArenaSize);
+         delete arena;
+      }
+   };
+   for (int i = 0; i < cst::RegionSizingCount; i++) {
+      unregisterArenas(pools->classes.arenas_unmanaged[i]);
+      unregisterArenas(pools->classes.arenas_managed[i]);
+   }
+
+   // Visitors of the registries may still walk the arenas
+   mem::UnmanagedArenas.Synchronize();
+   mem::ManagedArenas.Synchronize();
    for (int i = 0; i < cst::RegionSizingCount; i++) {
-      space->arenas_unmanaged[i].Clean();
-      space->arenas_managed[i].Clean();
+      releaseArenas(pools->classes.arenas_unmanaged[i]);
+      releaseArenas(pools->classes.arenas_managed[i]);
    }
+   mem::ReleasePhysicalBytes(pools->physicalBytes.GetUsedBytes());
+   delete pools;
+}
+
+RegionPools* mem::GetRegionPools(address_t address) {
+   auto pool = mem::ArenaMap[address.arenaID].descriptor()->pool;
+   return pool ? pool->pools : 0;
+}
+
+size_t mem::GetRegionPoolsUsedBytes(RegionPools* pools) {
+   return pools->physicalBytes.GetUsedBytes();
+}
+
+size_t mem::PurgeRegionPools(RegionPools* pools, uint32_t elapsedMs) {
+   if (!space->purgeHalfLifeMs) return 0;
+   auto purgedBytes = pools->classes.Purge(GetPurgeRatio(elapsedMs));
+   space->purgedBytes += purgedBytes;
+   return purgedBytes;
+}
+
+void mem::CleanRegionPools(RegionPools* pools) {
+   pools->classes.Clean();
+}
+
+void mem::ForeachArena(RegionPools* pools, std::function<bool(ArenaDescriptor* arena)>&& visitor) {
+   auto visitArenas = [&](ArenaClassPool& pool) {
+      for (auto arena = pool.arenas; arena; arena = arena->next_pooled) {
+         if (!visitor(arena)) return false;
+      }
+      return true;
+   };
+   for (int i = 0; i < cst::RegionSizingCount; i++) {
+      if (!visitArenas(pools->classes.arenas_unmanaged[i])) return;
+      if (!visitArenas(pools->classes.arenas_managed[i])) return;
+   }
+}
+
+address_t mem::AllocateUnmanagedRegion(RegionPools* pools, uint8_t sizeL2, uint8_t sizingID, IMemoryConsumer* consumer) {
+   return pools->classes.arenas_unmanaged[sizeL2].AllocateRegion(sizingID, consumer);
+}
+
+address_t mem::AllocateManagedRegion(RegionPools* pools, uint8_t sizeL2, uint8_t sizingID, IMemoryConsumer* consumer) {
+   return pools->classes.arenas_managed[sizeL2].AllocateRegion(sizingID, consumer);
+}
+
+address_t mem::AllocateUnmanagedRegionEx(RegionPools* pools, size_t size, IMemoryConsumer* consumer) {
+   auto sizeL2 = GetBufferRegionSizing(size);
+   return pools->classes.arenas_unmanaged[sizeL2].AllocateRegionEx(size, consumer);
+}
+
+address_t mem::AllocateManagedRegionEx(RegionPools* pools, size_t size, IMemoryConsumer* consumer) {
+   auto sizeL2 = GetBufferRegionSizing(size);
+   return pools->classes.arenas_managed[sizeL2].AllocateRegionEx(size, consumer);
 }
 
 void mem::ForeachRegion(std::function<bool(ArenaDescriptor* arena, RegionLayoutID layout, address_t addr)>&& visitor) {
-   for (address_t addr; addr.arenaID < cst::ArenaPerSpace; addr.arenaID++) {
-      auto arena = space->arenas_map[addr.arenaID].descriptor();
+   auto visitArena = [&](uint32_t arenaID) {
+      auto arena = mem::ArenaMap[arenaID].descriptor();
       auto region_size = size_t(1) << arena->segmentation;
-      auto region_count = arena->GetRegionCount();
-      addr.position = 0;
+      auto region_count = arena->GetRegionLimit();
       for (size_t regionID = 0; regionID < region_count; regionID++) {
+
+         // Skip fully free region words
+         if ((regionID & 63) == 0 && arena->frees.words && arena->frees.word(regionID >> 6) == uint64_t(-1)) {
+            regionID += 63;
+            continue;
+         }
          auto& region_entry = arena->regions[regionID];
          if (!region_entry.IsFree()) {
-            if (!visitor(arena, region_entry, addr)) return;
+            address_t addr(arenaID, uint32_t(regionID * region_size));
+            if (!visitor(arena, region_entry, addr)) return false;
          }
-         addr.position += region_size;
       }
+      return true;
+   };
+   if (mem::UnmanagedArenas.Foreach(visitArena)) {
+      mem::ManagedArenas.Foreach(visitArena);
    }
 }
 
 tMemoryStats mem::GetMemoryStats() {
    tMemoryStats stats;
    stats.descriptors_used_bytes = space->descriptors_allocator.used_bytes;
-   stats.arenas_map_used_bytes = sizeof(ArenaEntry) * cst::ArenaPerSpace;
-   stats.used_bytes = space->usedPhysicalBytes;
+   stats.arenas_map_used_bytes = mem::ArenaMap.GetUsedBytes();
+   stats.used_bytes = space->physicalBytes.GetUsedBytes();
+   stats.leased_bytes = space->physicalBytes.GetLeasedBytes();
+   stats.untouched_bytes = space->physicalBytes.GetUntouchedBytes();
+   stats.resident_bytes = os::GetResidentMemorySize();
+   stats.purged_bytes = space->purgedBytes;
+   stats.purged_regions = space->purgedRegions;
+   stats.cold_bytes = mem::GetColdBytes();
+   stats.cold_regions = mem::GetColdRegionsCount();
+   if (space->hugePageSizeL2) {
+      stats.huge_page_size = size_t(1) << space->hugePageSizeL2;
+   }
+   if (space->hugePagesMode != HugePagesMode::Disabled) {
+      size_t huge_bytes = 0;
+      os::EnumerateHugeMemoryZone(
+         [&](uintptr_t address, uintptr_t size, uintptr_t hugeBytes) {
+            // Count only zones overlapping a used arena
+            auto end = address + size;
+            auto lastArenaID = (end - 1) >> cst::ArenaSizeL2;
+            if (lastArenaID >= cst::ArenaPerSpace) lastArenaID = cst::ArenaPerSpace - 1;
+            bool used = false;
+            for (auto arenaID = address >> cst::ArenaSizeL2; !used && arenaID <= lastArenaID; arenaID++) {
+               used = mem::ArenaMap[arenaID].descriptor() != &ArenaDescriptor::UnusedArena;
+            }
+            if (used) huge_bytes += hugeBytes;
+         }
+      );
+      stats.huge_pages_count = huge_bytes >> space->hugePageSizeL2;
+   }
    return stats;
 }
 
@@ -1,37 +1,257 @@
 #pragma once
+#include <ins/os/threading.h>
+#include <atomic>
+#include <thread>
 
 namespace ins::mem {
 
    /**********************************************************************
    *
-   *   Arena Region Cache
+   *   Arena Region Stack
+   *   (lock-free region list, ABA safe with a version tag packed beside the region link)
    *
    ***********************************************************************/
-   struct ArenaRegionCache {
+   // The head packs the region address shifted by the region alignment (regions are 1KB aligned at
+   // least, see RegionSizingInfos) with a version bumped on each change: 26 tag bits for a 48 bits
+   // space, 17 bits for a 57 bits space.
+   // A pop may read the next link of a region popped meanwhile, the tag discards it. Where released
+   // regions are inaccessible (commit protection, windows decommit), pops are also serialized so
+   // this link is never read after its region release.
+#if !defined(_INS_REGION_STACK_SERIALIZED_POPS)
+#if defined(_WIN32) || _INS_OS_COMMIT_PROTECT
+#define _INS_REGION_STACK_SERIALIZED_POPS 1
+#else
+#define _INS_REGION_STACK_SERIALIZED_POPS 0
+#endif
+#endif
+   struct ArenaRegionStack {
    private:
       typedef struct sRegionChain {
          sRegionChain* next;
       } *RegionChain;
-      std::mutex lock;
-      RegionChain list = 0;
-      size_t count = 0;
+      static const size_t LinkShift = 10;
+      static const size_t LinkBits = cst::SpaceSizeL2 - LinkShift;
+      static const uint64_t LinkMask = (uint64_t(1) << LinkBits) - 1;
+      static const uint64_t VersionIncrement = uint64_t(1) << LinkBits;
+      static_assert(64 - LinkBits >= 16, "region stack version tag is too narrow");
+      std::atomic_uint64_t head = 0;
+#if _INS_REGION_STACK_SERIALIZED_POPS
+      std::atomic_bool popping = false;
+#endif
+      static RegionChain Link(uint64_t value) {
+         return RegionChain((value & LinkMask) << LinkShift);
+      }
+      static uint64_t Bump(uint64_t current, RegionChain region) {
+         // (region may be a stale link read by a racing pop, it is masked and its exchange fails)
+         return ((current & ~LinkMask) + VersionIncrement) | ((uint64_t(region) >> LinkShift) & LinkMask);
+      }
+   public:
+      void Push(address_t ptr) {
+         this->PushList(ptr, ptr);
+      }
+      void PushRange(address_t first, size_t stride, size_t count) {
+         auto region = first.as<sRegionChain>();
+         for (size_t i = 1; i < count; i++) {
+            auto next = RegionChain(uintptr_t(region) + stride);
+            region->next = next;
+            region = next;
+         }
+         this->PushList(first, region);
+      }
+      void PushList(address_t first, address_t last) {
+         _ASSERT((first.ptr & ((uintptr_t(1) << LinkShift) - 1)) == 0);
+         auto tail = last.as<sRegionChain>();
+         auto current = this->head.load(std::memory_order_relaxed);
+         do {
+            tail->next = Link(current);
+         } while (!this->head.compare_exchange_weak(current, Bump(current, first.as<sRegionChain>()), std::memory_order_release, std::memory_order_relaxed));
+      }
+      address_t Pop() {
+         auto current = this->head.load(std::memory_order_acquire);
+         if (!Link(current)) return address_t();
+#if _INS_REGION_STACK_SERIALIZED_POPS
+         this->LockPops();
+         current = this->head.load(std::memory_order_acquire);
+#endif
+         RegionChain region;
+         for (;;) {
+            region = Link(current);
+            if (!region) break;
+
+            // Note: region may be popped concurrently, the version tag discards its stale next
+            if (this->head.compare_exchange_weak(current, Bump(current, region->next), std::memory_order_acquire, std::memory_order_acquire)) {
+               break;
+            }
+         }
+#if _INS_REGION_STACK_SERIALIZED_POPS
+         this->UnlockPops();
+#endif
+         return region;
+      }
+      address_t Flush() {
+         // Takes all the regions, chained from the last pushed one
+         auto current = this->head.load(std::memory_order_acquire);
+         if (!Link(current)) return address_t();
+#if _INS_REGION_STACK_SERIALIZED_POPS
+         this->LockPops();
+#endif
+         while (Link(current) && !this->head.compare_exchange_weak(current, Bump(current, 0), std::memory_order_acquire, std::memory_order_acquire));
+#if _INS_REGION_STACK_SERIALIZED_POPS
+         this->UnlockPops();
+#endif
+         return Link(current);
+      }
+      static address_t Next(address_t region) {
+         return region.as<sRegionChain>()->next;
+      }
+      static void SetNext(address_t region, address_t next) {
+         region.as<sRegionChain>()->next = next.as<sRegionChain>();
+      }
+#if _INS_REGION_STACK_SERIALIZED_POPS
+   private:
+      void LockPops() {
+         while (this->popping.exchange(true, std::memory_order_acquire)) {
+            while (this->popping.load(std::memory_order_relaxed)) std::this_thread::yield();
+         }
+      }
+      void UnlockPops() {
+         this->popping.store(false, std::memory_order_release);
+      }
+#endif
+   };
+
+   /**********************************************************************
+   *
+   *   Arena Region Cache
+   *   (per processor magazines backed by a shared stack)
+   *
+   ***********************************************************************/
+   struct ArenaRegionCache {
+   private:
+      // Each stack keeps its count and low watermark on its own line: a push or a pop only touches
+      // the stack it uses, the totals are summed by the purge paths.
+      // (padded rather than aligned: descriptor buffers are only 8 bytes aligned)
+      struct Magazine {
+         ArenaRegionStack stack;
+         std::atomic_size_t count = 0;
+         std::atomic_size_t low_watermark = size_t(-1); // Regions not reused since last watermark reset (unset before the first reset)
+         uint8_t padding[64 - sizeof(ArenaRegionStack) - 2 * sizeof(size_t)];
+      };
+      static_assert(sizeof(Magazine) == 64, "bad size");
+      Magazine magazines[cst::RegionCacheMagazineCount];
+      Magazine shared;
    public:
       size_t size() {
-         return this->count;
+         size_t count = this->shared.count.load(std::memory_order_relaxed);
+         for (auto& magazine : this->magazines) {
+            count += magazine.count.load(std::memory_order_relaxed);
+         }
+         return count;
+      }
+      bool IsFull(size_t capacity) {
+         // Approximate: the magazines are deemed full, regions beyond them overflow to the shared stack
+         return this->shared.count.load(std::memory_order_relaxed) + cst::RegionCacheMagazineCount * cst::RegionCacheMagazineSize > capacity;
       }
       void PushRegion(address_t ptr) {
-         std::lock_guard<std::mutex> guard(this->lock);
-         auto region = ptr.as<sRegionChain>();
-         region->next = this->list;
-         this->list = region;
-         this->count++;
+         auto& magazine = this->magazines[os::GetCurrentProcessor() % cst::RegionCacheMagazineCount];
+         if (magazine.count.load(std::memory_order_relaxed) < cst::RegionCacheMagazineSize) {
+            magazine.count++;
+            magazine.stack.Push(ptr);
+         }
+         else {
+            this->shared.count++;
+            this->shared.stack.Push(ptr);
+         }
+      }
+      void PushRegions(address_t first, size_t stride, size_t count) {
+         this->shared.count += count;
+         this->shared.stack.PushRange(first, stride, count);
       }
       address_t PopRegion() {
-         std::lock_guard<std::mutex> guard(this->lock);
-         if (auto region = this->list) {
-            this->list = region->next;
-            this->count--;
-            return region;
+         return this->PopAnyRegion(true);
+      }
+      address_t DrainRegion() {
+         // Takes a region without lowering the watermark (the region is not reused)
+         return this->PopAnyRegion(false);
+      }
+      size_t ResetLowWatermark() {
+         // Regions cached before the first reset, or removed by a purge, are bounded by the current depth
+         size_t idles = this->ResetLowWatermark(this->shared);
+         for (auto& magazine : this->magazines) {
+            idles += this->ResetLowWatermark(magazine);
+         }
+         return idles;
+      }
+      address_t PopColdRegions(size_t count) {
+         // Takes up to count regions at the bottom of the stacks (least recently cached first),
+         // returned as a region chain (see ArenaRegionStack::Next)
+         auto total = this->size();
+         address_t colds;
+         if (!count || !total) return colds;
+         for (auto& magazine : this->magazines) {
+            this->PopColdRegions(magazine.stack, magazine.count, count, total, colds);
+         }
+         this->PopColdRegions(this->shared.stack, this->shared.count, count, total, colds);
+         return colds;
+      }
+   private:
+      static size_t ResetLowWatermark(Magazine& magazine) {
+         auto count = magazine.count.load(std::memory_order_relaxed);
+         auto watermark = magazine.low_watermark.exchange(count, std::memory_order_relaxed);
+         return watermark < count ? watermark : count;
+      }
+      void PopColdRegions(ArenaRegionStack& stack, std::atomic_size_t& stackCount, size_t count, size_t total, address_t& colds) {
+         // Cold regions are taken from each stack in proportion of its depth
+         auto share = (stackCount.load(std::memory_order_relaxed) * count + total - 1) / total;
+         if (!share) return;
+         auto first = stack.Flush();
+         size_t depth = 0;
+         for (auto region = first; region; region = ArenaRegionStack::Next(region)) depth++;
+         if (share > depth) share = depth;
+
+         // Keep the hot part of the stack, chain the cold part in colds
+         address_t hot_last;
+         auto cold = first;
+         for (size_t i = share; i < depth; i++) {
+            hot_last = cold;
+            cold = ArenaRegionStack::Next(cold);
+         }
+         if (cold) {
+            auto cold_last = cold;
+            while (auto next = ArenaRegionStack::Next(cold_last)) cold_last = next;
+            ArenaRegionStack::SetNext(cold_last, colds);
+            colds = cold;
+            stackCount.fetch_sub(share, std::memory_order_relaxed);
+         }
+         if (hot_last) {
+            stack.PushList(first, hot_last);
+         }
+      }
+      address_t PopAnyRegion(bool reused) {
+         auto index = os::GetCurrentProcessor();
+         if (auto ptr = this->PopMagazine(this->magazines[index % cst::RegionCacheMagazineCount], reused)) {
+            return ptr;
+         }
+         if (auto ptr = this->PopMagazine(this->shared, reused)) {
+            return ptr;
+         }
+         for (size_t i = 1; i < cst::RegionCacheMagazineCount; i++) {
+            if (auto ptr = this->PopMagazine(this->magazines[(index + i) % cst::RegionCacheMagazineCount], reused)) {
+               return ptr;
+            }
+         }
+         return address_t();
+      }
+      static address_t PopMagazine(Magazine& magazine, bool reused) {
+         if (magazine.count.load(std::memory_order_relaxed)) {
+            if (auto ptr = magazine.stack.Pop()) {
+               auto count = --magazine.count;
+               if (reused) {
+                  auto watermark = magazine.low_watermark.load(std::memory_order_relaxed);
+                  while (count < watermark && !magazine.low_watermark.compare_exchange_weak(watermark, count, std::memory_order_relaxed));
+               }
+               return ptr;
+            }
          }
          return address_t();
       }
@@ -44,21 +264,37 @@ namespace ins::mem {
    ***********************************************************************/
    struct ArenaClassPool {
       typedef tRegionSizingInfos::tSizing tSizing;
+      static const size_t cArenaLockCount = 4;
 
       uint8_t pageSizeL2 = 0;
       tSizing sizings[4];
       uint8_t sizeL2 = 0;
+      uint8_t numaNode = 0;
       ArenaRegionCache caches[4];
-      ArenaDescriptor* availables = 0;
+      std::atomic<ArenaDescriptor*> availables = 0; // Arenas with free regions, chained by next (head read without lock)
+      ArenaDescriptor* arenas = 0; // All arenas of the pool, chained by next_pooled
+      RegionPools* pools = 0; // Isolated pools owning this class pool (0 for the process pools)
       uint16_t batchSizeL2 = 0;
       bool managed = false;
-      std::mutex lock;
+      bool hugePages = false;
+      std::mutex lock; // Arenas creation and availables list changes (taken before an arena lock)
+      std::mutex arena_locks[cArenaLockCount]; // Arena free maps, striped by arena indice
+      std::mutex release_lock; // Serializes the free pages release passes
+      std::atomic_size_t free_pages = 0; // Pages with no used region since last release pass (hint)
 
-      void Initialize(uint8_t index, bool managed);
+      void Initialize(uint8_t index, bool managed, uint8_t numaNode);
+      void SetHugePages(bool enabled);
       void Clean();
+      size_t Purge(double ratio);
+
+      // Physical bytes accounting (pools budget, then process budget)
+      bool RequireBytes(size_t size, IMemoryConsumer* consumer);
+      void ForceBytes(size_t size);
+      void ReleaseBytes(size_t size);
 
       // Region management
       address_t ReserveRegion();
+      void ReleaseReservedRegion(address_t addr);
       address_t AllocateRegion(uint8_t sizingID, IMemoryConsumer* consumer);
       void DisposeRegion(address_t addr, uint8_t sizingID);
       void CacheRegion(address_t addr, uint8_t sizingID);
@@ -67,10 +303,177 @@ namespace ins::mem {
       // Buffer management
       address_t AllocateRegionEx(size_t size, IMemoryConsumer* consumer);
       void DisposeRegionEx(address_t address, size_t size);
-      void ReleaseRegionEx(address_t address, size_t size);
+      void ReleaseRegionEx(address_t address, size_t size, bool accounted = true);
+
+   private:
+      address_t UseBatchedRegion(address_t address);
+      size_t ReleaseFreePages(size_t maxRegions);
+      address_t AcquireRegionRange(uint8_t layoutID, uint16_t batchSizeL2);
+      void ReleaseRegionRange(ArenaDescriptor* arena, size_t index, size_t count);
+      ArenaDescriptor* CreateArena();
+      void UnlistArena(ArenaDescriptor* arena, uint16_t batchSizeL2);
+      std::mutex& GetArenaLock(ArenaDescriptor* arena) {
+         return this->arena_locks[arena->indice % cArenaLockCount];
+      }
+      void CommitRegionRange(address_t address, size_t size);
+      void DecommitRegionRange(address_t address, size_t size);
+   };
+
+   /**********************************************************************
+   *
+   *   Arena Node Pools
+   *   (arena class pools of a numa node)
+   *
+   ***********************************************************************/
+   struct ArenaNodePools {
+      ArenaClassPool arenas_unmanaged[cst::RegionSizingCount];
+      ArenaClassPool arenas_managed[cst::RegionSizingCount];
+
+      void Initialize(uint8_t numaNode, RegionPools* pools = 0) {
+         for (int i = 0; i < cst::RegionSizingCount; i++) {
+            this->arenas_unmanaged[i].Initialize(i, false, numaNode);
+            this->arenas_managed[i].Initialize(i, true, numaNode);
+            this->arenas_unmanaged[i].pools = pools;
+            this->arenas_managed[i].pools = pools;
+         }
+      }
+      void SetHugePages(bool enabled) {
+         for (int i = 0; i < cst::RegionSizingCount; i++) {
+            this->arenas_unmanaged[i].SetHugePages(enabled);
+            this->arenas_managed[i].SetHugePages(enabled);
+         }
+      }
+      void Clean() {
+         for (int i = 0; i < cst::RegionSizingCount; i++) {
+            this->arenas_unmanaged[i].Clean();
+            this->arenas_managed[i].Clean();
+         }
+      }
+      size_t Purge(double ratio) {
+         size_t purgedBytes = 0;
+         for (int i = 0; i < cst::RegionSizingCount; i++) {
+            purgedBytes += this->arenas_unmanaged[i].Purge(ratio);
+            purgedBytes += this->arenas_managed[i].Purge(ratio);
+         }
+         return purgedBytes;
+      }
+   };
+
+   /**********************************************************************
+   *
+   *   Physical Bytes Budget
+   *   (global reserved bytes, leased by chunks to per processor slots)
+   *
+   ***********************************************************************/
+   struct PhysicalBytesBudget {
+   private:
+      struct Lease {
+         std::atomic_size_t bytes = 0; // Reserved bytes not used yet
+         uint8_t padding[64 - sizeof(size_t)]; // (padded rather than aligned, see ArenaRegionCache)
+      };
+      Lease leases[cst::PhysicalBytesLeaseCount];
+      std::atomic_size_t reservedBytes = 0; // Used bytes and leased bytes
+      std::atomic_size_t untouchedBytes = 0; // Used bytes not resident at last reconciliation
+   public:
+      std::atomic_size_t maxBytes = size_t(1) << 34; // Options, changed while other threads account bytes
+      std::atomic_size_t leaseSize = cst::PhysicalBytesSlackDefault / (2 * cst::PhysicalBytesLeaseCount);
+      std::atomic_bool reconciled = true;
+
+      bool Require(size_t size) {
+         auto& lease = this->leases[os::GetCurrentProcessor() % cst::PhysicalBytesLeaseCount];
+         size_t bytes = lease.bytes.load(std::memory_order_relaxed);
+         while (bytes >= size) {
+            if (lease.bytes.compare_exchange_weak(bytes, bytes - size, std::memory_order_relaxed)) {
+               return true;
+            }
+         }
+
+         // Refill the lease with a chunk, or reserve the exact size close to the limit
+         auto leaseSize = this->leaseSize.load(std::memory_order_relaxed);
+         if (this->Reserve(size + leaseSize)) {
+            lease.bytes.fetch_add(leaseSize, std::memory_order_relaxed);
+            return true;
+         }
+         return this->Reserve(size);
+      }
+      void Force(size_t size) {
+         this->reservedBytes.fetch_add(size, std::memory_order_relaxed);
+      }
+      void Release(size_t size) {
+         auto& lease = this->leases[os::GetCurrentProcessor() % cst::PhysicalBytesLeaseCount];
+         size_t bytes = lease.bytes.fetch_add(size, std::memory_order_relaxed) + size;
 
+         // Give back the lease excess to the global budget
+         auto leaseSize = this->leaseSize.load(std::memory_order_relaxed);
+         while (bytes > 2 * leaseSize) {
+            if (lease.bytes.compare_exchange_weak(bytes, leaseSize, std::memory_order_relaxed)) {
+               this->reservedBytes.fetch_sub(bytes - leaseSize, std::memory_order_relaxed);
+               return;
+            }
+         }
+      }
+      void Reclaim() {
+         for (auto& lease : this->leases) {
+            if (auto bytes = lease.bytes.exchange(0, std::memory_order_relaxed)) {
+               this->reservedBytes.fetch_sub(bytes, std::memory_order_relaxed);
+            }
+         }
+      }
+      size_t GetLeasedBytes() {
+         size_t bytes = 0;
+         for (auto& lease : this->leases) {
+            bytes += lease.bytes.load(std::memory_order_relaxed);
+         }
+         return bytes;
+      }
+      size_t GetUsedBytes() {
+         size_t reserved = this->reservedBytes.load(std::memory_order_relaxed);
+         size_t leased = this->GetLeasedBytes();
+         return reserved > leased ? reserved - leased : 0;
+      }
+      size_t GetUntouchedBytes() {
+         return this->untouchedBytes.load(std::memory_order_relaxed);
+      }
+      void Reconcile(size_t residentBytes) {
+         // Committed pages are resident on first touch only: the purge trigger applies on touched bytes
+         size_t used = this->GetUsedBytes();
+         this->untouchedBytes.store(used > residentBytes ? used - residentBytes : 0, std::memory_order_relaxed);
+      }
+      bool IsSoftLimitReached() {
+         // Purge trigger at 7/8 of the limit, on the bytes touched at last reconciliation
+         size_t used = this->GetUsedBytes();
+         size_t untouched = this->untouchedBytes.load(std::memory_order_relaxed);
+         size_t touched = used > untouched ? used - untouched : 0;
+         size_t limit = this->maxBytes.load(std::memory_order_relaxed);
+         return touched > limit - (limit >> 3);
+      }
    private:
-      address_t AcquireRegionRange(uint8_t layoutID);
+      bool Reserve(size_t size) {
+         // Hard limit on committed bytes, untouched ones included (they can be touched at any time)
+         auto limit = this->maxBytes.load(std::memory_order_relaxed);
+         if (this->reservedBytes.fetch_add(size, std::memory_order_relaxed) + size > limit) {
+            this->reservedBytes.fetch_sub(size, std::memory_order_relaxed);
+            return false;
+         }
+         return true;
+      }
+   };
+
+   /**********************************************************************
+   *
+   *   Region Pools
+   *   (arena class pools of an isolated heap, with its own physical budget)
+   *
+   ***********************************************************************/
+   struct RegionPools : Descriptor {
+      ArenaNodePools classes;
+      PhysicalBytesBudget physicalBytes;
+
+      RegionPools(size_t maxPhysicalBytes) {
+         this->classes.Initialize(0, this); // Not bound to a numa node
+         this->physicalBytes.maxBytes = maxPhysicalBytes ? maxPhysicalBytes : size_t(-1);
+         this->physicalBytes.reconciled = false; // Resident bytes are not known by pools
+      }
    };
 
    /**********************************************************************
@@ -81,42 +484,53 @@ namespace ins::mem {
    struct MemoryDescriptor {
 
       std::mutex lock;
-      std::atomic_size_t usedPhysicalBytes = 0;
-      size_t maxUsablePhysicalBytes = size_t(1) << 34;
+      PhysicalBytesBudget physicalBytes;
+
+      HugePagesMode hugePagesMode = HugePagesMode::Disabled;
+      uint8_t hugePageSizeL2 = 0;
 
-      ArenaEntry* arenas_map = 0; // ArenaEntry[cst::ArenaPerSpace]
+      uint32_t purgeHalfLifeMs = 10000;
+      uint32_t purgePeriodMs = 1000;
+      std::atomic_size_t purgedBytes = 0;
+      std::atomic_size_t purgedRegions = 0;
 
       ArenaDescriptor descriptors_arena;
       DescriptorsAllocator descriptors_allocator;
 
-      ArenaClassPool arenas_unmanaged[cst::RegionSizingCount];
-      ArenaClassPool arenas_managed[cst::RegionSizingCount];
+      uint8_t nodes_count = 0; // Logical numa nodes
+      uint8_t nodes_physical_count = 1;
+      ArenaNodePools* nodes[cst::NumaNodeMax] = { 0 }; // Allocated as descriptors (too big for the space page)
 
       MemoryDescriptor(uint32_t arena_pagecountL2) {
 
-         // Initialize arena map
-         auto arenas_map_size = sizeof(ArenaEntry) * cst::ArenaPerSpace;
-         this->arenas_map = (ArenaEntry*)os::AllocateMemory(0, cst::SpaceSize, arenas_map_size, cst::PageSize);
-         for (int i = 0; i < cst::ArenaPerSpace; i++) {
-            this->arenas_map[i] = ArenaEntry(&ArenaDescriptor::UnusedArena);
+         // Initialize arena map (leaves are committed by the arenas registration)
+         if (auto huge_page_size = os::GetHugePageSize()) {
+            this->hugePageSizeL2 = bit::msb_64(huge_page_size);
          }
+         mem::ArenaMap.Initialize();
 
          // Register descriptors arena
          this->descriptors_arena.Initialize(cst::ArenaSizeL2);
          this->descriptors_arena.indice = address_t(this).arenaID;
          this->descriptors_arena.availables_count--;
          this->descriptors_arena.regions[0] = RegionLayoutID::DescriptorHeapRegion;
-         this->arenas_map[address_t(this).arenaID] = ArenaEntry(&this->descriptors_arena);
+         mem::ArenaMap.Set(address_t(this).arenaID, ArenaEntry(&this->descriptors_arena));
+         mem::UnmanagedArenas.Register(address_t(this).arenaID);
          _ASSERT(this->descriptors_arena.availables_count == 0);
 
          // Initialize descriptors allocator
          this->descriptors_allocator.Initialize(uintptr_t(this), sizeof(MemoryDescriptor), arena_pagecountL2);
 
-         // Initialize regions allocator
-         for (int i = 0; i < cst::RegionSizingCount; i++) {
-            this->arenas_unmanaged[i].Initialize(i, false);
-            this->arenas_managed[i].Initialize(i, true);
-         }
+         // Detect numa nodes (regions allocators are created by SetNodesCount)
+         auto physical_count = os::GetNumaNodeCount();
+         this->nodes_physical_count = uint8_t(physical_count < cst::NumaNodeMax ? physical_count : cst::NumaNodeMax);
+      }
+
+      void SetNodesCount(uint8_t count);
+
+      ArenaNodePools& GetNodePools(uint8_t numaNode) {
+         if (numaNode == cst::NumaNodeAny) numaNode = uint8_t(os::GetCurrentNumaNode());
+         return *this->nodes[numaNode % this->nodes_count];
       }
 
       static MemoryDescriptor* New() {
@@ -132,4 +546,5 @@ namespace ins::mem {
    };
 
    extern MemoryDescriptor* space;
+   extern size_t GetColdRegionsCount();
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include <ins/memory/structs.h>
 #include <stdio.h>
+#include <math.h>
 
 using namespace ins;
 using namespace ins::mem;
@@ -13,5 +14,5 @@ mem::sz2a::sz2a(size_t size) {
 
 void mem::sz2a::set(size_t size, size_t factor, const char* unit) {
    auto sz = floor(double(size) * 100.0 / double(factor)) / 100.0;
-   sprintf_s(chars, sizeof(chars), "%llg %s", sz, unit);
+   snprintf(chars, sizeof(chars), "%g %s", sz, unit);
 }
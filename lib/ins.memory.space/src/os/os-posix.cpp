@@ -0,0 +1,650 @@
+#if !defined(_WIN32)
+#include <ins/binary/alignment.h>
+#include <ins/os/memory.h>
+#include <ins/os/threading.h>
+#include <atomic>
+#include <mutex>
+
+#include <sys/mman.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <signal.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <poll.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <sched.h>
+#endif
+
+// Commit policy:
+// - 0 (default): reservations are mapped read-write with MAP_NORESERVE and pages are committed on first touch,
+//   so each arena stays a single VMA whatever its commit/decommit history (keeps vm.max_map_count safe)
+// - 1: reservations are mapped PROT_NONE and committed with mprotect, uncommitted accesses fault like on win32,
+//   but each committed/reserved boundary costs a VMA
+#ifndef _INS_OS_COMMIT_PROTECT
+#define _INS_OS_COMMIT_PROTECT 0
+#endif
+
+// Decommit policy:
+// - 0 (default): MADV_DONTNEED, physical pages are returned immediately and read back as zero
+// - 1: MADV_FREE, physical pages are reclaimed lazily by the kernel under pressure
+#ifndef _INS_OS_DECOMMIT_LAZY
+#define _INS_OS_DECOMMIT_LAZY 0
+#endif
+
+#if !defined(MAP_NORESERVE)
+#define MAP_NORESERVE 0
+#endif
+
+namespace ins::os {
+
+   static const int c_ReserveProtection = _INS_OS_COMMIT_PROTECT ? PROT_NONE : (PROT_READ | PROT_WRITE);
+
+   uintptr_t GetMemorySize() {
+      return uintptr_t(1) << 47;
+   }
+
+   uintptr_t GetSlabSize() {
+      static uintptr_t page_size = uintptr_t(sysconf(_SC_PAGESIZE));
+      return page_size;
+   }
+
+   // Minimal /proc file reader, without heap allocation (can be called from inside malloc)
+   struct ProcMapsReader {
+      int fd;
+      char buffer[4096];
+      size_t length = 0;
+      size_t cursor = 0;
+      ProcMapsReader(const char* path = "/proc/self/maps") {
+         this->fd = open(path, O_RDONLY | O_CLOEXEC);
+      }
+      ~ProcMapsReader() {
+         if (this->fd >= 0) close(this->fd);
+      }
+      int ReadChar() {
+         if (this->cursor >= this->length) {
+            auto count = read(this->fd, this->buffer, sizeof(this->buffer));
+            if (count <= 0) return -1;
+            this->length = size_t(count);
+            this->cursor = 0;
+         }
+         return this->buffer[this->cursor++];
+      }
+      uintptr_t ReadHex(int& c) {
+         uintptr_t value = 0;
+         for (;;) {
+            c = this->ReadChar();
+            if (c >= '0' && c <= '9') value = (value << 4) | uintptr_t(c - '0');
+            else if (c >= 'a' && c <= 'f') value = (value << 4) | uintptr_t(c - 'a' + 10);
+            else return value;
+         }
+      }
+      bool ReadZone(uintptr_t& start, uintptr_t& end, bool& accessible) {
+         if (this->fd < 0) return false;
+         int c = 0;
+         start = this->ReadHex(c);
+         if (c != '-') return false;
+         end = this->ReadHex(c);
+         char perms[4];
+         for (int i = 0; i < 4; i++) perms[i] = char(this->ReadChar());
+         accessible = perms[0] != '-' || perms[1] != '-' || perms[2] != '-';
+         while (c != '\n' && c != -1) c = this->ReadChar();
+         return true;
+      }
+      bool ReadLine(char* line, size_t size) {
+         if (this->fd < 0) return false;
+         size_t len = 0;
+         int c = this->ReadChar();
+         if (c == -1) return false;
+         while (c != '\n' && c != -1) {
+            if (len + 1 < size) line[len++] = char(c);
+            c = this->ReadChar();
+         }
+         line[len] = 0;
+         return true;
+      }
+   };
+
+   static uintptr_t ParseHex(const char*& s) {
+      uintptr_t value = 0;
+      for (;; s++) {
+         if (*s >= '0' && *s <= '9') value = (value << 4) | uintptr_t(*s - '0');
+         else if (*s >= 'a' && *s <= 'f') value = (value << 4) | uintptr_t(*s - 'a' + 10);
+         else return value;
+      }
+   }
+
+   static uintptr_t ParseDecimal(const char* s) {
+      uintptr_t value = 0;
+      while (*s == ' ' || *s == '\t') s++;
+      for (; *s >= '0' && *s <= '9'; s++) value = value * 10 + uintptr_t(*s - '0');
+      return value;
+   }
+
+   static bool StartsWith(const char* s, const char* prefix) {
+      while (*prefix) {
+         if (*s++ != *prefix++) return false;
+      }
+      return true;
+   }
+
+   tZoneState GetMemoryZoneState(uintptr_t address) {
+      tZoneState region;
+      region.address = address & ~(GetSlabSize() - 1);
+      region.size = GetMemorySize() - region.address;
+      region.state = tState::FREE;
+      if (address >= GetMemorySize()) {
+         region.address = address;
+         region.size = 0;
+         region.state = tState::OUT_OF_MEMORY;
+         return region;
+      }
+
+      ProcMapsReader maps;
+      uintptr_t start, end;
+      bool accessible;
+      while (maps.ReadZone(start, end, accessible)) {
+         if (address < start) {
+            region.size = start - region.address;
+            break;
+         }
+         else if (address < end) {
+            region.address = start;
+            region.size = end - start;
+            region.state = accessible ? tState::COMMITTED : tState::RESERVED;
+            break;
+         }
+      }
+      return region;
+   }
+
+   void EnumerateMemoryZone(uintptr_t startAddress, uintptr_t endAddress, std::function<void(tZoneState&)> visitor) {
+      uintptr_t cursor = startAddress;
+      while (cursor < endAddress) {
+         tZoneState zone = os::GetMemoryZoneState(cursor);
+         if (!zone.size) break;
+         cursor = zone.address + zone.size;
+         visitor(zone);
+      }
+   }
+
+   static uintptr_t AcquireMemory(uintptr_t base, uintptr_t limit, uintptr_t size, uintptr_t alignement, int protection) {
+      static constexpr uint32_t unsuseful_reservation_limit = 30;
+      static std::atomic_uint32_t unsuseful_reservation;
+      if (!limit) {
+         limit = size_t(1) << 48;
+      }
+      if (alignement < GetSlabSize()) {
+         alignement = GetSlabSize();
+      }
+
+      // Over-reserve then trim head and tail, so the aligned zone remains a single mapping
+      auto span = size + alignement;
+      while (base < limit) {
+         auto ptr = (uintptr_t)mmap((void*)base, span, protection, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+         if ((void*)ptr == MAP_FAILED) {
+            return 0;
+         }
+         auto aligned = (ptr + alignement - 1) & ~(alignement - 1);
+         if (aligned >= base && aligned + size <= limit) {
+            if (aligned > ptr) munmap((void*)ptr, aligned - ptr);
+            if (ptr + span > aligned + size) munmap((void*)(aligned + size), ptr + span - (aligned + size));
+            return aligned;
+         }
+         munmap((void*)ptr, span);
+         if (unsuseful_reservation++ == unsuseful_reservation_limit) {
+            printf("! %d unsuseful reservation detected !\n", unsuseful_reservation_limit);
+            unsuseful_reservation = 0;
+         }
+
+         // Try again for aligned base after found ptr
+         if (ptr > base) base = aligned;
+         else base += alignement;
+      }
+      return 0;
+   }
+
+   uintptr_t AllocateMemory(uintptr_t base, uintptr_t limit, uintptr_t size, uintptr_t alignement) {
+      return AcquireMemory(base, limit, size, alignement, PROT_READ | PROT_WRITE);
+   }
+
+   uintptr_t ReserveMemory(uintptr_t base, uintptr_t limit, uintptr_t size, uintptr_t alignement) {
+      return AcquireMemory(base, limit, size, alignement, c_ReserveProtection);
+   }
+
+   uintptr_t AllocateSparseMemory(uintptr_t size) {
+      return AcquireMemory(0, 0, size, GetSlabSize(), PROT_READ | PROT_WRITE);
+   }
+
+   bool CommitMemory(uintptr_t base, uintptr_t size) {
+#if _INS_OS_COMMIT_PROTECT
+      return mprotect((void*)base, size, PROT_READ | PROT_WRITE) == 0;
+#else
+      return true;
+#endif
+   }
+
+   bool DecommitMemory(uintptr_t base, uintptr_t size) {
+#if _INS_OS_DECOMMIT_LAZY && defined(MADV_FREE)
+      if (madvise((void*)base, size, MADV_FREE) != 0) return false;
+#else
+      if (madvise((void*)base, size, MADV_DONTNEED) != 0) return false;
+#endif
+#if _INS_OS_COMMIT_PROTECT
+      return mprotect((void*)base, size, PROT_NONE) == 0;
+#else
+      return true;
+#endif
+   }
+
+   bool ReleaseMemory(uintptr_t base, uintptr_t size) {
+      return munmap((void*)base, size) == 0;
+   }
+
+   bool ResetMemory(uintptr_t base, uintptr_t size) {
+      return madvise((void*)base, size, MADV_DONTNEED) == 0;
+   }
+
+   /**********************************************************************
+   *
+   *   Huge pages
+   *
+   ***********************************************************************/
+
+   static uintptr_t ReadHugePageSize() {
+      char line[128];
+      {
+         // PMD size used by transparent huge pages
+         ProcMapsReader reader("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size");
+         if (reader.ReadLine(line, sizeof(line))) {
+            if (auto size = ParseDecimal(line)) return size;
+         }
+      }
+      {
+         // Default size of the explicit huge pages pool
+         ProcMapsReader reader("/proc/meminfo");
+         while (reader.ReadLine(line, sizeof(line))) {
+            if (StartsWith(line, "Hugepagesize:")) {
+               return ParseDecimal(line + sizeof("Hugepagesize:") - 1) * 1024;
+            }
+         }
+      }
+      return 0;
+   }
+
+   uintptr_t GetHugePageSize() {
+      static uintptr_t huge_page_size = ReadHugePageSize();
+      return huge_page_size;
+   }
+
+   bool AdviseHugeMemory(uintptr_t base, uintptr_t size) {
+#if defined(MADV_HUGEPAGE)
+      return madvise((void*)base, size, MADV_HUGEPAGE) == 0;
+#else
+      return false;
+#endif
+   }
+
+   bool AdviseSequentialMemory(uintptr_t base, uintptr_t size) {
+      auto start = base & ~(GetSlabSize() - 1);
+      size += base - start;
+      if (madvise((void*)start, size, MADV_SEQUENTIAL) != 0) return false;
+      return madvise((void*)start, size, MADV_WILLNEED) == 0;
+   }
+
+   bool CommitHugeMemory(uintptr_t base, uintptr_t size) {
+#if defined(MAP_HUGETLB) && defined(MREMAP_FIXED)
+      // Map from the huge pages pool aside, then move over the reservation:
+      // when the pool is exhausted the reservation is left untouched
+      auto ptr = mmap(0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+      if (ptr == MAP_FAILED) {
+         return false;
+      }
+      if (mremap(ptr, size, size, MREMAP_MAYMOVE | MREMAP_FIXED, (void*)base) == MAP_FAILED) {
+         munmap(ptr, size);
+         return false;
+      }
+      return true;
+#else
+      return false;
+#endif
+   }
+
+   bool DecommitHugeMemory(uintptr_t base, uintptr_t size) {
+      // Replace the range by a fresh reservation, which releases both transparent and pooled huge pages
+      auto ptr = mmap((void*)base, size, c_ReserveProtection, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED, -1, 0);
+      if (ptr == MAP_FAILED) {
+         return DecommitMemory(base, size);
+      }
+      AdviseHugeMemory(base, size);
+      return true;
+   }
+
+   void EnumerateHugeMemoryZone(std::function<void(uintptr_t address, uintptr_t size, uintptr_t hugeBytes)> visitor) {
+      ProcMapsReader smaps("/proc/self/smaps");
+      char line[256];
+      uintptr_t start = 0, end = 0, hugeBytes = 0;
+      while (smaps.ReadLine(line, sizeof(line))) {
+         const char* s = line;
+         auto value = ParseHex(s);
+         if (*s == '-') {
+            if (hugeBytes) visitor(start, end - start, hugeBytes);
+            s++;
+            start = value;
+            end = ParseHex(s);
+            hugeBytes = 0;
+         }
+         else if (StartsWith(line, "AnonHugePages:")) {
+            hugeBytes += ParseDecimal(line + sizeof("AnonHugePages:") - 1) * 1024;
+         }
+         else if (StartsWith(line, "Private_Hugetlb:")) {
+            hugeBytes += ParseDecimal(line + sizeof("Private_Hugetlb:") - 1) * 1024;
+         }
+         else if (StartsWith(line, "Shared_Hugetlb:")) {
+            hugeBytes += ParseDecimal(line + sizeof("Shared_Hugetlb:") - 1) * 1024;
+         }
+      }
+      if (hugeBytes) visitor(start, end - start, hugeBytes);
+   }
+
+   /**********************************************************************
+   *
+   *   NUMA nodes
+   *
+   ***********************************************************************/
+
+   static uint32_t ReadNumaNodeCount() {
+      char line[128];
+      ProcMapsReader reader("/sys/devices/system/node/possible");
+      if (reader.ReadLine(line, sizeof(line))) {
+         // Format is a node list like "0" or "0-3"
+         const char* s = line;
+         uint32_t last = 0;
+         while (*s) {
+            if (*s >= '0' && *s <= '9') {
+               last = 0;
+               for (; *s >= '0' && *s <= '9'; s++) last = last * 10 + uint32_t(*s - '0');
+            }
+            else s++;
+         }
+         return last + 1;
+      }
+      return 1;
+   }
+
+   uint32_t GetNumaNodeCount() {
+      static uint32_t node_count = ReadNumaNodeCount();
+      return node_count;
+   }
+
+   uint32_t GetCurrentNumaNode() {
+#if defined(__linux__) && defined(SYS_getcpu)
+      unsigned cpu = 0, node = 0;
+      if (syscall(SYS_getcpu, &cpu, &node, 0) == 0) return node;
+#endif
+      return 0;
+   }
+
+   bool BindMemoryToNumaNode(uintptr_t base, uintptr_t size, uint32_t node) {
+#if defined(__linux__) && defined(SYS_mbind)
+      // Preferred policy: a full node spills over other nodes instead of failing the fault
+      static const int MPOL_PREFERRED_ = 1;
+      unsigned long mask = 1ul << (node % (sizeof(mask) * 8));
+      return syscall(SYS_mbind, base, size, MPOL_PREFERRED_, &mask, sizeof(mask) * 8, 0) == 0;
+#else
+      return false;
+#endif
+   }
+
+   /**********************************************************************
+   *
+   *   Process memory limit (cgroup v2) and pressure (PSI)
+   *
+   ***********************************************************************/
+
+   // Get the cgroup directory of the process, like "/sys/fs/cgroup/user.slice/"
+   // (controller is 0 for cgroup v2 unified hierarchy, or a cgroup v1 controller name)
+   static bool ReadCgroupPath(char* path, size_t size, const char* controller = 0) {
+      char line[256], prefix[64];
+      if (controller) snprintf(prefix, sizeof(prefix), ":%s:/", controller);
+      ProcMapsReader reader("/proc/self/cgroup");
+      while (reader.ReadLine(line, sizeof(line))) {
+         const char* relpath = 0;
+         if (!controller) {
+            if (StartsWith(line, "0::/")) relpath = line + 3;
+         }
+         else if (auto found = strstr(line, prefix)) {
+            relpath = found + strlen(prefix) - 1;
+         }
+         if (relpath) {
+            auto len = controller
+               ? snprintf(path, size, "/sys/fs/cgroup/%s%s", controller, relpath)
+               : snprintf(path, size, "/sys/fs/cgroup%s", relpath);
+            if (len <= 0 || size_t(len) + 1 >= size) return false;
+            if (path[len - 1] != '/') {
+               path[len++] = '/';
+               path[len] = 0;
+            }
+            return true;
+         }
+      }
+      return false;
+   }
+
+   static uintptr_t ReadCgroupLimit(const char* path, const char* name) {
+      char filename[512], line[64];
+      snprintf(filename, sizeof(filename), "%s%s", path, name);
+      ProcMapsReader reader(filename);
+      if (reader.ReadLine(line, sizeof(line)) && line[0] >= '0' && line[0] <= '9') {
+         return ParseDecimal(line); // "max" when not limited
+      }
+      return 0;
+   }
+
+   uintptr_t GetMemoryLimit() {
+      char path[320];
+      if (ReadCgroupPath(path, sizeof(path))) {
+         // memory.high throttles before the memory.max kill, the lowest limit applies
+         uintptr_t limit = ReadCgroupLimit(path, "memory.max");
+         uintptr_t high = ReadCgroupLimit(path, "memory.high");
+         if (high && (!limit || high < limit)) limit = high;
+         if (limit) return limit;
+      }
+      if (ReadCgroupPath(path, sizeof(path), "memory")) {
+         // cgroup v1 fallback, not limited is given as a huge page aligned max value
+         uintptr_t limit = ReadCgroupLimit(path, "memory.limit_in_bytes");
+         if (limit < (uintptr_t(1) << 60)) return limit;
+      }
+      return 0;
+   }
+
+   uintptr_t GetResidentMemorySize() {
+      char line[128];
+      ProcMapsReader reader("/proc/self/statm");
+      if (reader.ReadLine(line, sizeof(line))) {
+         // Format is "size resident shared text lib data dt" in pages
+         const char* s = line;
+         while (*s && *s != ' ') s++;
+         return ParseDecimal(s) * GetSlabSize();
+      }
+      return 0;
+   }
+
+   uintptr_t OpenMemoryPressureMonitor(uint32_t stallUs, uint32_t windowUs) {
+      char path[320], filename[512], trigger[64];
+      int fd = -1;
+      if (ReadCgroupPath(path, sizeof(path))) {
+         snprintf(filename, sizeof(filename), "%smemory.pressure", path);
+         fd = open(filename, O_RDWR | O_NONBLOCK | O_CLOEXEC);
+      }
+      if (fd < 0) {
+         fd = open("/proc/pressure/memory", O_RDWR | O_NONBLOCK | O_CLOEXEC);
+         if (fd < 0) return 0;
+      }
+
+      // Trigger when some tasks are stalled on memory stallUs in a windowUs period
+      auto len = snprintf(trigger, sizeof(trigger), "some %u %u", stallUs, windowUs);
+      if (write(fd, trigger, size_t(len) + 1) < 0) {
+         close(fd);
+         return 0;
+      }
+      return uintptr_t(fd) + 1;
+   }
+
+   int WaitMemoryPressure(uintptr_t monitor, uint32_t timeoutMs) {
+      if (!monitor) return -1;
+      struct pollfd fds;
+      fds.fd = int(monitor - 1);
+      fds.events = POLLPRI;
+      fds.revents = 0;
+      int n = poll(&fds, 1, int(timeoutMs));
+      if (n < 0) return (errno == EINTR) ? 0 : -1;
+      if (n == 0) return 0;
+      if (fds.revents & POLLERR) return -1;
+      return (fds.revents & POLLPRI) ? 1 : 0;
+   }
+
+   void CloseMemoryPressureMonitor(uintptr_t monitor) {
+      if (monitor) close(int(monitor - 1));
+   }
+
+   /**********************************************************************
+   *
+   *   Thread suspension (signal based, like stop-the-world collectors)
+   *
+   ***********************************************************************/
+
+#if defined(SIGRTMIN)
+   static int GetSuspendSignal() { return SIGRTMIN + 4; }
+   static int GetResumeSignal() { return SIGRTMIN + 5; }
+#else
+   static int GetSuspendSignal() { return SIGUSR1; }
+   static int GetResumeSignal() { return SIGUSR2; }
+#endif
+
+   // One thread is suspended at a time: the lock is held from Suspend to Resume, and the suspended
+   // thread acknowledges both its parking and its release, so the shared flag and semaphore
+   // never serve two suspensions
+   static std::mutex suspend_lock;
+   static sem_t suspend_acknowledge;
+   static std::atomic_bool suspend_released;
+
+   static void OnSuspendSignal(int) {
+      int saved_errno = errno;
+      sigset_t mask;
+      sigfillset(&mask);
+      sigdelset(&mask, GetResumeSignal());
+      sem_post(&suspend_acknowledge);
+      while (!suspend_released.load()) {
+         sigsuspend(&mask);
+      }
+      sem_post(&suspend_acknowledge);
+      errno = saved_errno;
+   }
+
+   static void OnResumeSignal(int) {
+   }
+
+   static void InstallSuspendHandlers() {
+      static std::once_flag installed;
+      std::call_once(installed, []() {
+         sem_init(&suspend_acknowledge, 0, 0);
+
+         struct sigaction action = {};
+         action.sa_flags = SA_RESTART;
+         action.sa_handler = OnSuspendSignal;
+         sigfillset(&action.sa_mask);
+         sigaction(GetSuspendSignal(), &action, 0);
+
+         action.sa_handler = OnResumeSignal;
+         sigemptyset(&action.sa_mask);
+         sigaction(GetResumeSignal(), &action, 0);
+         }
+      );
+   }
+
+   static uint64_t GetCurrentThreadId() {
+#if defined(__linux__)
+      return uint64_t(syscall(SYS_gettid));
+#else
+      return uint64_t(pthread_self());
+#endif
+   }
+
+   Thread::Thread() {
+      this->d0 = 0;
+      this->d1 = 0;
+   }
+   Thread::Thread(Thread&& x) {
+      this->d0 = x.d0;
+      this->d1 = x.d1;
+      x.d0 = 0;
+      x.d1 = 0;
+   }
+   void Thread::operator = (Thread&& x) {
+      this->d0 = x.d0;
+      this->d1 = x.d1;
+      x.d0 = 0;
+      x.d1 = 0;
+   }
+   Thread::~Thread() {
+      this->Clear();
+   }
+   uint64_t Thread::GetID() {
+      return this->d0;
+   }
+   bool Thread::IsCurrent() {
+      return this->d1 && pthread_equal(pthread_t(this->d1), pthread_self());
+   }
+   void Thread::Suspend() {
+      InstallSuspendHandlers();
+      suspend_lock.lock();
+      suspend_released = false;
+      if (pthread_kill(pthread_t(this->d1), GetSuspendSignal()) == 0) {
+         while (sem_wait(&suspend_acknowledge) != 0 && errno == EINTR);
+      }
+      else {
+         suspend_released = true; // Thread is gone, Resume has nothing to wait
+      }
+   }
+   void Thread::Resume() {
+      if (!suspend_released.load()) {
+         suspend_released = true;
+         if (pthread_kill(pthread_t(this->d1), GetResumeSignal()) == 0) {
+            while (sem_wait(&suspend_acknowledge) != 0 && errno == EINTR);
+         }
+      }
+      suspend_lock.unlock();
+   }
+   Thread::operator bool() {
+      return this->d1 != 0;
+   }
+   void Thread::Clear() {
+      this->d0 = 0;
+      this->d1 = 0;
+   }
+   Thread Thread::current() {
+      Thread t;
+      t.d0 = GetCurrentThreadId();
+      t.d1 = uint64_t(pthread_self());
+      return t;
+   }
+
+   uint32_t GetCurrentProcessor() {
+#if defined(__linux__)
+      int cpu = sched_getcpu();
+      if (cpu >= 0) return uint32_t(cpu);
+#endif
+      return 0;
+   }
+
+   uint32_t GetCurrentProcessID() {
+      return uint32_t(getpid());
+   }
+}
+#endif
@@ -1,3 +1,4 @@
+#if defined(_WIN32)
 #include <ins/binary/alignment.h>
 #include <ins/os/memory.h>
 #include <ins/os/threading.h>
@@ -95,6 +96,10 @@ namespace ins::os {
       return AcquireMemory(base, limit, size, alignement, MEM_RESERVE, PAGE_NOACCESS);
    }
 
+   uintptr_t AllocateSparseMemory(uintptr_t size) {
+      return 0; // Reserved pages are not readable before commit
+   }
+
    bool CommitMemory(uintptr_t base, uintptr_t size) {
       uintptr_t ptr = (uintptr_t)VirtualAlloc(LPVOID(base), size, MEM_COMMIT, PAGE_READWRITE);
       assert(base == ptr);
@@ -109,6 +114,89 @@ namespace ins::os {
       return VirtualFree(LPVOID(base), 0, MEM_RELEASE);
    }
 
+   bool ResetMemory(uintptr_t base, uintptr_t size) {
+      return DecommitMemory(base, size) && CommitMemory(base, size);
+   }
+
+   // Large pages need SeLockMemoryPrivilege and a MEM_LARGE_PAGES allocation at reservation time,
+   // which does not fit the reserve/commit arena model: huge pages are reported as unsupported
+   uintptr_t GetHugePageSize() {
+      return 0;
+   }
+
+   bool AdviseHugeMemory(uintptr_t base, uintptr_t size) {
+      return false;
+   }
+
+   bool AdviseSequentialMemory(uintptr_t base, uintptr_t size) {
+      WIN32_MEMORY_RANGE_ENTRY range = { PVOID(base), SIZE_T(size) };
+      return PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0) != 0;
+   }
+
+   bool CommitHugeMemory(uintptr_t base, uintptr_t size) {
+      return false;
+   }
+
+   bool DecommitHugeMemory(uintptr_t base, uintptr_t size) {
+      return DecommitMemory(base, size);
+   }
+
+   void EnumerateHugeMemoryZone(std::function<void(uintptr_t address, uintptr_t size, uintptr_t hugeBytes)> visitor) {
+   }
+
+   uint32_t GetNumaNodeCount() {
+      ULONG highest = 0;
+      if (!GetNumaHighestNodeNumber(&highest)) return 1;
+      return highest + 1;
+   }
+
+   uint32_t GetCurrentNumaNode() {
+      PROCESSOR_NUMBER processor;
+      USHORT node = 0;
+      GetCurrentProcessorNumberEx(&processor);
+      if (!GetNumaProcessorNodeEx(&processor, &node)) return 0;
+      return node;
+   }
+
+   // Node affinity can only be given at VirtualAllocExNuma time, reserved ranges rely on the
+   // ideal node of the first touching thread
+   bool BindMemoryToNumaNode(uintptr_t base, uintptr_t size, uint32_t node) {
+      return false;
+   }
+
+   uintptr_t GetMemoryLimit() {
+      JOBOBJECT_EXTENDED_LIMIT_INFORMATION infos;
+      if (QueryInformationJobObject(NULL, JobObjectExtendedLimitInformation, &infos, sizeof(infos), NULL)) {
+         if (infos.BasicLimitInformation.LimitFlags & JOB_OBJECT_LIMIT_PROCESS_MEMORY) return infos.ProcessMemoryLimit;
+         if (infos.BasicLimitInformation.LimitFlags & JOB_OBJECT_LIMIT_JOB_MEMORY) return infos.JobMemoryLimit;
+      }
+      return 0;
+   }
+
+   uintptr_t GetResidentMemorySize() {
+      PROCESS_MEMORY_COUNTERS counters;
+      if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+      return counters.WorkingSetSize;
+   }
+
+   // Stall thresholds are not configurable, the system low memory notification is used
+   uintptr_t OpenMemoryPressureMonitor(uint32_t stallUs, uint32_t windowUs) {
+      return uintptr_t(CreateMemoryResourceNotification(LowMemoryResourceNotification));
+   }
+
+   int WaitMemoryPressure(uintptr_t monitor, uint32_t timeoutMs) {
+      if (!monitor) return -1;
+      switch (WaitForSingleObject(HANDLE(monitor), timeoutMs)) {
+      case WAIT_OBJECT_0: return 1;
+      case WAIT_TIMEOUT: return 0;
+      default: return -1;
+      }
+   }
+
+   void CloseMemoryPressureMonitor(uintptr_t monitor) {
+      if (monitor) CloseHandle(HANDLE(monitor));
+   }
+
    Thread::Thread() {
       this->d0 = 0;
       this->d1 = 0;
@@ -156,4 +244,13 @@ namespace ins::os {
       t.d1 = uint64_t(OpenThread(THREAD_ALL_ACCESS, false, ::GetCurrentThreadId()));
       return t;
    }
+
+   uint32_t GetCurrentProcessor() {
+      return ::GetCurrentProcessorNumber();
+   }
+
+   uint32_t GetCurrentProcessID() {
+      return uint32_t(::GetCurrentProcessId());
+   }
 }
+#endif
@@ -2,18 +2,21 @@
 #include <mimalloc.h>
 #include <ins/binary/alignment.h>
 #include <ins/memory/contexts.h>
+#include <ins/memory/malloc.h>
+#if defined(_WIN32)
 #include <ins/hooks.h>
+#endif
 #include "./utils.h"
 
 struct no_malloc_handler {
    static const char* name() {
       return "no-malloc";
    }
-   __declspec(noinline) static void* malloc(size_t) {
+   _INS_NOINLINE static void* malloc(size_t) {
       static char bytes[2048];
       return bytes;
    }
-   __declspec(noinline) static void free(void*) {
+   _INS_NOINLINE static void free(void*) {
    }
    static bool check(void* p) {
       return true;
@@ -66,3 +69,18 @@ struct ins_malloc_handler {
       return true;
    }
 };
+
+struct ins_malloc_inline_handler {
+   static const char* name() {
+      return "ins-malloc-inline";
+   }
+   static void* malloc(size_t s) {
+      return ins_malloc_inline(s);
+   }
+   static void free(void* p) {
+      ins_free(p);
+   }
+   static bool check(void* p) {
+      return true;
+   }
+};
@@ -4,6 +4,7 @@
 #include <ins/memory/controller.h>
 #include <ins/timing.h>
 #include <stdio.h>
+#include <string.h>
 #include <vector>
 #include <unordered_map>
 
@@ -65,9 +66,11 @@ namespace ManagedObjectsTests {
    }
 }
 
-mem::ManagedSchema mem::ManagedClass<ManagedObjectsTests::MyClass>::schema;
 
-int main() {
+int main(int argc, char* argv[]) {
+   if (argc > 1 && !strcmp(argv[1], "--first-malloc")) {
+      return test_startup_child();
+   }
    mem::InitializeHeap();
 
    //DescriptorsTests::test_descriptor_region();
@@ -115,6 +118,42 @@ int main() {
       mem::ThreadMemoryContext context;
       test_perf_alloc();
    }
+   if (1) {
+      printf("------------ Numa --------------\n");
+      test_perf_numa();
+   }
+   if (1) {
+      printf("------------ Active zone --------------\n");
+      test_active_zone();
+   }
+   if (1) {
+      printf("------------ Small objects peak --------------\n");
+      test_small_peak();
+   }
+   if (1) {
+      printf("------------ Persistent heap --------------\n");
+      test_persistent();
+   }
+   if (1) {
+      printf("------------ Cold regions --------------\n");
+      test_cold_regions();
+   }
+   if (1) {
+      printf("------------ Object page map --------------\n");
+      test_page_map();
+   }
+   if (1) {
+      printf("------------ Heap startup --------------\n");
+      test_startup();
+   }
+   if (1) {
+      printf("------------ Heap instances --------------\n");
+      test_heaps();
+   }
+   if (1) {
+      printf("------------ Shared heap --------------\n");
+      test_shared();
+   }
    if (0) {
       printf("------------ Cross-context --------------\n");
       mem::SetMaxUsablePhysicalBytes(size_t(1) << 31);
@@ -0,0 +1,66 @@
+#include <ins/memory/contexts.h>
+#include <ins/memory/controller.h>
+#include <stdio.h>
+#include <string.h>
+#include "./threading.h"
+#include "./test_perf_alloc.h"
+
+using namespace ins;
+
+/**********************************************************************
+*
+*   Object region active zone
+*
+*   Allocate objects of a layout with large regions, then free all but
+*   the first object of each region: the committed bytes shall follow
+*   the used objects instead of the region size.
+*
+***********************************************************************/
+
+static size_t test_active_zone_step(const char* name, size_t baseBytes) {
+   auto usedBytes = mem::GetUsedPhysicalBytes() - baseBytes;
+   printf("> %s: %s committed\n", name, mem::sz2a(usedBytes).c_str());
+   return usedBytes;
+}
+
+void test_active_zone() {
+   const size_t size = 12000;
+   auto layoutID = mem::getLayoutForSize(size);
+   auto& infos = mem::cst::ObjectLayoutInfos[layoutID];
+   size_t count = size_t(infos.region_objects) * 16;
+   printf("> layout %d: region %s with %d objects\n", int(layoutID), mem::sz2a(size_t(1) << infos.region_sizeL2).c_str(), int(infos.region_objects));
+
+   mem::ThreadMemoryContext context;
+   auto baseBytes = mem::GetUsedPhysicalBytes();
+   void** ptrs = new void* [count];
+
+   // Fill regions page per page
+   for (size_t i = 0; i < count / 2; i++) {
+      ptrs[i] = mem::AllocateObject(size);
+      memset(ptrs[i], 1, size);
+   }
+   auto halfBytes = test_active_zone_step("half filled", baseBytes);
+   for (size_t i = count / 2; i < count; i++) {
+      ptrs[i] = mem::AllocateObject(size);
+      memset(ptrs[i], 1, size);
+   }
+   auto fullBytes = test_active_zone_step("filled", baseBytes);
+   _INS_ASSERT(halfBytes < fullBytes);
+
+   // Keep only the first object of each region
+   for (size_t i = 0; i < count; i++) {
+      if (i % infos.region_objects) mem::FreeObject(ptrs[i]);
+   }
+   auto shrinkedBytes = test_active_zone_step("shrinked", baseBytes);
+   _INS_ASSERT(shrinkedBytes * 4 <= fullBytes);
+
+   // Regrow regions
+   for (size_t i = 0; i < count; i++) {
+      if (i % infos.region_objects) ptrs[i] = mem::AllocateObject(size);
+   }
+   test_active_zone_step("regrown", baseBytes);
+   for (size_t i = 0; i < count; i++) {
+      mem::FreeObject(ptrs[i]);
+   }
+   delete[] ptrs;
+}
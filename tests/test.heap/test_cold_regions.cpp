@@ -0,0 +1,109 @@
+#include <ins/memory/contexts.h>
+#include <ins/memory/controller.h>
+#include <ins/os/memory.h>
+#include <ins/timing.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "./threading.h"
+#include "./test_perf_alloc.h"
+
+using namespace ins;
+
+/**********************************************************************
+*
+*   Cold regions
+*
+*   Allocate objects and leave them unused: their regions shall be
+*   moved to the cold storage, with the same content at the same address,
+*   and promoted back to memory when the heap reuses them. Regions of
+*   objects written meanwhile shall stay hot.
+*
+***********************************************************************/
+
+void test_cold_regions() {
+   const char* filename = "./test-cold.swap";
+   const size_t size = 4000;
+   const size_t count = (size_t(256) << 20) / size;
+   if (!mem::SetColdStorage(filename, size_t(512) << 20)) {
+      printf("> cold storage not supported\n");
+      return;
+   }
+   {
+      mem::ThreadMemoryContext context;
+      uint64_t** ptrs = new uint64_t * [count];
+      for (size_t i = 0; i < count; i++) {
+         ptrs[i] = (uint64_t*)mem::AllocateObject(size);
+         for (size_t k = 0; k < size / sizeof(uint64_t); k++) ptrs[i][k] = i ^ k;
+      }
+      auto rssHot = os::GetResidentMemorySize();
+
+      // Let the worker demote the unused regions
+      mem::SetColdRegionsOptions(50, 2, mem::ColdPromotion::OnAccess);
+      mem::NotifyHeapWorker();
+      ins::timing::Chrono chrono;
+      auto stats = mem::GetMemoryStats();
+      const size_t hotCount = count / 8;
+      while (stats.cold_bytes < size * (count - hotCount) / 2 && chrono.GetDiffFloat(chrono.MS) < 10000) {
+         for (size_t i = 0; i < hotCount; i++) ptrs[i][3]++;
+         std::this_thread::sleep_for(std::chrono::milliseconds(10));
+         stats = mem::GetMemoryStats();
+      }
+      mem::SetColdRegionsOptions(0, 2, mem::ColdPromotion::OnAccess);
+      auto rssCold = os::GetResidentMemorySize();
+      printf("> demoted in %g ms: hot %s, cold %s (%zu regions), rss %s -> %s\n",
+         chrono.GetDiffFloat(chrono.MS), mem::sz2a(stats.used_bytes).c_str(), mem::sz2a(stats.cold_bytes).c_str(),
+         stats.cold_regions, mem::sz2a(rssHot).c_str(), mem::sz2a(rssCold).c_str());
+      if (stats.cold_bytes == 0) {
+         printf("! no region demoted\n");
+         exit(1);
+      }
+
+      // Written objects are not demoted
+      for (size_t i = 0; i < hotCount; i++) {
+         if (mem::IsColdRegion(mem::ObjectLocation(ptrs[i]).region)) {
+            printf("! written object %d is demoted\n", int(i));
+            exit(1);
+         }
+         ptrs[i][3] = i ^ 3;
+      }
+
+      // Objects are unchanged, read from the cold storage
+      for (size_t i = 0; i < count; i++) {
+         for (size_t k = 0; k < size / sizeof(uint64_t); k++) {
+            if (ptrs[i][k] != (i ^ k)) {
+               printf("! cold object %d is corrupted\n", int(i));
+               exit(1);
+            }
+         }
+      }
+
+      // Free the half of the objects, their regions are promoted
+      for (size_t i = 0; i < count; i += 2) {
+         mem::FreeObject(ptrs[i]);
+      }
+      auto promoted = mem::GetMemoryStats();
+      printf("> after reuse: cold %s (%zu regions)\n", mem::sz2a(promoted.cold_bytes).c_str(), promoted.cold_regions);
+      if (promoted.cold_bytes >= stats.cold_bytes) {
+         printf("! reused regions are not promoted\n");
+         exit(1);
+      }
+      for (size_t i = 1; i < count; i += 2) {
+         if (ptrs[i][7] != (i ^ 7)) {
+            printf("! promoted object %d is corrupted\n", int(i));
+            exit(1);
+         }
+         mem::FreeObject(ptrs[i]);
+      }
+      delete[] ptrs;
+   }
+   mem::PerformHeapCleanup();
+
+   auto stats = mem::GetMemoryStats();
+   if (stats.cold_regions) {
+      printf("! %zu regions left in the cold storage\n", stats.cold_regions);
+      exit(1);
+   }
+   mem::SetColdStorage(0, 0);
+   remove(filename);
+}
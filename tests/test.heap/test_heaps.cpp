@@ -0,0 +1,110 @@
+#include <ins/memory/controller.h>
+#include <ins/timing.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "./threading.h"
+#include "./test_perf_alloc.h"
+
+using namespace ins;
+
+/**********************************************************************
+*
+*   Heap instances
+*
+*   Allocate in isolated heaps: a heap reaching its physical limit
+*   shall not starve the other heaps, objects can be freed from any
+*   context, and deleting a heap shall release all its objects at once.
+*
+***********************************************************************/
+
+namespace {
+   size_t fill_heap(mem::HeapDescriptor* heap, void** ptrs, size_t count, size_t size) {
+      mem::ThreadMemoryContext scope(mem::AcquireContext(heap), true);
+      size_t allocated = 0;
+      try {
+         for (; allocated < count; allocated++) {
+            ptrs[allocated] = mem::AllocateObject(size);
+         }
+      }
+      catch (mem::exception_missing_memory&) {
+      }
+      return allocated;
+   }
+
+   void check_limits() {
+      const size_t limit = size_t(64) << 20;
+      const size_t count = size_t(1) << 20;
+      void** ptrs = new void* [count];
+      auto heapA = mem::CreateHeap(limit);
+      auto heapB = mem::CreateHeap(limit);
+
+      // Heap A reaches its limit, heap B and the process heap are still usable
+      auto countA = fill_heap(heapA, ptrs, count, 1000);
+      if (countA == count || mem::GetHeapUsedBytes(heapA) > limit) {
+         printf("! heap limit is not applied\n");
+         exit(1);
+      }
+      auto countB = fill_heap(heapB, ptrs + countA, 1000, 1000);
+      if (countB != 1000) {
+         printf("! heap starved by another heap\n");
+         exit(1);
+      }
+      mem::FreeObject(mem::AllocateObject(1000));
+
+      // Objects of heap A are freed from the process heap context
+      for (size_t i = 0; i < countA; i++) {
+         mem::FreeObject(ptrs[i]);
+      }
+      mem::PerformHeapCleanup(heapA);
+      printf("> limit: %zu objects in heap A (%s used after free), heap B not starved\n",
+         countA, mem::sz2a(mem::GetHeapUsedBytes(heapA)).c_str());
+      if (fill_heap(heapA, ptrs, 1000, 1000) != 1000) {
+         printf("! heap memory not recovered after free\n");
+         exit(1);
+      }
+
+      mem::DeleteHeap(heapA);
+      mem::DeleteHeap(heapB);
+      delete[] ptrs;
+   }
+
+   void check_delete(size_t count, size_t size) {
+      void** ptrs = new void* [count];
+      auto heap = mem::CreateHeap();
+      if (fill_heap(heap, ptrs, count, size) != count) {
+         printf("! unlimited heap is starved\n");
+         exit(1);
+      }
+      auto used = mem::GetHeapUsedBytes(heap);
+
+      Chrono chrono;
+      chrono.Start();
+      mem::DeleteHeap(heap);
+      auto deleteTime = chrono.GetDiffFloat(Chrono::MS);
+      for (size_t i = 0; i < count; i += 997) {
+         if (mem::ObjectLocation(ptrs[i]).object) {
+            printf("! object of a deleted heap is still located\n");
+            exit(1);
+         }
+      }
+
+      chrono.Start();
+      {
+         mem::ThreadMemoryContext scope;
+         for (size_t i = 0; i < count; i++) {
+            mem::FreeObject(mem::AllocateObject(size));
+         }
+      }
+      auto freeTime = chrono.GetDiffFloat(Chrono::MS);
+      printf("> delete heap: %g ms for %zu objects of %zu bytes (%s), same objects allocated and freed one by one: %g ms\n",
+         deleteTime, count, size, mem::sz2a(used).c_str(), freeTime);
+
+      delete[] ptrs;
+   }
+}
+
+void test_heaps() {
+   check_limits();
+   check_delete(size_t(1) << 22, 48);
+   check_delete(size_t(1) << 16, 20000);
+}
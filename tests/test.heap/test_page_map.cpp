@@ -0,0 +1,143 @@
+#include <ins/memory/contexts.h>
+#include <ins/memory/controller.h>
+#include <ins/memory/analysis.h>
+#include <ins/timing.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "./threading.h"
+#include "./test_perf_alloc.h"
+
+using namespace ins;
+
+/**********************************************************************
+*
+*   Object page map
+*
+*   Classify pointers with the page map and with the arena map: the
+*   locations shall be the same. Free and mark paths are timed with
+*   pointers visited in random order.
+*
+***********************************************************************/
+
+namespace {
+   struct MarkedNode : mem::ManagedClass<MarkedNode> {
+      uint64_t value = 0;
+      static void __traverser__(mem::TraversalContext<mem::sObjectSchema, MarkedNode>& context) {
+      }
+   };
+
+   struct PointersTracker : mem::IObjectReferenceTracker {
+      void** ptrs;
+      size_t count;
+      PointersTracker(void** ptrs, size_t count) : ptrs(ptrs), count(count) {
+         mem::RegisterReferenceTracker(this);
+      }
+      ~PointersTracker() {
+         mem::UnregisterReferenceTracker(this);
+      }
+      void MarkObjects(mem::ObjectAnalysisSession& session) override {
+         for (size_t i = 0; i < this->count; i++) {
+            session.MarkPtr(this->ptrs[i]);
+         }
+      }
+   };
+
+   void shuffle_pointers(void** ptrs, size_t count) {
+      for (size_t i = count - 1; i > 0; i--) {
+         auto j = ((size_t(fastrand()) << 15) | size_t(fastrand())) % (i + 1);
+         std::swap(ptrs[i], ptrs[j]);
+      }
+   }
+
+   void compare_classification(const char* name, void** ptrs, size_t count) {
+      mem::ObjectLocation loc(ptrs[0]);
+      size_t mapped = 0;
+      for (size_t i = 0; i < count; i++) {
+         mem::ObjectLocation ref(ptrs[i]);
+         ref.LocateInArena(ptrs[i]);
+         if (loc.LocateInPage(ptrs[i])) {
+            mapped++;
+            if (loc.object != ref.object || loc.region != ref.region || loc.index != ref.index ||
+               loc.layout != ref.layout || loc.managed != ref.managed) {
+               printf("! page map location differs for %p\n", ptrs[i]);
+               exit(1);
+            }
+         }
+      }
+
+      uintptr_t check = 0;
+      Chrono chrono;
+      chrono.Start();
+      for (size_t i = 0; i < count; i++) {
+         mem::ObjectLocation loc(ptrs[i]);
+         check += uintptr_t(loc.object);
+      }
+      auto pageTime = chrono.GetDiffFloat(Chrono::NS) / float(count);
+      chrono.Start();
+      for (size_t i = 0; i < count; i++) {
+         loc.LocateInArena(ptrs[i]);
+         check -= uintptr_t(loc.object);
+      }
+      auto arenaTime = chrono.GetDiffFloat(Chrono::NS) / float(count);
+      printf("> %s: classify %g ns with page map (%d%% mapped), %g ns with arena map\n",
+         name, pageTime, int(mapped * 100 / count), arenaTime);
+      if (check != 0) {
+         printf("! page map and arena map locations differ\n");
+         exit(1);
+      }
+   }
+
+   void test_free_path(const char* name, size_t sizeMin, size_t sizeMax, size_t count) {
+      mem::ThreadMemoryContext context;
+      void** ptrs = new void* [count];
+      for (size_t i = 0; i < count; i++) {
+         ptrs[i] = mem::AllocateObject(sizeMin + size_t(fastrand()) % (sizeMax - sizeMin + 1));
+      }
+      shuffle_pointers(ptrs, count);
+      compare_classification(name, ptrs, count);
+
+      Chrono chrono;
+      chrono.Start();
+      for (size_t i = 0; i < count; i++) {
+         mem::FreeObject(ptrs[i]);
+      }
+      printf("> %s: free %g ns\n", name, chrono.GetDiffFloat(Chrono::NS) / float(count));
+      delete[] ptrs;
+   }
+
+   void test_mark_path(size_t count) {
+      mem::ThreadMemoryContext context;
+      void** ptrs = new void* [count];
+      for (size_t i = 0; i < count; i++) {
+         ptrs[i] = new MarkedNode();
+      }
+      shuffle_pointers(ptrs, count);
+      compare_classification("managed", ptrs, count);
+      {
+         PointersTracker tracker(ptrs, count);
+         Chrono chrono;
+         chrono.Start();
+         mem::MarkAndSweepUnusedObjects();
+         printf("> managed: mark and sweep %g ns per object\n", chrono.GetDiffFloat(Chrono::NS) / float(count));
+      }
+      for (size_t i = 0; i < count; i++) {
+         if (!mem::ObjectLocation(ptrs[i]).IsAllocated()) {
+            printf("! marked object is swept\n");
+            exit(1);
+         }
+         delete (MarkedNode*)ptrs[i];
+      }
+      delete[] ptrs;
+   }
+}
+
+void test_page_map() {
+   if (!mem::ObjectPageMap) {
+      printf("> page map not enabled (build with _INS_OBJECT_PAGE_MAP=1)\n");
+      return;
+   }
+   test_free_path("small", 48, 48, size_t(1) << 22);
+   test_free_path("medium", 1500, 1500, size_t(1) << 18);
+   test_free_path("mixed", 16, 16000, size_t(1) << 18);
+   test_mark_path(size_t(1) << 22);
+}
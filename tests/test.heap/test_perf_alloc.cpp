@@ -1,7 +1,7 @@
 #include "./test_perf_alloc.h"
 #include <vector>
+#include <algorithm>
 #include <mimalloc.h>
-#include <intrin.h>
 
 #define USE_MIMALLOC 1
 
@@ -39,7 +39,7 @@ struct tTest {
    }
 
    template<class handler>
-   __declspec(noinline) void apply_fill_and_flush() {
+   _INS_NOINLINE void apply_fill_and_flush() {
       Chrono c;
       std::vector<void*> objects(count);
       int sizeDelta = sizeMax - sizeMin;
@@ -67,7 +67,7 @@ struct tTest {
    }
 
    template<class handler>
-   __declspec(noinline) void apply_peak_drop(int alloc_count, int free_count, intptr_t max_cycle) {
+   _INS_NOINLINE void apply_peak_drop(int alloc_count, int free_count, intptr_t max_cycle) {
       Chrono c;
       std::vector<void*> objects(count);
       int sizeDelta = sizeMax - sizeMin;
@@ -111,20 +111,97 @@ struct tTest {
       wait_ms(50);
    }
 
-   __declspec(noinline) void test_multi_thread_perf() {
+   template<class handler>
+   _INS_NOINLINE void apply_small_batches(int batch_count, int batch_size) {
+      Chrono c;
+      std::vector<void*> objects(batch_size);
+      int sizeDelta = sizeMax - sizeMin;
+
+      c.Start();
+      for (int b = 0; b < batch_count; b++) {
+         for (int i = 0; i < batch_size; i++) {
+            int size = sizeMin + (sizeDelta ? fastrand() % sizeDelta : 0);
+            auto ptr = objects[i] = handler::malloc(size);
+            mem::ObjectBytes((void*)ptr)[0] = 1;
+         }
+         for (int i = 0; i < batch_size; i++) {
+            handler::free(objects[i]);
+         }
+      }
+
+      printf("[%s] time = %g ns\n", handler::name(), c.GetDiffFloat(Chrono::NS) / float(batch_count * batch_size * 2));
+
+      wait_ms(50);
+   }
+
+   template<class handler>
+   _INS_NOINLINE void apply_fixed_size_batches(int batch_count, int batch_size) {
+      Chrono c;
+      std::vector<void*> objects(batch_size);
+
+      c.Start();
+      for (int b = 0; b < batch_count; b++) {
+         for (int i = 0; i < batch_size; i++) {
+            auto ptr = objects[i] = handler::malloc();
+            mem::ObjectBytes((void*)ptr)[0] = 1;
+         }
+         for (int i = 0; i < batch_size; i++) {
+            handler::free(objects[i]);
+         }
+      }
+
+      printf("[%s] time = %g ns\n", handler::name(), c.GetDiffFloat(Chrono::NS) / float(batch_count * batch_size * 2));
+
+      wait_ms(50);
+   }
+
+   _INS_NOINLINE void apply_batch_api(int batch_count, int batch_size, size_t size, bool batched) {
+      Chrono c;
+      std::vector<void*> objects(batch_size);
+
+      c.Start();
+      for (int b = 0; b < batch_count; b++) {
+         if (batched) {
+            mem::AllocateObjects(size, batch_size, objects.data());
+         }
+         else {
+            for (int i = 0; i < batch_size; i++) objects[i] = mem::AllocateObject(size);
+         }
+         for (int i = 0; i < batch_size; i++) {
+            mem::ObjectBytes((void*)objects[i])[0] = 1;
+         }
+         if (batched) {
+            mem::FreeObjects(objects.data(), batch_size);
+         }
+         else {
+            for (int i = 0; i < batch_size; i++) mem::FreeObject(objects[i]);
+         }
+      }
+      auto time_ns = c.GetDiffFloat(Chrono::NS);
+
+      printf("[%s] size = %d, time = %g ns, throughput = %g Mobjects/s\n", batched ? "ins-batch" : "ins-single",
+         int(size), time_ns / float(batch_count * batch_size * 2), float(batch_count) * batch_size * 1000 / time_ns);
+
+      wait_ms(50);
+   }
+
+   _INS_NOINLINE void test_multi_thread_perf() {
       int size_min = 10, size_max = 4000;
       MultiThreadAllocTest<4> multi;
 
 #define TestID 2
 #if TestID == 1
       GenericAllocTest<default_malloc_handler>().Run(size_min, size_max);
-      multi.Run(&GenericAllocTest<default_malloc_handler>(), size_min, size_max);
+      GenericAllocTest<default_malloc_handler> test;
+      multi.Run(&test, size_min, size_max);
 #elif TestID == 2
       GenericAllocTest<mi_malloc_handler>().Run(size_min, size_max);
-      multi.Run(&GenericAllocTest<mi_malloc_handler>(), size_min, size_max);
+      GenericAllocTest<mi_malloc_handler> test;
+      multi.Run(&test, size_min, size_max);
 #elif TestID == 3
       GenericAllocTest<ins_malloc_handler>().Run(size_min, size_max);
-      multi.Run(&GenericAllocTest<ins_malloc_handler>(), size_min, size_max);
+      GenericAllocTest<ins_malloc_handler> test;
+      multi.Run(&test, size_min, size_max);
 #endif
    }
 
@@ -141,6 +218,89 @@ struct tTest {
       }
    }
 
+   void test_small_batches(int batch_count, int batch_size) {
+      printf("---------------- Pattern: small batches --------------------\n");
+      auto sizeMin = this->sizeMin, sizeMax = this->sizeMax;
+      this->sizeMin = 16;
+      this->sizeMax = 256;
+      for (int i = 0; i < 3; i++) {
+#ifndef _DEBUG
+         this->apply_small_batches<mi_malloc_handler>(batch_count, batch_size);
+#endif
+         this->apply_small_batches<ins_malloc_handler>(batch_count, batch_size);
+         this->apply_small_batches<ins_malloc_inline_handler>(batch_count, batch_size);
+         printf("                     * * *\n");
+      }
+      this->sizeMin = sizeMin;
+      this->sizeMax = sizeMax;
+   }
+
+   void test_fixed_size_batches(int batch_count, int batch_size) {
+      printf("---------------- Pattern: fixed size batches --------------------\n");
+      const size_t size = 64;
+      struct mi_fixed_handler {
+         static const char* name() { return "mi-malloc"; }
+         static void* malloc() { return mi_malloc(size); }
+         static void free(void* p) { mi_free(p); }
+      };
+      struct ins_fixed_handler {
+         static const char* name() { return "ins-malloc-inline"; }
+         static void* malloc() { return ins_malloc_inline(size); }
+         static void free(void* p) { ins_free(p); }
+      };
+      struct ins_sized_handler {
+         static const char* name() { return "ins-free-sized"; }
+         static void* malloc() { return ins_malloc_inline(size); }
+         static void free(void* p) { ins_free_sized(p, size); }
+      };
+      struct ins_static_handler {
+         static const char* name() { return "ins-static-size"; }
+         static void* malloc() { return mem::AllocateObject<size>(); }
+         static void free(void* p) { mem::FreeObject<size>(p); }
+      };
+      auto ptr = mem::AllocateObject<size>();
+      if (mem::ObjectLocation(ptr).layout != mem::getLayoutForSize(size + sizeof(mem::sObjectHeader))) {
+         printf("! static size object is not in its size class\n");
+         exit(1);
+      }
+      mem::FreeObject<size>(ptr);
+      for (int i = 0; i < 3; i++) {
+#ifndef _DEBUG
+         this->apply_fixed_size_batches<mi_fixed_handler>(batch_count, batch_size);
+#endif
+         this->apply_fixed_size_batches<ins_fixed_handler>(batch_count, batch_size);
+         this->apply_fixed_size_batches<ins_sized_handler>(batch_count, batch_size);
+         this->apply_fixed_size_batches<ins_static_handler>(batch_count, batch_size);
+         printf("                     * * *\n");
+      }
+   }
+
+   void test_batch_api(int batch_count, int batch_size) {
+      printf("---------------- Pattern: batch api --------------------\n");
+
+      // Check batch objects are distinct and alive, then freed
+      std::vector<void*> objects(batch_size);
+      mem::AllocateObjects(64, batch_size, objects.data());
+      std::vector<void*> sorted = objects;
+      std::sort(sorted.begin(), sorted.end());
+      if (std::unique(sorted.begin(), sorted.end()) != sorted.end() || !mem::ObjectLocation(objects.back()).IsAlive()) {
+         printf("! batch allocation is corrupted\n");
+         exit(1);
+      }
+      if (mem::FreeObjects(objects.data(), batch_size) != batch_size || mem::ObjectLocation(objects.back()).IsAllocated()) {
+         printf("! batch free is corrupted\n");
+         exit(1);
+      }
+
+      for (size_t size : {16, 64, 400}) {
+         for (int i = 0; i < 2; i++) {
+            this->apply_batch_api(batch_count, batch_size, size, false);
+            this->apply_batch_api(batch_count, batch_size, size, true);
+         }
+         printf("                     * * *\n");
+      }
+   }
+
    void test_peak_drop(int alloc_count, int free_count, intptr_t max_cycle) {
       if (alloc_count < free_count) throw;
       printf("---------------- Pattern: peak - drop --------------------\n");
@@ -176,6 +336,10 @@ void test_perf_alloc() {
    //test.test_peak_drop(20, 20, max_cycle);
    test.test_peak_drop(100, 50, max_cycle);
 
+   test.test_small_batches(20000, 1000);
+   test.test_fixed_size_batches(20000, 1000);
+   test.test_batch_api(20000, 1000);
+
    test.test_fill_and_flush();
 
    printf("------------------ end ------------------\n");
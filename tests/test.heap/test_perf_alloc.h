@@ -1,5 +1,6 @@
 #include "./handlers.h"
-#include <windows.h>
+#include <thread>
+#include <string.h>
 
 struct AllocTest {
    float meanTime;
@@ -29,7 +30,7 @@ struct AllocTest {
       this->RunLoop();
       this->EndInfos();
    }
-   __declspec(noinline) void RunLoop() {
+   _INS_NOINLINE void RunLoop() {
       intptr_t count = 500000;
       intptr_t* buffers = new intptr_t[count];
       intptr_t buffersCount = 0;
@@ -104,12 +105,13 @@ struct MultiThreadAllocTest {
          //threadTests[i]->StartInfos();
       }
 
-      HANDLE hThreads[numThread];
+      std::thread threads[numThread];
       for (int i = 0; i < numThread; i++) {
-         DWORD ThreadID;
-         hThreads[i] = CreateThread(NULL, 0, MultiThreadAllocTest::StaticThreadStart, (void*)threadTests[i], 0, &ThreadID);
+         threads[i] = std::thread(MultiThreadAllocTest::StaticThreadStart, (void*)threadTests[i]);
+      }
+      for (int i = 0; i < numThread; i++) {
+         threads[i].join();
       }
-      WaitForMultipleObjects(numThread, hThreads, true, -1);
 
       float mean_times = 0;
       for (int i = 0; i < numThread; i++) {
@@ -120,10 +122,19 @@ struct MultiThreadAllocTest {
       mean_times /= numThread;
       printf("> MultiThread time = %g ns\n", mean_times);
    }
-   static DWORD WINAPI StaticThreadStart(void* Param) {
+   static void StaticThreadStart(void* Param) {
       ((AllocTest*)Param)->RunLoop();
-      return 0;
    }
 };
 
 extern void test_perf_alloc();
+extern void test_perf_numa();
+extern void test_active_zone();
+extern void test_small_peak();
+extern void test_persistent();
+extern void test_cold_regions();
+extern void test_page_map();
+extern void test_startup();
+extern int test_startup_child();
+extern void test_heaps();
+extern void test_shared();
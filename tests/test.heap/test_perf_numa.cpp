@@ -0,0 +1,101 @@
+#include <ins/memory/contexts.h>
+#include <ins/memory/controller.h>
+#include <ins/timing.h>
+#include <stdio.h>
+#include <string.h>
+#include "./threading.h"
+
+using namespace ins;
+
+/**********************************************************************
+*
+*   NUMA local vs remote allocation
+*
+*   Compare a context homed on the node of the running thread with a
+*   context homed on another node. On a single node machine a fake
+*   second logical node is configured (no binding, same timings expected).
+*   For real measures, pin the process: numactl --cpunodebind=0 test-ins.memory.heap
+*
+***********************************************************************/
+
+static void test_perf_numa_node(const char* name, uint8_t homeNode) {
+   const size_t count = 4000000;
+   const size_t size = 64;
+   void** ptrs = new void* [count];
+
+   auto context = mem::AcquireContext(false);
+   context->SetHomeNode(homeNode);
+   mem::ThreadMemoryContext scope(context, true);
+
+   ins::timing::Chrono chrono;
+   for (size_t i = 0; i < count; i++) {
+      ptrs[i] = mem::AllocateObject(size);
+   }
+   double allocTime = chrono.GetDiffFloat(chrono.S);
+
+   chrono.Start();
+   for (int pass = 0; pass < 4; pass++) {
+      for (size_t i = 0; i < count; i++) {
+         memset(ptrs[i], pass, size);
+      }
+   }
+   double accessTime = chrono.GetDiffFloat(chrono.S);
+
+   for (size_t i = 0; i < count; i++) {
+      mem::FreeObject(ptrs[i]);
+   }
+   delete[] ptrs;
+
+   printf("> %s (node %d): alloc %g Mops/s, access %g Go/s\n",
+      name, int(homeNode),
+      count / allocTime * 1e-6,
+      4.0 * count * size / accessTime * 1e-9
+   );
+}
+
+static void test_numa_home_change(uint8_t fromNode, uint8_t toNode) {
+   const size_t count = 10000;
+   void** ptrs = new void* [count];
+
+   // Objects allocated on a node, then freed once the context moved to another node
+   auto context = mem::AcquireContext(false);
+   context->SetHomeNode(fromNode);
+   mem::ThreadMemoryContext scope(context, true);
+   for (size_t i = 0; i < count; i++) {
+      ptrs[i] = mem::AllocateObject(64);
+   }
+   context->SetHomeNode(toNode);
+   for (size_t i = 0; i < count; i++) {
+      mem::FreeObject(ptrs[i]);
+   }
+   delete[] ptrs;
+   auto ptr = mem::AllocateObject(64);
+   _INS_ASSERT(mem::GetRegionNumaNode(mem::ObjectLocation(ptr).region) == toNode);
+   mem::FreeObject(ptr);
+
+   // The context owns only regions of its home node
+   size_t owneds = 0, remotes = 0;
+   context->central->ForeachObjectRegion(
+      [&](mem::ObjectRegion region) {
+         if (region->owner == &context->unmanaged || region->owner == &context->managed) {
+            owneds++;
+            if (mem::GetRegionNumaNode(region) != context->numaNode) remotes++;
+         }
+         return true;
+      }
+   );
+   printf("> home node change %d -> %d: %zu owned regions, %zu remote\n", int(fromNode), int(toNode), owneds, remotes);
+   _INS_ASSERT(remotes == 0);
+}
+
+void test_perf_numa() {
+   if (mem::GetNumaNodeCount() < 2) {
+      printf("> single numa node: use fake numa\n");
+      mem::SetNumaNodesOption(2);
+   }
+   auto localNode = mem::GetCurrentNumaNode();
+   auto remoteNode = uint8_t((localNode + 1) % mem::GetNumaNodeCount());
+   test_perf_numa_node("local", localNode);
+   test_perf_numa_node("remote", remoteNode);
+   test_numa_home_change(localNode, remoteNode);
+}
@@ -0,0 +1,151 @@
+#include <ins/memory/persistent.h>
+#include <ins/memory/controller.h>
+#include <ins/timing.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "./threading.h"
+#include "./test_perf_alloc.h"
+
+using namespace ins;
+
+/**********************************************************************
+*
+*   Persistent heap restart
+*
+*   Build a 1Go object graph in a persistent heap, close it and reopen
+*   it: the graph shall be usable right after the open, without any
+*   deserialization (only regions and schemas are rebound).
+*
+***********************************************************************/
+
+namespace {
+   struct PersistentNode : mem::ManagedClass<PersistentNode> {
+      PersistentNode* next = 0;
+      PersistentNode* link = 0;
+      uint64_t value = 0;
+      uint64_t payload[12];
+      static void __traverser__(mem::TraversalContext<mem::sObjectSchema, PersistentNode>& context) {
+         context.visit_ref(offsetof(PersistentNode, next));
+         context.visit_ref(offsetof(PersistentNode, link));
+      }
+   };
+
+   uint64_t checksum_graph(PersistentNode* head, size_t& count) {
+      uint64_t sum = 0;
+      count = 0;
+      for (auto cur = head; cur; cur = cur->next) {
+         sum += cur->value ^ cur->link->value ^ cur->payload[cur->value % 12];
+         count++;
+      }
+      return sum;
+   }
+}
+
+void test_persistent() {
+   const char* filename = "./test-persistent.heap";
+   const size_t count = size_t(1) << 23; // 8M objects of 128 bytes (with header)
+   const size_t sizeLimit = size_t(16) << 30;
+   remove(filename);
+
+   // Build the graph
+   uint64_t sum = 0;
+   {
+      ins::timing::Chrono chrono;
+      auto heap = mem::PersistentHeap::Open(filename, sizeLimit, true);
+      if (!heap) {
+         printf("! cannot open persistent heap\n");
+         exit(1);
+      }
+      {
+         mem::ThreadMemoryContext scope(heap->GetContext(), false);
+         PersistentNode* head = 0;
+         PersistentNode** nodes = new PersistentNode * [count];
+         for (size_t i = 0; i < count; i++) {
+            auto node = new PersistentNode();
+            node->value = i;
+            for (int k = 0; k < 12; k++) node->payload[k] = i * 31 + k;
+            node->next = head;
+            node->link = i ? nodes[rand() % i] : node;
+            nodes[i] = head = node;
+         }
+         delete[] nodes;
+         heap->SetRoot(0, head);
+         size_t n = 0;
+         sum = checksum_graph(head, n);
+         if (n != count) {
+            printf("! persistent graph is not built\n");
+            exit(1);
+         }
+      }
+      double buildTime = chrono.GetDiffFloat(chrono.MS);
+      chrono.Start();
+      delete heap;
+      printf("> build: %g ms for %g Mo, close: %g ms\n",
+         buildTime, double(count * (sizeof(PersistentNode) + sizeof(mem::sObjectHeader))) / (1 << 20), chrono.GetDiffFloat(chrono.MS));
+   }
+
+   // Reopen and use the graph
+   {
+      ins::timing::Chrono chrono;
+      auto heap = mem::PersistentHeap::Open(filename, sizeLimit);
+      if (!heap) {
+         printf("! cannot reopen persistent heap\n");
+         exit(1);
+      }
+      double openTime = chrono.GetDiffFloat(chrono.MS);
+
+      chrono.Start();
+      size_t n = 0;
+      auto head = (PersistentNode*)heap->GetRoot(0);
+      auto restored_sum = checksum_graph(head, n);
+      double walkTime = chrono.GetDiffFloat(chrono.MS);
+      printf("> restart: open %g ms, first walk %g ms (%d nodes)\n", openTime, walkTime, int(n));
+      if (n != count || restored_sum != sum) {
+         printf("! persistent graph is corrupted\n");
+         exit(1);
+      }
+      mem::ObjectLocation loc(head);
+      if (!loc.IsAlive() || mem::GetObjectSchema(loc.object->schema_id)->infos != &PersistentNode::schema) {
+         printf("! persistent graph schema is not rebound\n");
+         exit(1);
+      }
+
+      // Free the half of the graph and grow it again, regions are reused
+      {
+         mem::ThreadMemoryContext scope(heap->GetContext(), false);
+         auto cur = head;
+         for (size_t i = 0; i < count / 2; i++) {
+            auto next = cur->next;
+            delete cur;
+            cur = next;
+         }
+         auto arenas = heap->GetArenasCount();
+         for (size_t i = 0; i < count / 2; i++) {
+            auto node = new PersistentNode();
+            node->value = i;
+            node->next = cur;
+            node->link = cur;
+            cur = node;
+         }
+         heap->SetRoot(0, cur);
+         if (heap->GetArenasCount() != arenas) {
+            printf("! persistent regions are not reused (%d arenas, %d before)\n", int(heap->GetArenasCount()), int(arenas));
+            exit(1);
+         }
+      }
+      delete heap;
+   }
+
+   // Reopen the modified graph
+   {
+      auto heap = mem::PersistentHeap::Open(filename, sizeLimit);
+      size_t n = 0;
+      for (auto cur = (PersistentNode*)heap->GetRoot(0); cur; cur = cur->next) n++;
+      if (n != count) {
+         printf("! persistent graph is corrupted after reuse\n");
+         exit(1);
+      }
+      delete heap;
+   }
+   remove(filename);
+}
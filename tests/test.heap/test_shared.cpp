@@ -0,0 +1,158 @@
+#include <ins/memory/shared.h>
+#include <ins/memory/controller.h>
+#include <ins/timing.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "./threading.h"
+#include "./test_perf_alloc.h"
+
+#if defined(__linux__)
+#include <unistd.h>
+#include <sys/wait.h>
+#endif
+
+using namespace ins;
+
+/**********************************************************************
+*
+*   Shared heap
+*
+*   Build an object list in a heap shared with a forked process: the
+*   child shall read it without copy and free it, while the parent
+*   allocates in the same region classes. The parent shall reuse the
+*   freed regions and read the list allocated by the child. Contexts
+*   of processes exited without detach shall be adopted.
+*
+***********************************************************************/
+
+namespace {
+   struct SharedNode {
+      SharedNode* next = 0;
+      uint64_t value = 0;
+      uint64_t payload[6];
+   };
+
+   SharedNode* build_list(size_t count, uint64_t seed) {
+      SharedNode* head = 0;
+      for (size_t i = 0; i < count; i++) {
+         auto node = new(mem::AllocateObject(sizeof(SharedNode))) SharedNode();
+         node->value = seed + i;
+         for (int k = 0; k < 6; k++) node->payload[k] = node->value * 31 + k;
+         node->next = head;
+         head = node;
+      }
+      return head;
+   }
+
+   uint64_t checksum_list(SharedNode* head, size_t& count) {
+      uint64_t sum = 0;
+      count = 0;
+      for (auto cur = head; cur; cur = cur->next) {
+         sum += cur->value ^ cur->payload[cur->value % 6];
+         count++;
+      }
+      return sum;
+   }
+
+   void free_list(SharedNode* head) {
+      while (head) {
+         auto next = head->next;
+         mem::FreeObject(head);
+         head = next;
+      }
+   }
+}
+
+void test_shared() {
+#if defined(__linux__)
+   const size_t count = size_t(1) << 20;
+   auto heap = mem::SharedHeap::Create(0, size_t(1) << 30);
+   if (!heap) {
+      printf("! cannot create shared heap\n");
+      exit(1);
+   }
+
+   // Parent builds the list
+   ins::timing::Chrono chrono;
+   uint64_t sum = 0;
+   {
+      mem::ThreadMemoryContext scope(heap->GetContext(), false);
+      auto head = build_list(count, 0);
+      size_t n = 0;
+      sum = checksum_list(head, n);
+      heap->SetRoot(0, head);
+   }
+   auto usedBytes = heap->GetUsedBytes();
+   double buildTime = chrono.GetDiffFloat(chrono.MS);
+
+   // Child reads and frees the list, then replies with its own list
+   chrono.Start();
+   auto child = fork();
+   if (child == 0) {
+      int status = 0;
+      {
+         mem::ThreadMemoryContext scope(heap->GetContext(), false);
+         size_t n = 0;
+         auto head = (SharedNode*)heap->GetRoot(0);
+         if (checksum_list(head, n) != sum || n != count) status = 2;
+         free_list(head);
+         heap->SetRoot(1, build_list(count / 2, count));
+      }
+      delete heap;
+      _exit(status);
+   }
+   {
+      // Contend the region allocations with the child
+      mem::ThreadMemoryContext scope(heap->GetContext(), false);
+      for (int pass = 0; pass < 8; pass++) {
+         free_list(build_list(count / 8, 0));
+      }
+   }
+   int status = -1;
+   waitpid(child, &status, 0);
+   double childTime = chrono.GetDiffFloat(chrono.MS);
+   if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+      printf("! shared list is corrupted in the child process\n");
+      exit(1);
+   }
+
+   // Parent reads the reply, and reuses the regions freed by the child
+   {
+      mem::ThreadMemoryContext scope(heap->GetContext(), false);
+      size_t n = 0;
+      auto reply = (SharedNode*)heap->GetRoot(1);
+      checksum_list(reply, n);
+      if (n != count / 2 || reply->value != count + n - 1) {
+         printf("! shared list of the child process is corrupted\n");
+         exit(1);
+      }
+      auto replyBytes = heap->GetUsedBytes() - usedBytes;
+      free_list(build_list(count, 0));
+      if (heap->GetUsedBytes() > usedBytes + replyBytes) {
+         printf("! regions freed by the child process are not reused\n");
+         exit(1);
+      }
+      free_list(reply);
+   }
+   printf("> build: %g ms for %d objects, child read+free+reply: %g ms (%s used)\n",
+      buildTime, int(count), childTime, mem::sz2a(heap->GetUsedBytes()).c_str());
+
+   // Processes exiting without detach: their context slots are reclaimed
+   for (size_t i = 0; i < mem::SharedHeap::cMaxContexts + 8; i++) {
+      auto child = fork();
+      if (child == 0) {
+         mem::ThreadMemoryContext scope(heap->GetContext(), false);
+         mem::FreeObject(mem::AllocateObject(64));
+         _exit(0);
+      }
+      waitpid(child, &status, 0);
+      if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+         printf("! context of an exited process is not reclaimed\n");
+         exit(1);
+      }
+   }
+   delete heap;
+#else
+   printf("> shared heap not supported\n");
+#endif
+}
@@ -0,0 +1,58 @@
+#include <ins/memory/contexts.h>
+#include <ins/memory/controller.h>
+#include <ins/os/memory.h>
+#include <stdio.h>
+#include <string.h>
+#include "./threading.h"
+#include "./test_perf_alloc.h"
+
+using namespace ins;
+
+/**********************************************************************
+*
+*   Small objects peak
+*
+*   Allocate a peak of small objects (regions batched in 64Ko pages),
+*   free them and cleanup the heap: the batched pages shall be given
+*   back to the system.
+*
+***********************************************************************/
+
+void test_small_peak() {
+   const size_t count = 4000000;
+   const size_t size = 48;
+
+   // Caches of the previous tests are cleaned first: the measured cleanup releases the peak pages only
+   mem::PerformHeapCleanup();
+   auto rssStart = os::GetResidentMemorySize();
+   size_t rssPeak = 0;
+
+   {
+      mem::ThreadMemoryContext context;
+      void** ptrs = new void* [count];
+      for (size_t i = 0; i < count; i++) {
+         ptrs[i] = mem::AllocateObject(size);
+         memset(ptrs[i], 1, size);
+      }
+      rssPeak = os::GetResidentMemorySize();
+      printf("> peak: rss %s (+%s)\n", mem::sz2a(rssPeak).c_str(), mem::sz2a(rssPeak - rssStart).c_str());
+
+      for (size_t i = 0; i < count; i++) {
+         mem::FreeObject(ptrs[i]);
+      }
+      delete[] ptrs;
+   }
+   auto rssFreed = os::GetResidentMemorySize();
+   auto statsFreed = mem::GetMemoryStats();
+   mem::PerformHeapCleanup();
+
+   auto rssEnd = os::GetResidentMemorySize();
+   auto stats = mem::GetMemoryStats();
+   auto purgedBytes = stats.purged_bytes - statsFreed.purged_bytes;
+   printf("> after cleanup: rss %s (-%s)\n", mem::sz2a(rssEnd).c_str(), mem::sz2a(rssFreed - rssEnd).c_str());
+   printf("> purged: %s (%zu regions)\n", mem::sz2a(purgedBytes).c_str(), stats.purged_regions - statsFreed.purged_regions);
+
+   // Most of the peak objects bytes were in batched pages, given back by the cleanup
+   _INS_ASSERT(purgedBytes > count * size / 2);
+   _INS_ASSERT(rssEnd + count * size / 2 < rssFreed);
+}
@@ -0,0 +1,70 @@
+#include <ins/memory/malloc.h>
+#include <ins/timing.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "./test_perf_alloc.h"
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+using namespace ins;
+
+/**********************************************************************
+*
+*   Heap startup
+*
+*   Run fresh processes doing one allocation: the heap is initialized
+*   by the first ins_malloc, which shall not wait for the heap worker,
+*   the schema arena or any other unused heap service.
+*
+***********************************************************************/
+
+int test_startup_child() {
+   Chrono chrono;
+   chrono.Start();
+   void* ptr = ins_malloc(64);
+   auto time = chrono.GetDiffFloat(Chrono::US);
+   ins_free(ptr);
+   printf("%g\n", time);
+   return 0;
+}
+
+void test_startup() {
+#if defined(__linux__)
+   char exe[4096];
+   auto len = readlink("/proc/self/exe", exe, sizeof(exe) - 1);
+   if (len <= 0) {
+      printf("> startup benchmark not supported\n");
+      return;
+   }
+   exe[len] = 0;
+   auto command = std::string(exe) + " --first-malloc";
+
+   const int runs = 16;
+   std::vector<float> firsts;
+   std::vector<float> totals;
+   for (int i = 0; i < runs; i++) {
+      Chrono chrono;
+      chrono.Start();
+      float first = -1;
+      auto output = popen(command.c_str(), "r");
+      if (!output || fscanf(output, "%g", &first) != 1) {
+         printf("! startup process failed\n");
+         exit(1);
+      }
+      pclose(output);
+      totals.push_back(chrono.GetDiffFloat(Chrono::US));
+      firsts.push_back(first);
+   }
+   std::sort(firsts.begin(), firsts.end());
+   std::sort(totals.begin(), totals.end());
+   printf("> first ins_malloc: %g us median, %g us min (process run: %g us median)\n",
+      firsts[runs / 2], firsts[0], totals[runs / 2]);
+#else
+   printf("> startup benchmark not supported\n");
+#endif
+}
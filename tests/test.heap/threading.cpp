@@ -4,7 +4,7 @@
 using namespace ins;
 using namespace ins::mem;
 
-__declspec(thread) mem::ThreadStackTracker* mem::ThreadStackTracker::current = 0;
+thread_local mem::ThreadStackTracker* mem::ThreadStackTracker::current = 0;
 
 void mem::ThreadStackTracker::MarkObjects(ObjectAnalysisSession& session) {
    for (auto loc = this->locals; loc; loc = loc->next) {
@@ -15,7 +15,7 @@ namespace ins::mem {
    };
 
    struct ThreadStackTracker : IObjectReferenceTracker {
-      static __declspec(thread) ThreadStackTracker* current;
+      static thread_local ThreadStackTracker* current;
 
       struct Local {
       private:
@@ -1,24 +1,27 @@
 #include "./utils.h"
-#include <windows.h>
+#include <chrono>
+#include <thread>
+
+static int64_t QueryCounter() {
+	return int64_t(std::chrono::steady_clock::now().time_since_epoch().count());
+}
 
 Chrono::Chrono() {
-	QueryPerformanceFrequency((LARGE_INTEGER*)&freq);
+	freq = int64_t(std::chrono::steady_clock::period::den / std::chrono::steady_clock::period::num);
 }
 
 void Chrono::Start() {
-	QueryPerformanceCounter((LARGE_INTEGER*)&t0);
+	t0 = QueryCounter();
 }
 
 double Chrono::GetDiffDouble(PRECISION unit) {
-	__int64 t1;
-	QueryPerformanceCounter((LARGE_INTEGER*)&t1);
+	int64_t t1 = QueryCounter();
 	t1-=t0;
 	return (double)(t1*unit) / (double)freq;
 }
 
 float Chrono::GetDiffFloat(PRECISION unit) {
-	__int64 t1;
-	QueryPerformanceCounter((LARGE_INTEGER*)&t1);
+	int64_t t1 = QueryCounter();
 	t1-=t0;
 	return (float)((double)(t1*unit) / (double)freq);
 }
@@ -28,8 +31,7 @@ float Chrono::GetOpsFloat(uint64_t ncycle, OPS unit) {
 }
 
 uint64_t Chrono::GetNumCycleClock() {
-	__int64 t1;
-	QueryPerformanceCounter((LARGE_INTEGER*)&t1);
+	int64_t t1 = QueryCounter();
 	t1-=t0;
 	return t1;
 }
@@ -40,5 +42,5 @@ uint64_t Chrono::GetFreq() {
 
 
 void wait_ms(size_t ms) {
-	Sleep(ms);
+	std::this_thread::sleep_for(std::chrono::milliseconds(ms));
 }
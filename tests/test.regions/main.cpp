@@ -1,8 +1,18 @@
 #include <ins/memory/map.h>
 #include <ins/memory/file-view.h>
+#include <ins/os/memory.h>
+#include <ins/os/threading.h>
 #include <stdio.h>
+#include <string.h>
 #include <vector>
+#include <thread>
+#include <atomic>
 #include <unordered_map>
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include "./utils.h"
 
 using namespace ins;
 using namespace ins::mem;
@@ -34,6 +44,68 @@ namespace DescriptorsTests {
          delete desc;
       }
    }
+   void test_descriptor_arenas() {
+      struct TestHugeDesc : Descriptor {
+      };
+
+      // Exhaust the first descriptor arena, next descriptors are placed in a new arena
+      const size_t size = (size_t(1) << (cst::ArenaSizeL2 - 1)) - 64;
+      auto desc1 = Descriptor::NewExtensible<TestHugeDesc>(size);
+      auto desc2 = Descriptor::NewExtensible<TestHugeDesc>(size);
+      auto desc3 = Descriptor::NewExtensible<TestHugeDesc>(size);
+      _INS_ASSERT(address_t(desc1).arenaID != address_t(desc3).arenaID);
+      _INS_ASSERT(desc3->GetEntry() && desc3->GetSize() >= size);
+      printf("descriptors arenas: %d, %d, %d\n", int(address_t(desc1).arenaID), int(address_t(desc2).arenaID), int(address_t(desc3).arenaID));
+      delete desc1;
+      delete desc2;
+      delete desc3;
+   }
+   void test_perf_threads(int numThread) {
+      const int cycles = 200;
+      const int holds = 256;
+      struct TestDesc64 : Descriptor { char bytes[64 - 8]; };
+      struct TestDesc128 : Descriptor { char bytes[128 - 8]; };
+      struct TestDesc256 : Descriptor { char bytes[256 - 8]; };
+      struct TestDescContext : Descriptor { char bytes[8192]; }; // Memory context size class
+
+      // Short lived threads, as a thread pool churn creating its contexts
+      Chrono chrono;
+      chrono.Start();
+      std::vector<std::thread> threads;
+      for (int t = 0; t < numThread; t++) {
+         threads.push_back(std::thread(
+            [=]() {
+               for (int c = 0; c < cycles; c++) {
+                  std::thread worker([=]() {
+                     delete Descriptor::New<TestDescContext>();
+                     Descriptor* descs[holds];
+                     for (int i = 0; i < holds; i += 4) {
+                        descs[i] = Descriptor::New<TestDesc64>();
+                        descs[i + 1] = Descriptor::New<TestDesc128>();
+                        descs[i + 2] = Descriptor::New<TestDesc256>();
+                        descs[i + 3] = Descriptor::New<TestDesc64>();
+                     }
+                     for (int i = 0; i < holds; i++) {
+                        delete descs[i];
+                     }
+                  });
+                  worker.join();
+               }
+            }
+         ));
+      }
+      for (auto& thread : threads) thread.join();
+      auto ops = uint64_t(numThread) * cycles * (holds + 1) * 2;
+      printf("descriptors x %d threads: %g Mops/s (%s used)\n", numThread, chrono.GetOpsFloat(ops, Chrono::Mops), sz2a(mem::GetMemoryStats().descriptors_used_bytes).c_str());
+   }
+   void test_perf_threads() {
+      int maxThread = std::thread::hardware_concurrency();
+      if (maxThread < 4) maxThread = 4;
+      if (maxThread > 64) maxThread = 64;
+      for (int numThread = 1; numThread <= maxThread; numThread *= 4) {
+         test_perf_threads(numThread);
+      }
+   }
 }
 
 namespace FileViewTests {
@@ -44,13 +116,117 @@ namespace FileViewTests {
       auto bytes = fv->GetBase().as<char>();
       for (size_t s = 16; s <= fsize; s += 4096) {
          bool r = fv->ExtendSize(s);
-         for (size_t i = 16; i < s - 4; i += 4096 * (rand() % 32)) {
+         for (size_t i = 16; i < s - 4; i += 4096 * (1 + rand() % 32)) {
             ((int*)&bytes[i])[0] = rand();
          }
-         _ASSERT(r);
+         _INS_ASSERT(r);
       }
+      _INS_ASSERT(fv->GetBase().as<char>() == bytes);
+      _INS_ASSERT(mem::GetRegionDescriptor(&bytes[fsize / 2]) == fv);
       mem::PrintMemoryInfos();
       delete fv;
+      remove("./ee.tmp");
+   }
+   void test_direct_buffers() {
+      const size_t fsize = size_t(6) << 30; // over an arena, to check views spanning arenas
+      const size_t step = 64 << 20;
+
+      // Write file by growing windows
+      auto fv = mem::DirectFileView::NewReadWrite("./ee.tmp", fsize, true);
+      auto base = fv->GetBase();
+      for (size_t offset = 0; offset < fsize; offset += step) {
+         auto buf = fv->MapBuffer(offset, 4096);
+         _INS_ASSERT(buf && fv->GetBase().ptr == base.ptr);
+         buf.as<uint64_t>()[0] = offset;
+      }
+      _INS_ASSERT(fv->GetSize() >= fsize - step);
+      _INS_ASSERT(mem::GetRegionDescriptor(base + (fsize - step)) == fv);
+      delete fv;
+
+      // Read file through zero copy windows
+      fv = mem::DirectFileView::NewReadOnly("./ee.tmp");
+      _INS_ASSERT(fv);
+      Chrono chrono;
+      chrono.Start();
+      for (size_t offset = 0; offset < fv->GetSize(); offset += step) {
+         auto buf = fv->MapBuffer(offset, 4096);
+         _INS_ASSERT(buf && buf.as<uint64_t>()[0] == offset);
+      }
+      printf("file view: %s mapped, %d windows read in %g ms\n", sz2a(fv->GetSize()).c_str(), int(fv->GetSize() / step), chrono.GetDiffFloat(Chrono::MS));
+      _INS_ASSERT(!fv->MapBuffer(fv->GetSize(), 4096));
+      delete fv;
+      remove("./ee.tmp");
+   }
+   void test_perf_windows() {
+      const size_t fsize = size_t(1) << 30;
+      const size_t bsize = 4096;
+      const size_t randomReads = 200000;
+
+      // Write file, each block starts with its offset
+      {
+         std::vector<uint64_t> chunk((1 << 20) / sizeof(uint64_t));
+         FILE* f = fopen("./ee.tmp", "wb");
+         for (size_t offset = 0; offset < fsize; offset += chunk.size() * sizeof(uint64_t)) {
+            for (size_t i = 0; i < chunk.size(); i++) chunk[i] = offset + i * sizeof(uint64_t);
+            fwrite(chunk.data(), sizeof(uint64_t), chunk.size(), f);
+         }
+         fclose(f);
+      }
+      auto checkBlock = [](const uint64_t* words, size_t offset) {
+         uint64_t sum = 0;
+         for (size_t i = 0; i < bsize / sizeof(uint64_t); i++) sum += words[i];
+         _INS_ASSERT(words[0] == offset);
+         return sum;
+      };
+      std::vector<size_t> randoms(randomReads);
+      for (auto& offset : randoms) offset = (size_t(rand()) * RAND_MAX + rand()) % (fsize / bsize) * bsize;
+
+      // Read with windows: 64Mo windows, 4 resident windows (a quarter of the file)
+      auto fv = mem::WindowedFileView::NewReadOnly("./ee.tmp", 26, 4);
+      _INS_ASSERT(fv && fv->GetSize() == fsize);
+      uint64_t sum = 0;
+      Chrono chrono;
+      chrono.Start();
+      for (size_t offset = 0; offset < fsize; offset += bsize) {
+         auto buf = fv->MapBuffer(offset, bsize);
+         sum += checkBlock(buf.as<uint64_t>(), offset);
+      }
+      auto seqWindows = chrono.GetDiffFloat(Chrono::S);
+      _INS_ASSERT(fv->GetMappedWindowsCount() <= 4);
+      double rndWindows[2];
+      for (int pass = 0; pass < 2; pass++) {
+         if (pass == 1) fv->SetResidentWindows(fsize / fv->GetWindowSize()); // whole file resident
+         chrono.Start();
+         for (auto offset : randoms) {
+            auto buf = fv->MapBuffer(offset, bsize);
+            sum += checkBlock(buf.as<uint64_t>(), offset);
+         }
+         rndWindows[pass] = chrono.GetDiffFloat(Chrono::S);
+      }
+      delete fv;
+      printf("file windows: sequential %g Go/s, random %g Mops/s (%g Mops/s when resident)\n",
+         fsize / seqWindows * 1e-9, randomReads / rndWindows[0] * 1e-6, randomReads / rndWindows[1] * 1e-6);
+
+#if !defined(_WIN32)
+      // Read with pread
+      auto fd = open("./ee.tmp", O_RDONLY);
+      std::vector<uint64_t> block(bsize / sizeof(uint64_t));
+      chrono.Start();
+      for (size_t offset = 0; offset < fsize; offset += bsize) {
+         _INS_ASSERT(pread(fd, block.data(), bsize, offset) == bsize);
+         sum += checkBlock(block.data(), offset);
+      }
+      auto seqPread = chrono.GetDiffFloat(Chrono::S);
+      chrono.Start();
+      for (auto offset : randoms) {
+         _INS_ASSERT(pread(fd, block.data(), bsize, offset) == bsize);
+         sum += checkBlock(block.data(), offset);
+      }
+      auto rndPread = chrono.GetDiffFloat(Chrono::S);
+      close(fd);
+      printf("file pread: sequential %g Go/s, random %g Mops/s (checksum %llx)\n", fsize / seqPread * 1e-9, randomReads / rndPread * 1e-6, (unsigned long long)sum);
+#endif
+      remove("./ee.tmp");
    }
 }
 
@@ -61,18 +237,323 @@ namespace RegionsTests {
    }
    void test_defrag() {
    }
+   bool can_obtain_huge_page() {
+      // Probe the system with a single huge page: from the hugetlb pool, else transparent
+      auto hugeSize = os::GetHugePageSize();
+      if (!hugeSize) return false;
+      auto base = os::ReserveMemory(0, 0, hugeSize, hugeSize);
+      if (!base) return false;
+      bool obtained = os::CommitHugeMemory(base, hugeSize);
+      if (!obtained) {
+         os::AdviseHugeMemory(base, hugeSize);
+         os::CommitMemory(base, hugeSize);
+         memset((void*)base, 1, hugeSize);
+         os::EnumerateHugeMemoryZone(
+            [&](uintptr_t address, uintptr_t size, uintptr_t hugeBytes) {
+               if (base >= address && base < address + size) obtained = true;
+            }
+         );
+      }
+      os::ReleaseMemory(base, hugeSize);
+      return obtained;
+   }
+   void test_huge_pages() {
+      bool obtainable = can_obtain_huge_page();
+      mem::SetHugePagesOption(mem::HugePagesMode::Explicit);
+
+      // Large regions (huge arena) and batched small regions (huge batch)
+      auto large = mem::AllocateUnmanagedRegion(22, 0, 0);
+      memset(large, 1, size_t(1) << 22);
+      std::vector<address_t> smalls;
+      for (int i = 0; i < 2048; i++) {
+         auto ptr = mem::AllocateUnmanagedRegion(10, 0, 0);
+         memset(ptr, 1, size_t(1) << 10);
+         smalls.push_back(ptr);
+      }
+
+      auto stats = mem::GetMemoryStats();
+      printf("huge pages: %zu x %s (%s)\n", stats.huge_pages_count, sz2a(stats.huge_page_size).c_str(), obtainable ? "obtainable" : "fallback");
+      if (obtainable) {
+         // Large region spans whole huge pages, it shall get at least one
+         _INS_ASSERT(mem::GetHugePagesOption() == mem::HugePagesMode::Explicit);
+         _INS_ASSERT(stats.huge_pages_count > 0);
+      }
+      else {
+         // Fallback to standard pages: regions are allocated and written above, without huge page
+         _INS_ASSERT(stats.huge_pages_count == 0);
+         if (!stats.huge_page_size) _INS_ASSERT(mem::GetHugePagesOption() == mem::HugePagesMode::Disabled);
+      }
+
+      mem::DisposeRegion(large, 22, 0);
+      for (auto ptr : smalls) mem::DisposeRegion(ptr, 10, 0);
+      mem::SetHugePagesOption(mem::HugePagesMode::Disabled);
+   }
+   void test_cache_purge() {
+      std::vector<address_t> ptrs;
+      for (int i = 0; i < 256; i++) {
+         auto ptr = mem::AllocateUnmanagedRegion(16, 0, 0);
+         memset(ptr, 1, size_t(1) << 16);
+         ptrs.push_back(ptr);
+      }
+      for (auto ptr : ptrs) mem::DisposeRegion(ptr, 16, 0);
+
+      // Idle cache decays by half each half-life period
+      auto initialStats = mem::GetMemoryStats();
+      auto usedBytes = mem::GetUsedPhysicalBytes();
+      mem::SetCachePurgeOptions(100, 100);
+      mem::PurgeCachedRegions(100);
+
+      // First pass purges the regions cached before it, coldest first
+      _INS_ASSERT(mem::GetUsedPhysicalBytes() < usedBytes);
+      _INS_ASSERT(RegionLocation::New(ptrs.front()).layout() == RegionLayoutID::FreeRegion);
+      _INS_ASSERT(RegionLocation::New(ptrs.back()).layout() == RegionLayoutID::FreeCachedRegion);
+      usedBytes = mem::GetUsedPhysicalBytes();
+      for (int i = 0; i < 4; i++) {
+         mem::PurgeCachedRegions(100);
+         printf("cache purge: used %s\n", sz2a(mem::GetUsedPhysicalBytes()).c_str());
+         _INS_ASSERT(mem::GetUsedPhysicalBytes() < usedBytes);
+         usedBytes = mem::GetUsedPhysicalBytes();
+      }
+      auto stats = mem::GetMemoryStats();
+      printf("cache purge: purged %s (%zu regions)\n", sz2a(stats.purged_bytes).c_str(), stats.purged_regions);
+      _INS_ASSERT(stats.purged_bytes > initialStats.purged_bytes);
+      _INS_ASSERT(stats.purged_regions > initialStats.purged_regions);
+      mem::SetCachePurgeOptions(0, 0);
+   }
+   void test_perf_threads(uint8_t sizeL2, int numThread) {
+      const int cycles = 2000;
+      const int holds = 64;
+      Chrono chrono;
+      chrono.Start();
+      std::vector<std::thread> threads;
+      for (int t = 0; t < numThread; t++) {
+         threads.push_back(std::thread(
+            [=]() {
+               address_t ptrs[holds];
+               for (int c = 0; c < cycles; c++) {
+                  for (int i = 0; i < holds; i++) {
+                     ptrs[i] = mem::AllocateUnmanagedRegion(sizeL2, 0, 0);
+                     ptrs[i].as<int>()[0] = i;
+                  }
+                  for (int i = 0; i < holds; i++) {
+                     _INS_ASSERT(ptrs[i].as<int>()[0] == i); // Region not given to another thread
+                     mem::DisposeRegion(ptrs[i], sizeL2, 0);
+                  }
+               }
+            }
+         ));
+      }
+      for (auto& thread : threads) thread.join();
+      auto ops = uint64_t(numThread) * cycles * holds * 2;
+      printf("regions %s x %d threads: %g Mops/s\n", sz2a(size_t(1) << sizeL2).c_str(), numThread, chrono.GetOpsFloat(ops, Chrono::Mops));
+   }
+   void test_perf_threads() {
+      int maxThread = std::thread::hardware_concurrency();
+      if (maxThread < 4) maxThread = 4;
+      if (maxThread > 64) maxThread = 64;
+      for (int numThread = 1; numThread <= maxThread; numThread *= 4) {
+         test_perf_threads(12, numThread); // batched regions
+         test_perf_threads(16, numThread); // page regions
+      }
+   }
+   void test_physical_budget(int numThread) {
+      const int cycles = 1000000;
+      Chrono chrono;
+      chrono.Start();
+      std::vector<std::thread> threads;
+      for (int t = 0; t < numThread; t++) {
+         threads.push_back(std::thread(
+            [=]() {
+               for (int c = 0; c < cycles; c++) {
+                  mem::RequirePhysicalBytes(cst::PageSize, 0);
+                  mem::ReleasePhysicalBytes(cst::PageSize);
+               }
+            }
+         ));
+      }
+      for (auto& thread : threads) thread.join();
+      auto ops = uint64_t(numThread) * cycles * 2;
+      printf("physical budget x %d threads: %g Mops/s\n", numThread, chrono.GetOpsFloat(ops, Chrono::Mops));
+   }
+   void test_physical_budget() {
+      auto maxBytes = mem::GetMaxUsablePhysicalBytes();
+      auto baseBytes = mem::GetUsedPhysicalBytes();
+
+      // Limit is reached exactly, leased bytes are reclaimed on need
+      mem::SetPhysicalBytesReconciliation(false);
+      mem::SetMaxUsablePhysicalBytes(baseBytes + (size_t(64) << 20));
+      size_t count = 0;
+      while (mem::RequirePhysicalBytes(cst::PageSize, 0)) count++;
+      printf("physical budget: %zu pages required, used %s (slack %s)\n", count, sz2a(mem::GetUsedPhysicalBytes() - baseBytes).c_str(), sz2a(mem::GetPhysicalBytesSlack()).c_str());
+      _INS_ASSERT(mem::GetUsedPhysicalBytes() == baseBytes + (size_t(64) << 20));
+      for (size_t i = 0; i < count; i++) mem::ReleasePhysicalBytes(cst::PageSize);
+      _INS_ASSERT(mem::GetUsedPhysicalBytes() == baseBytes);
+      mem::SetMaxUsablePhysicalBytes(maxBytes);
+      mem::SetPhysicalBytesReconciliation(true);
+
+      int maxThread = std::thread::hardware_concurrency();
+      if (maxThread < 4) maxThread = 4;
+      if (maxThread > 64) maxThread = 64;
+      for (int numThread = 1; numThread <= maxThread; numThread *= 4) {
+         test_physical_budget(numThread);
+      }
+   }
+   void test_memory_limit() {
+      auto stats = mem::GetMemoryStats();
+      printf("memory limit: %s, resident %s\n", sz2a(mem::GetMaxUsablePhysicalBytes()).c_str(), sz2a(stats.resident_bytes).c_str());
+
+      // Untouched committed regions count against the limit, but not for the purge trigger
+      auto maxBytes = mem::GetMaxUsablePhysicalBytes();
+      auto limitBytes = mem::GetUsedPhysicalBytes() + (size_t(64) << 20);
+      mem::SetMaxUsablePhysicalBytes(limitBytes);
+      std::vector<address_t> ptrs;
+      try {
+         for (int i = 0; i < 256; i++) {
+            ptrs.push_back(mem::AllocateUnmanagedRegion(20, 0, 0));
+         }
+      }
+      catch (mem::exception_missing_memory&) {
+      }
+      mem::ReconcilePhysicalBytes();
+      stats = mem::GetMemoryStats();
+      printf("memory limit: %zu untouched regions of 1Mo committed (untouched %s)\n", ptrs.size(), sz2a(stats.untouched_bytes).c_str());
+      _INS_ASSERT(ptrs.size() <= 64 && mem::GetUsedPhysicalBytes() <= limitBytes);
+      _INS_ASSERT(!mem::IsPhysicalBytesSoftLimitReached() || stats.resident_bytes > limitBytes - (limitBytes >> 3));
+
+      // Without reconciliation, the purge trigger applies on committed bytes
+      mem::SetPhysicalBytesReconciliation(false);
+      _INS_ASSERT(mem::IsPhysicalBytesSoftLimitReached());
+      mem::SetPhysicalBytesReconciliation(true);
+      for (auto ptr : ptrs) mem::ReleaseRegion(ptr, 20, 0);
+      mem::SetMaxUsablePhysicalBytes(maxBytes);
+      mem::ReconcilePhysicalBytes();
+   }
+   void test_perf_foreach() {
+      const int cycles = 1000;
+      size_t arenaCount = 0;
+      std::unordered_map<uintptr_t, size_t> reserveds;
+      for (size_t targetCount = 1; targetCount <= 256; targetCount *= 4) {
+
+         // One reserved region per arena, no physical memory used
+         for (; arenaCount < targetCount; arenaCount++) {
+            reserveds[mem::ReserveUnmanagedRegion(cst::ArenaSizeL2).ptr] = 0;
+         }
+
+         // Each reserved region is visited once
+         mem::ForeachRegion(
+            [&](ArenaDescriptor* arena, RegionLayoutID layout, address_t addr) {
+               auto it = reserveds.find(addr.ptr);
+               if (it != reserveds.end()) it->second++;
+               return true;
+            }
+         );
+         for (auto& it : reserveds) {
+            _INS_ASSERT(it.second == 1);
+            it.second = 0;
+         }
+
+         size_t visiteds = 0;
+         Chrono chrono;
+         chrono.Start();
+         for (int c = 0; c < cycles; c++) {
+            mem::ForeachRegion(
+               [&](ArenaDescriptor* arena, RegionLayoutID layout, address_t addr) {
+                  visiteds++;
+                  return true;
+               }
+            );
+         }
+         printf("foreach regions with %zu added arenas: %g us/cycle (%zu regions)\n",
+            arenaCount, chrono.GetDiffFloat(Chrono::US) / cycles, visiteds / cycles);
+         _INS_ASSERT(visiteds % cycles == 0 && visiteds / cycles >= arenaCount);
+      }
+
+      // Give back the reserved regions, their arenas serve the next tests
+      for (auto& it : reserveds) {
+         mem::ReleaseReservedRegion(address_t(it.first), cst::ArenaSizeL2);
+      }
+      mem::ForeachRegion(
+         [&](ArenaDescriptor* arena, RegionLayoutID layout, address_t addr) {
+            _INS_ASSERT(reserveds.find(addr.ptr) == reserveds.end());
+            return true;
+         }
+      );
+   }
+   void test_arena_map() {
+      // Only the leaves of the used arenas are committed
+      auto region = mem::ReserveUnmanagedRegion(cst::ArenaSizeL2);
+      auto stats = mem::GetMemoryStats();
+      printf("arena map: %s used for a %d bits space\n", sz2a(stats.arenas_map_used_bytes).c_str(), int(cst::SpaceSizeL2));
+      _INS_ASSERT(stats.arenas_map_used_bytes < sizeof(ArenaEntry) * cst::ArenaPerSpace);
+      _INS_ASSERT(mem::GetRegionSize(region) == cst::ArenaSize);
+      _INS_ASSERT(mem::GetRegionDescriptor(region) == region.as<Descriptor>());
+
+      // Arenas out of the process space are resolved as unused
+      _INS_ASSERT(mem::ArenaMap[uint32_t(cst::ArenaPerSpace - 1)].descriptor() == &ArenaDescriptor::UnusedArena);
+   }
+}
+
+namespace ThreadsTests {
+   void test_concurrent_suspend() {
+      const int count = 4;
+      const int cycles = 5000;
+
+      // Each suspender parks and releases its own target, concurrently with the others
+      std::atomic_bool stop = false;
+      std::atomic_int ready = 0;
+      std::vector<os::Thread> handles(count);
+      std::vector<std::thread> targets;
+      for (int i = 0; i < count; i++) {
+         targets.push_back(std::thread(
+            [&, i]() {
+               handles[i] = os::Thread::current();
+               ready++;
+               while (!stop) std::this_thread::yield();
+            }
+         ));
+      }
+      while (ready < count) std::this_thread::yield();
+      std::vector<std::thread> suspenders;
+      for (int i = 0; i < count; i++) {
+         suspenders.push_back(std::thread(
+            [&, i]() {
+               for (int c = 0; c < cycles; c++) {
+                  handles[i].Suspend();
+                  handles[i].Resume();
+               }
+            }
+         ));
+      }
+      for (auto& thread : suspenders) thread.join();
+      stop = true;
+      for (auto& thread : targets) thread.join();
+      printf("concurrent suspend: %d x %d cycles\n", count, cycles);
+   }
 }
 
 int main() {
    mem::InitializeMemory();
 
+   ThreadsTests::test_concurrent_suspend();
+
    DescriptorsTests::test_descriptor_region();
    DescriptorsTests::test_descriptor_region();
+   DescriptorsTests::test_perf_threads();
+   DescriptorsTests::test_descriptor_arenas();
 
    RegionsTests::test_basic();
+   RegionsTests::test_huge_pages();
+   RegionsTests::test_cache_purge();
+   RegionsTests::test_perf_threads();
+   RegionsTests::test_physical_budget();
+   RegionsTests::test_memory_limit();
+   RegionsTests::test_perf_foreach();
+   RegionsTests::test_arena_map();
    //RegionsTests::test_defrag();
 
-   //FileViewTests::test_direct_1();
+   FileViewTests::test_direct_1();
+   FileViewTests::test_direct_buffers();
+   FileViewTests::test_perf_windows();
 
    return 0;
 }
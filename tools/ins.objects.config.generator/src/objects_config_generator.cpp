@@ -11,6 +11,8 @@
 using namespace ins;
 using namespace ins::mem;
 
+typedef int (*tQSortCompare)(const void*, const void*);
+
 constexpr auto BlockDividerShift = tObjectLayoutBase::DividerShift;
 
 struct tRegionClass {
@@ -226,10 +228,10 @@ struct tObjectClass {
          this->retention.list_length, this->retention.heap_count, this->retention.context_count
       );
    }
-   static int __cdecl compare_object_size(tObjectClass* x, tObjectClass* y) {
+   static int compare_object_size(tObjectClass* x, tObjectClass* y) {
       return x->object_size - y->object_size;
    }
-   static int __cdecl compare_layout_order(tObjectClass*& x, tObjectClass*& y) {
+   static int compare_layout_order(tObjectClass*& x, tObjectClass*& y) {
       if (auto c = int(x->layoutPolicy) - int(y->layoutPolicy)) return c;
       return x->object_size - y->object_size;
    }
@@ -288,7 +290,7 @@ std::vector<tObjectClass> computeObjectPotentialClasses(double gap_growth, size_
          }
          prev = cur_cls;
       }
-      std::qsort(&classes[0], classes.size(), sizeof(tObjectClass), (_CoreCrtNonSecureSearchSortCompareFunction)tObjectClass::compare_object_size);
+      std::qsort(&classes[0], classes.size(), sizeof(tObjectClass), (tQSortCompare)tObjectClass::compare_object_size);
    }
    classes[0].object_size = 0;
    return classes;
@@ -363,7 +365,7 @@ void generate_objects_config(std::string src_path) {
    for (size_t i = 0; i < classes.size(); i++) {
       layouts.push_back(&classes[i]);
    }
-   std::qsort(&layouts[0], layouts.size(), sizeof(tObjectClass*), (_CoreCrtNonSecureSearchSortCompareFunction)tObjectClass::compare_layout_order);
+   std::qsort(&layouts[0], layouts.size(), sizeof(tObjectClass*), (tQSortCompare)tObjectClass::compare_layout_order);
    for (size_t i = 0; i < layouts.size(); i++) {
       layouts[i]->layoutID = i;
    }
@@ -388,8 +390,8 @@ void generate_objects_config(std::string src_path) {
       auto& cls = classes[clsIndex];
       const size_t size_step = SmallSizeLimit / LayoutRangeSizeCount;
       size_t end_index = std::min(cls.object_size / size_step, LayoutRangeSizeCount);
-      for (size_t i = end_index; i >= 0 && small_object_layouts[i] == 0; i--) {
-         small_object_layouts[i] = cls.layoutID;
+      for (size_t i = end_index + 1; i > 0 && small_object_layouts[i - 1] == 0; i--) {
+         small_object_layouts[i - 1] = cls.layoutID;
       }
       if (cls.object_size >= SmallSizeLimit) {
          _ASSERT(end_index == LayoutRangeSizeCount);
@@ -534,30 +536,74 @@ void generate_objects_config(std::string src_path) {
       out << "   const size_t LargeSizeLimit = MediumSizeLimit << 4;\n";
       out << "\n";
       out << "   struct tLayoutRangeBin {uint8_t layoutMin = 0, layoutMax = 0;};\n";
-      out << "   extern const uint8_t small_object_layouts[LayoutRangeSizeCount + 1];\n";
-      out << "   extern const tLayoutRangeBin medium_object_layouts[LayoutRangeSizeCount];\n";
-      out << "   extern const tLayoutRangeBin large_object_layouts[LayoutRangeSizeCount];\n";
+      out << "\n";
+
+      out << "   inline constexpr uint8_t small_object_layouts[LayoutRangeSizeCount + 1] = {";
+      for (size_t i = 0; i <= LayoutRangeSizeCount; i++) {
+         if ((i % 32) == 0) out << "\n   ";
+         out << int(small_object_layouts[i]) << ", ";
+      }
+      out << "\n   };\n\n";
+
+      out << "   inline constexpr tLayoutRangeBin medium_object_layouts[LayoutRangeSizeCount] = {";
+      for (size_t i = 0; i < LayoutRangeSizeCount; i++) {
+         if ((i % 16) == 0) out << "\n   ";
+         out << "{" << int(medium_object_layouts[i].layoutMin);
+         out << "," << int(medium_object_layouts[i].layoutMax) << "}, ";
+      }
+      out << "\n   };\n\n";
+
+      out << "   inline constexpr tLayoutRangeBin large_object_layouts[LayoutRangeSizeCount] = {";
+      for (size_t i = 0; i < LayoutRangeSizeCount; i++) {
+         if ((i % 16) == 0) out << "\n   ";
+         out << "{" << int(large_object_layouts[i].layoutMin);
+         out << "," << int(large_object_layouts[i].layoutMax) << "}, ";
+      }
+      out << "\n   };\n";
       out << "}\n";
       out.close();
    }
    {
-      std::ofstream out(src_path + "/ins.memory.heap/src/memory/config.cpp");
-      out << "#include <ins/memory/contexts.h>\n";
-      out << "#include <ins/memory/map.h>\n";
-      out << "\n";
-      out << "using namespace ins;\n";
+      // Layouts constants, included by objects-base.h after the layout structs (constexpr for compile time size classes)
+      std::ofstream out(src_path + "/ins.memory.heap/include/ins/memory/config-layouts.h");
+      out << "#pragma once\n";
+      out << "namespace ins::mem::cst {\n";
       out << "\n";
-      char tmp[128];
 
-      out << "const mem::tObjectLayoutBase mem::cst::ObjectLayoutBase[mem::cst::ObjectLayoutCount] = {\n";
+      out << "   inline constexpr tObjectLayoutBase ObjectLayoutBase[ObjectLayoutCount] = {\n";
       for (int i = 0; i < layouts.size(); i++) {
          auto& cls = *layouts[i];
-         out << "{";
+         out << "   {";
          out << "/*object_divider*/" << cls.object_divider << ", ";
          out << "/*object_multiplier*/" << cls.object_multiplier << ", ";
          out << "},\n";
       }
-      out << "};\n\n";
+      out << "   };\n\n";
+
+      out << "   inline constexpr tObjectLayoutInfos ObjectLayoutInfos[ObjectLayoutCount] = {\n";
+      for (int i = 0; i < layouts.size(); i++) {
+         auto& cls = *layouts[i];
+         out << "   {";
+         out << "/*region_objects*/" << cls.object_count << ", ";
+         out << "/*region_templateID*/" << cls.region->region_templateID << ", ";
+         out << "/*region_sizeL2*/" << cls.region->region_sizeL2 << ", ";
+         out << "/*region_sizing*/" << cls.region->region_sizing << ", ";
+         out << "/*policy*/" << cls.getLayoutPolicyName() << ", ";
+         out << "/*retention*/{" << cls.retention.list_length << "," << cls.retention.heap_count << "," << cls.retention.context_count << "}, ";
+         out << "},\n";
+      }
+      out << "   };\n";
+      out << "}\n";
+      out.close();
+   }
+   {
+      std::ofstream out(src_path + "/ins.memory.heap/src/memory/config.cpp");
+      out << "#include <ins/memory/contexts.h>\n";
+      out << "#include <ins/memory/map.h>\n";
+      out << "\n";
+      out << "using namespace ins;\n";
+      out << "\n";
+      char tmp[128];
 
       out << "const uint64_t mem::cst::ObjectLayoutMask[mem::cst::ObjectLayoutCount] = {\n";
       for (int i = 0; i < layouts.size(); i++) {
@@ -577,43 +623,6 @@ void generate_objects_config(std::string src_path) {
          out << "},\n";
       }
       out << "};\n\n";
-
-      out << "const mem::tObjectLayoutInfos mem::cst::ObjectLayoutInfos[mem::cst::ObjectLayoutCount] = {\n";
-      for (int i = 0; i < layouts.size(); i++) {
-         auto& cls = *layouts[i];
-         out << "{";
-         out << "/*region_objects*/" << cls.object_count << ", ";
-         out << "/*region_templateID*/" << cls.region->region_templateID << ", ";
-         out << "/*region_sizeL2*/" << cls.region->region_sizeL2 << ", ";
-         out << "/*region_sizing*/" << cls.region->region_sizing << ", ";
-         out << "/*policy*/" << cls.getLayoutPolicyName() << ", ";
-         out << "/*retention*/{" << cls.retention.list_length << "," << cls.retention.heap_count << "," << cls.retention.context_count << "}, ";
-         out << "},\n";
-      }
-      out << "};\n\n";
-
-      out << "const uint8_t mem::cst::small_object_layouts[mem::cst::LayoutRangeSizeCount+1] = {";
-      for (size_t i = 0; i <= LayoutRangeSizeCount; i++) {
-         if ((i % 32) == 0) out << "\n";
-         out << itoa(small_object_layouts[i], tmp, 10) << ", ";
-      }
-      out << "\n};\n\n";
-
-      out << "const mem::cst::tLayoutRangeBin mem::cst::medium_object_layouts[mem::cst::LayoutRangeSizeCount] = {";
-      for (size_t i = 0; i < LayoutRangeSizeCount; i++) {
-         if ((i % 16) == 0) out << "\n";
-         out << "{" << itoa(medium_object_layouts[i].layoutMin, tmp, 10);
-         out << "," << itoa(medium_object_layouts[i].layoutMax, tmp, 10) << "}, ";
-      }
-      out << "\n};\n\n";
-
-      out << "const mem::cst::tLayoutRangeBin mem::cst::large_object_layouts[mem::cst::LayoutRangeSizeCount] = {";
-      for (size_t i = 0; i < LayoutRangeSizeCount; i++) {
-         if ((i % 16) == 0) out << "\n";
-         out << "{" << itoa(large_object_layouts[i].layoutMin, tmp, 10);
-         out << "," << itoa(large_object_layouts[i].layoutMax, tmp, 10) << "}, ";
-      }
-      out << "\n};\n\n";
    }
    {
       std::ofstream out(src_path + "/ins.memory.space/src/memory/config.cpp");
@@ -647,7 +656,8 @@ void generate_objects_config(std::string src_path) {
       for (int szL2 = 0; szL2 < regionManifold.regions.size(); szL2++) {
          auto& cls = *regionManifold.regions[szL2];
          if ((szL2 % 12) == 0) out << "\n";
-         out << "0x" << itoa(cls.region_mask, tmp, 16) << ", ";
+         sprintf(tmp, "0x%x", cls.region_mask);
+         out << tmp << ", ";
       }
       out << "\n};\n\n";
 
@@ -655,6 +665,6 @@ void generate_objects_config(std::string src_path) {
    }
 }
 
-int main() {
-   generate_objects_config("C:/git/project/insmalloc/lib");
+int main(int argc, char** argv) {
+   generate_objects_config(argc > 1 ? argv[1] : "C:/git/project/insmalloc/lib");
 }